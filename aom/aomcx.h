@@ -1577,6 +1577,39 @@ enum aome_enc_control_id {
    */
   AV1E_SET_MAX_CONSEC_FRAME_DROP_MS_CBR = 169,
 
+  /*!\brief Codec control to lend the source images to the encoder instead of
+   * having them copied, aom_source_lending_t* parameter.
+   *
+   * When aom_source_lending_t::release_cb is not NULL, the encoder uses the
+   * planes of the images passed to aom_codec_encode() directly whenever their
+   * layout allows it, extending their borders in place. The application must
+   * neither modify nor free an image, including its aom_image_t descriptor,
+   * until release_cb has been called for it. release_cb is called exactly
+   * once for each image passed to aom_codec_encode() while lending is
+   * enabled, at the latest when the encoder is destroyed. Images that cannot
+   * be used in place are copied and released right away.
+   *
+   * On return, aom_source_lending_t::border holds the border of the internal
+   * source buffers for the current configuration. Images allocated with
+   * aom_img_alloc_with_border(img, fmt, w, h, 32, 8, border) using that
+   * border share the layout of these buffers and are used in place. The
+   * control should therefore be set once the encoder is fully configured.
+   * Passing NULL, or a NULL release_cb, disables lending.
+   */
+  AV1E_SET_SOURCE_LENDING = 170,
+
+  /*!\brief Codec control to get the time spent in the main stages of the
+   * encoder during the last call to aom_codec_encode(),
+   * aom_enc_stage_timings_t* parameter.
+   *
+   * The times are wall-clock times in microseconds, summed over all the frames
+   * coded during the call, including frames that are not shown. A stage that
+   * runs on several threads is timed on the thread that drives it. When
+   * frames are coded in parallel (see AV1E_SET_FP_MT), the sums may exceed the
+   * duration of the call.
+   */
+  AV1E_GET_FRAME_STAGE_TIMINGS = 171,
+
   // Any new encoder control IDs should be added above.
   // Maximum allowed encoder control ID is 229.
   // No encoder control ID should be added below.
@@ -1776,6 +1809,36 @@ typedef struct aom_svc_ref_frame_comp_pred {
   int use_comp_pred[3]; /**<Compound reference flag. */
 } aom_svc_ref_frame_comp_pred_t;
 
+/*!\brief Callback releasing an image lent to the encoder
+ *
+ * \param[in] cb_priv  aom_source_lending_t::cb_priv
+ * \param[in] img      The image passed to aom_codec_encode()
+ */
+typedef void (*aom_release_source_cb_fn_t)(void *cb_priv,
+                                           const aom_image_t *img);
+
+/*!brief Parameters for lending source images to the encoder */
+typedef struct aom_source_lending {
+  /*! Called once the encoder no longer references an image. */
+  aom_release_source_cb_fn_t release_cb;
+  void *cb_priv;       /**< Private data passed to release_cb. */
+  unsigned int border; /**< Output: border to allocate images with. */
+} aom_source_lending_t;
+
+/*!brief Time spent in the main stages of the encoder, in microseconds */
+typedef struct aom_enc_stage_timings {
+  int64_t temporal_filter;        /**< Temporal filtering of source frames. */
+  int64_t tpl;                    /**< Temporal dependency model. */
+  int64_t encode_frame;           /**< Mode decision and reconstruction. */
+  int64_t loop_filter_pick;       /**< Deblocking filter level search. */
+  int64_t loop_filter_apply;      /**< Deblocking filter application. */
+  int64_t cdef_pick;              /**< CDEF strength search. */
+  int64_t cdef_apply;             /**< CDEF application. */
+  int64_t loop_restoration_pick;  /**< Loop restoration filter search. */
+  int64_t loop_restoration_apply; /**< Loop restoration filter application. */
+  int64_t pack_bitstream;         /**< Bitstream packing. */
+} aom_enc_stage_timings_t;
+
 /*!brief Frame drop modes for spatial/quality layer SVC */
 typedef enum {
   AOM_LAYER_DROP,           /**< Any spatial layer can drop. */
@@ -2279,6 +2342,12 @@ AOM_CTRL_USE_TYPE(AV1E_SET_POSTENCODE_DROP_RTC, int)
 AOM_CTRL_USE_TYPE(AV1E_SET_MAX_CONSEC_FRAME_DROP_MS_CBR, int)
 #define AOM_CTRL_AV1E_SET_MAX_CONSEC_FRAME_DROP_MS_CBR
 
+AOM_CTRL_USE_TYPE(AV1E_SET_SOURCE_LENDING, aom_source_lending_t *)
+#define AOM_CTRL_AV1E_SET_SOURCE_LENDING
+
+AOM_CTRL_USE_TYPE(AV1E_GET_FRAME_STAGE_TIMINGS, aom_enc_stage_timings_t *)
+#define AOM_CTRL_AV1E_GET_FRAME_STAGE_TIMINGS
+
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
@@ -69,6 +69,31 @@ typedef struct aom_inspect_init {
   void *inspect_ctx;
 } aom_inspect_init;
 
+/*!\brief Callback invoked as the rows of a decoded frame become final.
+ *
+ * \param[in] cb_priv    The cb_priv member of the aom_row_output_cb_init
+ *                       structure passed to AV1D_SET_ROW_OUTPUT_CALLBACK.
+ * \param[in] img        The frame being decoded. Only its first rows_done
+ *                       luma rows, and the chroma rows covering them, hold
+ *                       final pixels. The image and its planes remain owned
+ *                       by the decoder.
+ * \param[in] rows_done  Number of leading luma rows of img which are final.
+ *                       It increases with each call for the same frame, and
+ *                       the last call for a frame passes img->d_h.
+ */
+typedef void (*aom_row_output_cb_fn_t)(void *cb_priv, const aom_image_t *img,
+                                       unsigned int rows_done);
+
+/*!\brief Structure to hold the row output callback and its context.
+ */
+typedef struct aom_row_output_cb_init {
+  /*! Row output callback, or NULL to stop the row output. */
+  aom_row_output_cb_fn_t row_output_cb;
+
+  /*! Context passed to the row output callback. */
+  void *cb_priv;
+} aom_row_output_cb_init;
+
 /*!\brief Structure to collect a buffer index when inspecting.
  *
  * Defines a structure to hold the buffer and return an index
@@ -183,6 +208,30 @@ typedef struct av1_ext_ref_frame {
   int num;
 } av1_ext_ref_frame_t;
 
+/*!\brief Structure to hold the statistics of the large scale tile cache.
+ *
+ * Filled in by AV1D_GET_TILE_CACHE_STATS.
+ */
+typedef struct av1_tile_cache_stats {
+  /*! Number of tile list entries copied from the cache. */
+  unsigned int hits;
+  /*! Number of tile list entries that were decoded. */
+  unsigned int misses;
+  /*! Number of bytes held by the cached tiles. */
+  size_t bytes;
+} av1_tile_cache_stats_t;
+
+/*!brief Time spent in the main stages of the decoder, in microseconds */
+typedef struct aom_dec_stage_timings {
+  int64_t frame_header;     /**< Frame header parsing and frame setup. */
+  int64_t decode_tiles;     /**< Entropy decoding and reconstruction. */
+  int64_t loop_filter;      /**< Deblocking filter. */
+  int64_t cdef;             /**< CDEF. */
+  int64_t superres;         /**< Super-resolution upscaling. */
+  int64_t loop_restoration; /**< Loop restoration filter. */
+  int64_t film_grain;       /**< Film grain synthesis. */
+} aom_dec_stage_timings_t;
+
 /*!\enum aom_dec_control_id
  * \brief AOM decoder control functions
  *
@@ -466,6 +515,76 @@ enum aom_dec_control_id {
    * be used.
    */
   AV1D_GET_MI_INFO,
+
+  /*!\brief Codec control function to set a callback that is told as the rows
+   * of a decoded frame become final, aom_row_output_cb_init* parameter
+   *
+   * The callback lets the application display or convert the top of a frame
+   * while the decoder is still filtering the rows below it. It is called
+   * from the threads of the decoder during aom_codec_decode(), so it must
+   * return quickly and must not call the decoder.
+   *
+   * The rows are reported for each frame with show_frame set that is decoded
+   * with row-based multi-threading (see AV1D_SET_ROW_MT) on more than one
+   * thread from a single call to aom_codec_decode(). Otherwise the callback
+   * is called once when the frame is done. It is not called for frames
+   * shown with show_existing_frame, for frames that get film grain, or in
+   * large scale tile mode: these frames are only returned by
+   * aom_codec_get_frame(). If aom_codec_decode() fails, the rows reported
+   * for the frame are not valid.
+   */
+  AV1D_SET_ROW_OUTPUT_CALLBACK,
+
+  /*!\brief Codec control function to extend the borders of the reference
+   * frames, int parameter
+   *
+   * By default the decoder does not extend the borders of the frames it
+   * decodes. Each block whose motion vector reaches past the edge of its
+   * reference frame is copied to a temporary buffer with its border built
+   * in. When this control is set to 1, the borders of each reference frame
+   * are extended once, the first time the frame is used for prediction, and
+   * these blocks are predicted from the frame directly. This saves time on
+   * content with motion near the edges of the frame. It does not use more
+   * memory, but it writes to the borders of the frame buffers, including
+   * buffers from aom_get_frame_buffer_cb_fn_t. The decoded frames are the
+   * same either way. The default is 0.
+   */
+  AV1D_SET_EXTEND_REF_BORDERS,
+
+  /*!\brief Codec control function to set the memory budget of the tile
+   * cache used in large scale tile mode, unsigned int parameter
+   *
+   * The decoder keeps the tiles it decodes from tile list OBUs, up to this
+   * many bytes, and copies a tile from the cache instead of decoding it
+   * again when a later tile list asks for the same coded tile with the same
+   * anchor frame. The least recently used tiles are dropped first. The
+   * cache is emptied when a new camera frame header is decoded or the
+   * external references are set with AV1D_SET_EXT_REF_PTR, so the
+   * application must set them again after it changes the anchor images.
+   * The default is 0, which disables the cache.
+   */
+  AV1D_SET_TILE_CACHE_SIZE,
+
+  /*!\brief Codec control function to get the statistics of the tile cache,
+   * av1_tile_cache_stats_t* parameter
+   *
+   * The counters cover the tile lists decoded while the cache is enabled
+   * with AV1D_SET_TILE_CACHE_SIZE.
+   */
+  AV1D_GET_TILE_CACHE_STATS,
+
+  /*!\brief Codec control function to get the time spent in the main stages of
+   * the decoder since the start of the last aom_codec_decode() call,
+   * aom_dec_stage_timings_t* parameter
+   *
+   * The times are wall-clock times in microseconds, summed over all the frames
+   * decoded during the call. Film grain is added when the frames are fetched,
+   * so its time covers the aom_codec_get_frame() calls that followed. A stage
+   * that runs on several threads is timed on the thread that drives it. When
+   * row-based multi-threading filters the rows as they are decoded, the
+   * filters are part of decode_tiles.
+   */
+  AV1D_GET_FRAME_STAGE_TIMINGS,
 };
 
 /*!\cond */
@@ -598,6 +717,21 @@ AOM_CTRL_USE_TYPE(AOMD_GET_ORDER_HINT, unsigned int *)
 // The AOM_CTRL_USE_TYPE macro can't be used with AV1D_GET_MI_INFO because
 // AV1D_GET_MI_INFO takes more than one parameter.
 #define AOM_CTRL_AV1D_GET_MI_INFO
+
+AOM_CTRL_USE_TYPE(AV1D_SET_ROW_OUTPUT_CALLBACK, aom_row_output_cb_init *)
+#define AOM_CTRL_AV1D_SET_ROW_OUTPUT_CALLBACK
+
+AOM_CTRL_USE_TYPE(AV1D_SET_EXTEND_REF_BORDERS, int)
+#define AOM_CTRL_AV1D_SET_EXTEND_REF_BORDERS
+
+AOM_CTRL_USE_TYPE(AV1D_SET_TILE_CACHE_SIZE, unsigned int)
+#define AOM_CTRL_AV1D_SET_TILE_CACHE_SIZE
+
+AOM_CTRL_USE_TYPE(AV1D_GET_TILE_CACHE_STATS, av1_tile_cache_stats_t *)
+#define AOM_CTRL_AV1D_GET_TILE_CACHE_STATS
+
+AOM_CTRL_USE_TYPE(AV1D_GET_FRAME_STAGE_TIMINGS, aom_dec_stage_timings_t *)
+#define AOM_CTRL_AV1D_GET_FRAME_STAGE_TIMINGS
 /*!\endcond */
 /*! @} - end defgroup aom_decoder */
 #ifdef __cplusplus
@@ -154,6 +154,9 @@ if(CONFIG_AV1_DECODER)
               "${AOM_ROOT}/aom_dsp/bitreader.c"
               "${AOM_ROOT}/aom_dsp/bitreader.h" "${AOM_ROOT}/aom_dsp/entdec.c"
               "${AOM_ROOT}/aom_dsp/entdec.h")
+
+  list(APPEND AOM_DSP_DECODER_INTRIN_SSE2
+              "${AOM_ROOT}/aom_dsp/x86/entdec_sse2.c")
 endif()
 
 if(CONFIG_AV1_ENCODER)
@@ -259,6 +262,10 @@ if(CONFIG_AV1_ENCODER)
               "${AOM_ROOT}/aom_dsp/x86/blk_sse_sum_avx2.c"
               "${AOM_ROOT}/aom_dsp/x86/sum_squares_avx2.c")
 
+  list(APPEND AOM_DSP_ENCODER_INTRIN_AVX512
+              "${AOM_ROOT}/aom_dsp/x86/sad4d_avx512.c"
+              "${AOM_ROOT}/aom_dsp/x86/variance_avx512.c")
+
   list(APPEND AOM_DSP_ENCODER_INTRIN_AVX
               "${AOM_ROOT}/aom_dsp/x86/aom_quantize_avx.c")
 
@@ -430,6 +437,11 @@ function(setup_aom_dsp_targets)
     add_intrinsics_object_library("-msse2" "sse2" "aom_dsp_common"
                                   "AOM_DSP_COMMON_INTRIN_SSE2")
 
+    if(CONFIG_AV1_DECODER)
+      add_intrinsics_object_library("-msse2" "sse2" "aom_dsp_decoder"
+                                    "AOM_DSP_DECODER_INTRIN_SSE2")
+    endif()
+
     if(CONFIG_AV1_ENCODER)
       if("${AOM_TARGET_CPU}" STREQUAL "x86_64")
         list(APPEND AOM_DSP_ENCODER_ASM_SSE2 ${AOM_DSP_ENCODER_ASM_SSE2_X86_64})
@@ -481,6 +493,14 @@ function(setup_aom_dsp_targets)
     endif()
   endif()
 
+  if(HAVE_AVX512)
+    if(CONFIG_AV1_ENCODER)
+      add_intrinsics_object_library("${AOM_AVX512_FLAGS}" "avx512"
+                                    "aom_dsp_encoder"
+                                    "AOM_DSP_ENCODER_INTRIN_AVX512")
+    endif()
+  endif()
+
   if(HAVE_NEON)
     add_intrinsics_object_library("${AOM_NEON_INTRIN_FLAG}" "neon"
                                   "aom_dsp_common" "AOM_DSP_COMMON_INTRIN_NEON")
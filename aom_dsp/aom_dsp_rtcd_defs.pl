@@ -669,6 +669,14 @@ if (aom_config("CONFIG_AV1_HIGHBITDEPTH") eq "yes") {
   specialize qw/aom_highbd_lpf_horizontal_4_dual neon sse2 avx2/;
 }
 
+#
+# Entropy decoding
+#
+if (aom_config("CONFIG_AV1_DECODER") eq "yes") {
+  add_proto qw/int aom_ec_cdf_search/, "const uint16_t *icdf, int nsyms, unsigned c, unsigned r";
+  specialize qw/aom_ec_cdf_search sse2/;
+}
+
 #
 # Encoder functions.
 #
@@ -1036,14 +1044,14 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
     }
   }
 
-  specialize qw/aom_sad128x128x4d avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad128x64x4d  avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad64x128x4d  avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad64x64x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad64x32x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad32x64x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad32x32x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad32x16x4d   avx2 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad128x128x4d avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad128x64x4d  avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad64x128x4d  avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad64x64x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad64x32x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad32x64x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad32x32x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad32x16x4d   avx2 avx512 sse2 neon neon_dotprod/;
   specialize qw/aom_sad16x32x4d   avx2 sse2 neon neon_dotprod/;
   specialize qw/aom_sad16x16x4d   avx2 sse2 neon neon_dotprod/;
   specialize qw/aom_sad16x8x4d    avx2 sse2 neon neon_dotprod/;
@@ -1054,22 +1062,22 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   specialize qw/aom_sad4x8x4d          sse2 neon/;
   specialize qw/aom_sad4x4x4d          sse2 neon/;
 
-  specialize qw/aom_sad64x16x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad32x8x4d    avx2 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad64x16x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad32x8x4d    avx2 avx512 sse2 neon neon_dotprod/;
   specialize qw/aom_sad16x64x4d   avx2 sse2 neon neon_dotprod/;
   specialize qw/aom_sad16x4x4d    avx2 sse2 neon neon_dotprod/;
   specialize qw/aom_sad8x32x4d         sse2 neon/;
   specialize qw/aom_sad4x16x4d         sse2 neon/;
 
-  specialize qw/aom_sad_skip_128x128x4d avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad_skip_128x64x4d  avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad_skip_64x128x4d  avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad_skip_64x64x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad_skip_64x32x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad_skip_64x16x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad_skip_32x64x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad_skip_32x32x4d   avx2 sse2 neon neon_dotprod/;
-  specialize qw/aom_sad_skip_32x16x4d   avx2 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_128x128x4d avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_128x64x4d  avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_64x128x4d  avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_64x64x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_64x32x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_64x16x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_32x64x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_32x32x4d   avx2 avx512 sse2 neon neon_dotprod/;
+  specialize qw/aom_sad_skip_32x16x4d   avx2 avx512 sse2 neon neon_dotprod/;
 
   specialize qw/aom_sad_skip_16x64x4d   avx2 sse2 neon neon_dotprod/;
   specialize qw/aom_sad_skip_16x32x4d   avx2 sse2 neon neon_dotprod/;
@@ -1336,14 +1344,14 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
     add_proto qw/uint32_t/, "aom_sub_pixel_variance${w}x${h}", "const uint8_t *src_ptr, int source_stride, int xoffset, int  yoffset, const uint8_t *ref_ptr, int ref_stride, uint32_t *sse";
     add_proto qw/uint32_t/, "aom_sub_pixel_avg_variance${w}x${h}", "const uint8_t *src_ptr, int source_stride, int xoffset, int  yoffset, const uint8_t *ref_ptr, int ref_stride, uint32_t *sse, const uint8_t *second_pred";
   }
-  specialize qw/aom_variance128x128   sse2 avx2 neon neon_dotprod/;
-  specialize qw/aom_variance128x64    sse2 avx2 neon neon_dotprod/;
-  specialize qw/aom_variance64x128    sse2 avx2 neon neon_dotprod/;
-  specialize qw/aom_variance64x64     sse2 avx2 neon neon_dotprod/;
-  specialize qw/aom_variance64x32     sse2 avx2 neon neon_dotprod/;
-  specialize qw/aom_variance32x64     sse2 avx2 neon neon_dotprod/;
-  specialize qw/aom_variance32x32     sse2 avx2 neon neon_dotprod/;
-  specialize qw/aom_variance32x16     sse2 avx2 neon neon_dotprod/;
+  specialize qw/aom_variance128x128   sse2 avx2 avx512 neon neon_dotprod/;
+  specialize qw/aom_variance128x64    sse2 avx2 avx512 neon neon_dotprod/;
+  specialize qw/aom_variance64x128    sse2 avx2 avx512 neon neon_dotprod/;
+  specialize qw/aom_variance64x64     sse2 avx2 avx512 neon neon_dotprod/;
+  specialize qw/aom_variance64x32     sse2 avx2 avx512 neon neon_dotprod/;
+  specialize qw/aom_variance32x64     sse2 avx2 avx512 neon neon_dotprod/;
+  specialize qw/aom_variance32x32     sse2 avx2 avx512 neon neon_dotprod/;
+  specialize qw/aom_variance32x16     sse2 avx2 avx512 neon neon_dotprod/;
   specialize qw/aom_variance16x32     sse2 avx2 neon neon_dotprod/;
   specialize qw/aom_variance16x16     sse2 avx2 neon neon_dotprod/;
   specialize qw/aom_variance16x8      sse2 avx2 neon neon_dotprod/;
@@ -1391,9 +1399,9 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
     specialize qw/aom_variance4x16  neon neon_dotprod sse2/;
     specialize qw/aom_variance16x4  neon neon_dotprod sse2 avx2/;
     specialize qw/aom_variance8x32  neon neon_dotprod sse2/;
-    specialize qw/aom_variance32x8  neon neon_dotprod sse2 avx2/;
+    specialize qw/aom_variance32x8  neon neon_dotprod sse2 avx2 avx512/;
     specialize qw/aom_variance16x64 neon neon_dotprod sse2 avx2/;
-    specialize qw/aom_variance64x16 neon neon_dotprod sse2 avx2/;
+    specialize qw/aom_variance64x16 neon neon_dotprod sse2 avx2 avx512/;
 
     specialize qw/aom_sub_pixel_variance4x16 neon ssse3/;
     specialize qw/aom_sub_pixel_variance16x4 neon avx2 ssse3/;
@@ -10,8 +10,13 @@
  */
 
 #include <assert.h>
+#include <string.h>
+
+#include "config/aom_dsp_rtcd.h"
+
 #include "aom_dsp/entdec.h"
 #include "aom_dsp/prob.h"
+#include "aom_util/endian_inl.h"
 
 /*A range decoder.
   This is an entropy decoder based upon \cite{Mar79}, which is itself a
@@ -73,6 +78,11 @@
   Even relatively modest values like 100 would work fine.*/
 #define OD_EC_LOTS_OF_BITS (0x4000)
 
+/*The smallest alphabet for which od_ec_decode_cdf_q15() calls
+   aom_ec_cdf_search(). Smaller alphabets usually stop after one or two
+   thresholds, so the loop is cheaper than comparing all of them.*/
+#define OD_EC_CDF_SEARCH_MIN_SYMS (8)
+
 /*The return value of od_ec_dec_tell does not change across an od_ec_dec_refill
    call.*/
 static void od_ec_dec_refill(od_ec_dec *dec) {
@@ -86,6 +96,25 @@ static void od_ec_dec_refill(od_ec_dec *dec) {
   bptr = dec->bptr;
   end = dec->end;
   s = OD_EC_WINDOW_SIZE - 9 - (cnt + 15);
+  if (end - bptr >= (ptrdiff_t)sizeof(od_ec_window)) {
+    /*Away from the end of the buffer, all the whole bytes which fit in the
+       window are inserted with a single load. Byte i goes to bit s - 8 * i,
+       so the last one lands at bit s & 7.*/
+    const int nbytes = (s >> 3) + 1;
+    od_ec_window bytes;
+    assert(s >= 0 && nbytes < (int)sizeof(od_ec_window));
+    memcpy(&bytes, bptr, sizeof(bytes));
+#if OD_EC_WINDOW_64BIT
+    bytes = HToBE64(bytes);
+#else
+    bytes = HToBE32(bytes);
+#endif
+    dif ^= bytes >> (OD_EC_WINDOW_SIZE - 8 * nbytes) << (s & 7);
+    dec->dif = dif;
+    dec->cnt = (int16_t)(cnt + 8 * nbytes);
+    dec->bptr = bptr + nbytes;
+    return;
+  }
   for (; s >= 0 && bptr < end; s -= 8, bptr++) {
     /*Each time a byte is inserted into the window (dif), bptr advances and cnt
        is incremented by 8, so the total number of consumed bits (the return
@@ -143,7 +172,10 @@ static int od_ec_dec_normalize(od_ec_dec *dec, od_ec_window dif, unsigned rng,
 void od_ec_dec_init(od_ec_dec *dec, const unsigned char *buf,
                     uint32_t storage) {
   dec->buf = buf;
-  dec->tell_offs = 10 - (OD_EC_WINDOW_SIZE - 8);
+  /*od_ec_dec_tell() starts at 1, like od_ec_enc_tell(), which reserves 1 bit
+     for terminating the stream. Whatever the size of the window, the refill
+     below leaves cnt 15 bits short of the bits it reads.*/
+  dec->tell_offs = 1 - 15;
   dec->end = buf + storage;
   dec->bptr = buf;
   dec->dif = ((od_ec_window)1 << (OD_EC_WINDOW_SIZE - 1)) - 1;
@@ -181,6 +213,26 @@ int od_ec_decode_bool_q15(od_ec_dec *dec, unsigned f) {
   return od_ec_dec_normalize(dec, dif, r_new, ret);
 }
 
+/*Returns the lower bound of the range of the coded value for which the
+   symbol decoded from icdf is larger than s, given the range r. It decreases
+   with s, down to 0 for the last symbol n.*/
+static inline unsigned od_ec_cdf_threshold(const uint16_t *icdf, int n, int s,
+                                           unsigned r) {
+  return ((r >> 8) * (uint32_t)(icdf[s] >> EC_PROB_SHIFT) >>
+          (7 - EC_PROB_SHIFT)) +
+         EC_MIN_PROB * (n - s);
+}
+
+/*Returns the symbol decoded from icdf when the top 16 bits of the window hold
+   c, i.e., the number of symbols s < nsyms - 1 with c below their threshold.*/
+int aom_ec_cdf_search_c(const uint16_t *icdf, int nsyms, unsigned c,
+                        unsigned r) {
+  const int n = nsyms - 1;
+  int ret = 0;
+  while (c < od_ec_cdf_threshold(icdf, n, ret, r)) ret++;
+  return ret;
+}
+
 /*Decodes a symbol given an inverse cumulative distribution function (CDF)
    table in Q15.
   icdf: CDF_PROB_TOP minus the CDF, such that symbol s falls in the range
@@ -197,7 +249,6 @@ int od_ec_decode_cdf_q15(od_ec_dec *dec, const uint16_t *icdf, int nsyms) {
   unsigned u;
   unsigned v;
   int ret;
-  (void)nsyms;
   dif = dec->dif;
   r = dec->rng;
   const int N = nsyms - 1;
@@ -207,14 +258,20 @@ int od_ec_decode_cdf_q15(od_ec_dec *dec, const uint16_t *icdf, int nsyms) {
   assert(32768U <= r);
   assert(7 - EC_PROB_SHIFT >= 0);
   c = (unsigned)(dif >> (OD_EC_WINDOW_SIZE - 16));
-  v = r;
-  ret = -1;
-  do {
-    u = v;
-    v = ((r >> 8) * (uint32_t)(icdf[++ret] >> EC_PROB_SHIFT) >>
-         (7 - EC_PROB_SHIFT));
-    v += EC_MIN_PROB * (N - ret);
-  } while (c < v);
+  if (nsyms >= OD_EC_CDF_SEARCH_MIN_SYMS) {
+    /*Large alphabets compare c against all the thresholds at once.*/
+    ret = aom_ec_cdf_search(icdf, nsyms, c, r);
+    u = ret > 0 ? od_ec_cdf_threshold(icdf, N, ret - 1, r) : r;
+    v = od_ec_cdf_threshold(icdf, N, ret, r);
+  } else {
+    v = r;
+    ret = -1;
+    do {
+      u = v;
+      v = od_ec_cdf_threshold(icdf, N, ++ret, r);
+    } while (c < v);
+  }
+  assert(c >= v);
   assert(v < u);
   assert(u <= r);
   r = u - v;
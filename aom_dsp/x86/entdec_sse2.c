@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <emmintrin.h>
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/entcode.h"
+
+// Returns 1 in each 16-bit lane of the 8 symbols base, ..., base + 7 of icdf
+// for which c is below the threshold of the symbol, and 0 in the other lanes.
+// Only the lanes of the symbols first, ..., n - 1 are counted.
+static inline __m128i cdf_below_thresholds(const uint16_t *icdf, int base,
+                                           int first, int n, __m128i c,
+                                           __m128i r8) {
+  const __m128i lanes = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m128i p = _mm_srli_epi16(
+      _mm_loadu_si128((const __m128i *)(icdf + base)), EC_PROB_SHIFT);
+  // (r >> 8) * p needs 17 bits, of which the threshold keeps the top 16.
+  const __m128i lo = _mm_mullo_epi16(p, r8);
+  const __m128i hi = _mm_mulhi_epu16(p, r8);
+  const __m128i prod = _mm_or_si128(_mm_slli_epi16(hi, 16 - 1),
+                                    _mm_srli_epi16(lo, 1));
+  // EC_MIN_PROB * (n - s) for the symbol s = base + lane.
+  const __m128i min_prob = _mm_sub_epi16(
+      _mm_set1_epi16((int16_t)(EC_MIN_PROB * (n - base))),
+      _mm_slli_epi16(lanes, 2));
+  const __m128i v = _mm_add_epi16(prod, min_prob);
+  // c < v, as unsigned 16-bit values.
+  const __m128i below =
+      _mm_xor_si128(_mm_cmpeq_epi16(_mm_subs_epu16(v, c), _mm_setzero_si128()),
+                    _mm_set1_epi16(-1));
+  const __m128i counted =
+      _mm_and_si128(_mm_cmpgt_epi16(lanes, _mm_set1_epi16(first - base - 1)),
+                    _mm_cmplt_epi16(lanes, _mm_set1_epi16(n - base)));
+  return _mm_and_si128(_mm_and_si128(below, counted), _mm_set1_epi16(1));
+}
+
+int aom_ec_cdf_search_sse2(const uint16_t *icdf, int nsyms, unsigned c,
+                           unsigned r) {
+  assert(EC_PROB_SHIFT == 6 && EC_MIN_PROB == 4);
+  assert(nsyms <= 16);
+  // The loads stay within the nsyms values of icdf. The symbols from 8 on
+  // come from a second load, which may overlap the first one.
+  if (nsyms < 8) return aom_ec_cdf_search_c(icdf, nsyms, c, r);
+  const int n = nsyms - 1;
+  const __m128i cc = _mm_set1_epi16((int16_t)c);
+  const __m128i r8 = _mm_set1_epi16((int16_t)(r >> 8));
+  __m128i count = cdf_below_thresholds(icdf, 0, 0, n, cc, r8);
+  if (n > 8) {
+    const int base = AOMMIN(nsyms - 8, 8);
+    count = _mm_add_epi16(count,
+                          cdf_below_thresholds(icdf, base, 8, n, cc, r8));
+  }
+  count = _mm_sad_epu8(count, _mm_setzero_si128());
+  return _mm_cvtsi128_si32(count) + _mm_extract_epi16(count, 4);
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+#include <assert.h>
+#include <immintrin.h>  // AVX512
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+
+// Loads 32 bytes from each of two consecutive rows into one register.
+static AOM_FORCE_INLINE __m512i loadu_2x256(const uint8_t *p, int stride) {
+  const __m256i lo = _mm256_loadu_si256((const __m256i *)p);
+  const __m256i hi = _mm256_loadu_si256((const __m256i *)(p + stride));
+  return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+}
+
+static AOM_FORCE_INLINE void store_sums(uint32_t res[4], const __m512i *sum0,
+                                        const __m512i *sum1,
+                                        const __m512i *sum2,
+                                        const __m512i *sum3) {
+  // Each 64-bit lane holds a partial sum that fits in 32 bits, so the
+  // reduction cannot overflow.
+  res[0] = (uint32_t)_mm512_reduce_add_epi64(*sum0);
+  res[1] = (uint32_t)_mm512_reduce_add_epi64(*sum1);
+  res[2] = (uint32_t)_mm512_reduce_add_epi64(*sum2);
+  res[3] = (uint32_t)_mm512_reduce_add_epi64(*sum3);
+}
+
+// Block widths that are a multiple of 64: one 512-bit load per 64 pixels.
+static AOM_FORCE_INLINE void aom_sadMxNx4d_avx512(
+    int M, int N, const uint8_t *src, int src_stride,
+    const uint8_t *const ref[4], int ref_stride, uint32_t res[4]) {
+  __m512i sum_ref0 = _mm512_setzero_si512();
+  __m512i sum_ref1 = _mm512_setzero_si512();
+  __m512i sum_ref2 = _mm512_setzero_si512();
+  __m512i sum_ref3 = _mm512_setzero_si512();
+  const uint8_t *ref0 = ref[0];
+  const uint8_t *ref1 = ref[1];
+  const uint8_t *ref2 = ref[2];
+  const uint8_t *ref3 = ref[3];
+
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j < M; j += 64) {
+      const __m512i src_reg = _mm512_loadu_si512((const void *)(src + j));
+      const __m512i ref0_reg = _mm512_loadu_si512((const void *)(ref0 + j));
+      const __m512i ref1_reg = _mm512_loadu_si512((const void *)(ref1 + j));
+      const __m512i ref2_reg = _mm512_loadu_si512((const void *)(ref2 + j));
+      const __m512i ref3_reg = _mm512_loadu_si512((const void *)(ref3 + j));
+
+      sum_ref0 = _mm512_add_epi64(sum_ref0, _mm512_sad_epu8(ref0_reg, src_reg));
+      sum_ref1 = _mm512_add_epi64(sum_ref1, _mm512_sad_epu8(ref1_reg, src_reg));
+      sum_ref2 = _mm512_add_epi64(sum_ref2, _mm512_sad_epu8(ref2_reg, src_reg));
+      sum_ref3 = _mm512_add_epi64(sum_ref3, _mm512_sad_epu8(ref3_reg, src_reg));
+    }
+    src += src_stride;
+    ref0 += ref_stride;
+    ref1 += ref_stride;
+    ref2 += ref_stride;
+    ref3 += ref_stride;
+  }
+
+  store_sums(res, &sum_ref0, &sum_ref1, &sum_ref2, &sum_ref3);
+}
+
+// 32-pixel wide blocks: two rows per 512-bit load.
+static AOM_FORCE_INLINE void aom_sad32xNx4d_avx512(
+    int N, const uint8_t *src, int src_stride, const uint8_t *const ref[4],
+    int ref_stride, uint32_t res[4]) {
+  __m512i sum_ref0 = _mm512_setzero_si512();
+  __m512i sum_ref1 = _mm512_setzero_si512();
+  __m512i sum_ref2 = _mm512_setzero_si512();
+  __m512i sum_ref3 = _mm512_setzero_si512();
+  const uint8_t *ref0 = ref[0];
+  const uint8_t *ref1 = ref[1];
+  const uint8_t *ref2 = ref[2];
+  const uint8_t *ref3 = ref[3];
+  assert(N % 2 == 0);
+
+  for (int i = 0; i < N; i += 2) {
+    const __m512i src_reg = loadu_2x256(src, src_stride);
+    const __m512i ref0_reg = loadu_2x256(ref0, ref_stride);
+    const __m512i ref1_reg = loadu_2x256(ref1, ref_stride);
+    const __m512i ref2_reg = loadu_2x256(ref2, ref_stride);
+    const __m512i ref3_reg = loadu_2x256(ref3, ref_stride);
+
+    sum_ref0 = _mm512_add_epi64(sum_ref0, _mm512_sad_epu8(ref0_reg, src_reg));
+    sum_ref1 = _mm512_add_epi64(sum_ref1, _mm512_sad_epu8(ref1_reg, src_reg));
+    sum_ref2 = _mm512_add_epi64(sum_ref2, _mm512_sad_epu8(ref2_reg, src_reg));
+    sum_ref3 = _mm512_add_epi64(sum_ref3, _mm512_sad_epu8(ref3_reg, src_reg));
+
+    src += 2 * src_stride;
+    ref0 += 2 * ref_stride;
+    ref1 += 2 * ref_stride;
+    ref2 += 2 * ref_stride;
+    ref3 += 2 * ref_stride;
+  }
+
+  store_sums(res, &sum_ref0, &sum_ref1, &sum_ref2, &sum_ref3);
+}
+
+#define SADMXN_AVX512(m, n)                                                  \
+  void aom_sad##m##x##n##x4d_avx512(const uint8_t *src, int src_stride,      \
+                                    const uint8_t *const ref[4],             \
+                                    int ref_stride, uint32_t res[4]) {       \
+    aom_sadMxNx4d_avx512(m, n, src, src_stride, ref, ref_stride, res);       \
+  }
+
+#define SAD32XN_AVX512(n)                                                    \
+  void aom_sad32x##n##x4d_avx512(const uint8_t *src, int src_stride,         \
+                                 const uint8_t *const ref[4], int ref_stride, \
+                                 uint32_t res[4]) {                          \
+    aom_sad32xNx4d_avx512(n, src, src_stride, ref, ref_stride, res);         \
+  }
+
+SAD32XN_AVX512(16)
+SAD32XN_AVX512(32)
+SAD32XN_AVX512(64)
+
+SADMXN_AVX512(64, 32)
+SADMXN_AVX512(64, 64)
+SADMXN_AVX512(64, 128)
+
+SADMXN_AVX512(128, 64)
+SADMXN_AVX512(128, 128)
+
+#if !CONFIG_REALTIME_ONLY
+SAD32XN_AVX512(8)
+SADMXN_AVX512(64, 16)
+#endif  // !CONFIG_REALTIME_ONLY
+
+#define SAD_SKIP_MXN_AVX512(m, n)                                             \
+  void aom_sad_skip_##m##x##n##x4d_avx512(const uint8_t *src, int src_stride, \
+                                          const uint8_t *const ref[4],        \
+                                          int ref_stride, uint32_t res[4]) {  \
+    aom_sadMxNx4d_avx512(m, ((n) >> 1), src, 2 * src_stride, ref,             \
+                         2 * ref_stride, res);                                \
+    res[0] <<= 1;                                                             \
+    res[1] <<= 1;                                                             \
+    res[2] <<= 1;                                                             \
+    res[3] <<= 1;                                                             \
+  }
+
+#define SAD_SKIP_32XN_AVX512(n)                                             \
+  void aom_sad_skip_32x##n##x4d_avx512(const uint8_t *src, int src_stride,  \
+                                       const uint8_t *const ref[4],         \
+                                       int ref_stride, uint32_t res[4]) {   \
+    aom_sad32xNx4d_avx512(((n) >> 1), src, 2 * src_stride, ref,             \
+                          2 * ref_stride, res);                             \
+    res[0] <<= 1;                                                           \
+    res[1] <<= 1;                                                           \
+    res[2] <<= 1;                                                           \
+    res[3] <<= 1;                                                           \
+  }
+
+SAD_SKIP_32XN_AVX512(16)
+SAD_SKIP_32XN_AVX512(32)
+SAD_SKIP_32XN_AVX512(64)
+
+SAD_SKIP_MXN_AVX512(64, 32)
+SAD_SKIP_MXN_AVX512(64, 64)
+SAD_SKIP_MXN_AVX512(64, 128)
+
+SAD_SKIP_MXN_AVX512(128, 64)
+SAD_SKIP_MXN_AVX512(128, 128)
+
+#if !CONFIG_REALTIME_ONLY
+SAD_SKIP_MXN_AVX512(64, 16)
+#endif  // !CONFIG_REALTIME_ONLY
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX512
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+
+// Accumulates the sum of squared differences and the sum of differences of 64
+// pixel pairs into 32-bit lanes of 'sse' and 'sum'.
+static AOM_FORCE_INLINE void variance_kernel_avx512(const __m512i src,
+                                                    const __m512i ref,
+                                                    __m512i *sse,
+                                                    __m512i *sum) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i ones = _mm512_set1_epi16(1);
+  // The unpacks interleave within 128-bit lanes, but do so identically for
+  // src and ref, so corresponding pixels stay paired.
+  const __m512i src_lo = _mm512_unpacklo_epi8(src, zero);
+  const __m512i src_hi = _mm512_unpackhi_epi8(src, zero);
+  const __m512i ref_lo = _mm512_unpacklo_epi8(ref, zero);
+  const __m512i ref_hi = _mm512_unpackhi_epi8(ref, zero);
+  const __m512i diff_lo = _mm512_sub_epi16(src_lo, ref_lo);
+  const __m512i diff_hi = _mm512_sub_epi16(src_hi, ref_hi);
+
+  *sse = _mm512_add_epi32(*sse, _mm512_madd_epi16(diff_lo, diff_lo));
+  *sse = _mm512_add_epi32(*sse, _mm512_madd_epi16(diff_hi, diff_hi));
+  *sum = _mm512_add_epi32(*sum, _mm512_madd_epi16(diff_lo, ones));
+  *sum = _mm512_add_epi32(*sum, _mm512_madd_epi16(diff_hi, ones));
+}
+
+// Block widths that are a multiple of 64.
+static AOM_FORCE_INLINE void variance_wxh_avx512(const uint8_t *src,
+                                                 int src_stride,
+                                                 const uint8_t *ref,
+                                                 int ref_stride, int w, int h,
+                                                 uint32_t *sse, int *sum) {
+  __m512i vsse = _mm512_setzero_si512();
+  __m512i vsum = _mm512_setzero_si512();
+  for (int i = 0; i < h; ++i) {
+    for (int j = 0; j < w; j += 64) {
+      const __m512i s = _mm512_loadu_si512((const void *)(src + j));
+      const __m512i r = _mm512_loadu_si512((const void *)(ref + j));
+      variance_kernel_avx512(s, r, &vsse, &vsum);
+    }
+    src += src_stride;
+    ref += ref_stride;
+  }
+  // A 128x128 block sums to at most 128 * 128 * 255 * 255 < 2^32.
+  *sse = (uint32_t)_mm512_reduce_add_epi32(vsse);
+  *sum = _mm512_reduce_add_epi32(vsum);
+}
+
+// 32-pixel wide blocks: two rows per 512-bit load.
+static AOM_FORCE_INLINE void variance_32xh_avx512(const uint8_t *src,
+                                                  int src_stride,
+                                                  const uint8_t *ref,
+                                                  int ref_stride, int h,
+                                                  uint32_t *sse, int *sum) {
+  __m512i vsse = _mm512_setzero_si512();
+  __m512i vsum = _mm512_setzero_si512();
+  for (int i = 0; i < h; i += 2) {
+    const __m512i s = _mm512_inserti64x4(
+        _mm512_castsi256_si512(_mm256_loadu_si256((const __m256i *)src)),
+        _mm256_loadu_si256((const __m256i *)(src + src_stride)), 1);
+    const __m512i r = _mm512_inserti64x4(
+        _mm512_castsi256_si512(_mm256_loadu_si256((const __m256i *)ref)),
+        _mm256_loadu_si256((const __m256i *)(ref + ref_stride)), 1);
+    variance_kernel_avx512(s, r, &vsse, &vsum);
+    src += 2 * src_stride;
+    ref += 2 * ref_stride;
+  }
+  *sse = (uint32_t)_mm512_reduce_add_epi32(vsse);
+  *sum = _mm512_reduce_add_epi32(vsum);
+}
+
+#define AOM_VAR_AVX512(w, h)                                              \
+  unsigned int aom_variance##w##x##h##_avx512(                            \
+      const uint8_t *src, int src_stride, const uint8_t *ref,             \
+      int ref_stride, unsigned int *sse) {                                \
+    int sum;                                                              \
+    variance_wxh_avx512(src, src_stride, ref, ref_stride, w, h, sse,      \
+                        &sum);                                            \
+    return *sse - (uint32_t)(((int64_t)sum * sum) / (w * h));             \
+  }
+
+#define AOM_VAR_32XH_AVX512(h)                                                \
+  unsigned int aom_variance32x##h##_avx512(                                   \
+      const uint8_t *src, int src_stride, const uint8_t *ref, int ref_stride, \
+      unsigned int *sse) {                                                    \
+    int sum;                                                                  \
+    variance_32xh_avx512(src, src_stride, ref, ref_stride, h, sse, &sum);     \
+    return *sse - (uint32_t)(((int64_t)sum * sum) / (32 * h));                \
+  }
+
+AOM_VAR_32XH_AVX512(16)
+AOM_VAR_32XH_AVX512(32)
+AOM_VAR_32XH_AVX512(64)
+
+AOM_VAR_AVX512(64, 32)
+AOM_VAR_AVX512(64, 64)
+AOM_VAR_AVX512(64, 128)
+
+AOM_VAR_AVX512(128, 64)
+AOM_VAR_AVX512(128, 128)
+
+#if !CONFIG_REALTIME_ONLY
+AOM_VAR_32XH_AVX512(8)
+AOM_VAR_AVX512(64, 16)
+#endif  // !CONFIG_REALTIME_ONLY
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+//
+// Atomic integer operations with the C11 memory orders, for the compilers
+// and language modes without <stdatomic.h>.
+
+#ifndef AOM_AOM_UTIL_AOM_ATOMICS_H_
+#define AOM_AOM_UTIL_AOM_ATOMICS_H_
+
+#include "config/aom_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_MULTITHREAD
+
+#if defined(__has_builtin)
+#define AOM_HAS_BUILTIN(x) __has_builtin(x)
+#else
+#define AOM_HAS_BUILTIN(x) 0
+#endif
+
+#if AOM_HAS_BUILTIN(__atomic_load_n) || \
+    (defined(__GNUC__) &&                \
+     (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+// The __atomic builtins of GCC 4.7 and Clang follow the C11 memory model.
+#define AOM_USE_ATOMIC_BUILTINS 1
+#define AOM_USE_MSVC_INTERLOCKED 0
+#elif defined(_MSC_VER)
+// Interlocked functions are full barriers. Volatile accesses compiled with
+// /volatile:ms have acquire and release semantics on x86 and x64 only.
+#define AOM_USE_ATOMIC_BUILTINS 0
+#define AOM_USE_MSVC_INTERLOCKED 1
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>  // NOLINT
+#else
+#error Atomic operations are not supported by this compiler.
+#endif
+
+#endif  // CONFIG_MULTITHREAD
+
+typedef struct aom_atomic_int {
+  volatile int value;
+} aom_atomic_int;
+
+static inline void aom_atomic_init(aom_atomic_int *atomic, int value) {
+  atomic->value = value;
+}
+
+static inline int aom_atomic_load_acquire(const aom_atomic_int *atomic) {
+#if !CONFIG_MULTITHREAD
+  return atomic->value;
+#elif AOM_USE_ATOMIC_BUILTINS
+  return __atomic_load_n(&atomic->value, __ATOMIC_ACQUIRE);
+#else
+  const int value = atomic->value;
+#if !defined(_M_IX86) && !defined(_M_X64)
+  MemoryBarrier();
+#endif
+  _ReadWriteBarrier();
+  return value;
+#endif
+}
+
+static inline void aom_atomic_store_release(aom_atomic_int *atomic,
+                                            int value) {
+#if !CONFIG_MULTITHREAD
+  atomic->value = value;
+#elif AOM_USE_ATOMIC_BUILTINS
+  __atomic_store_n(&atomic->value, value, __ATOMIC_RELEASE);
+#else
+  _ReadWriteBarrier();
+#if !defined(_M_IX86) && !defined(_M_X64)
+  MemoryBarrier();
+#endif
+  atomic->value = value;
+#endif
+}
+
+// Sequentially consistent addition. Returns the previous value.
+static inline int aom_atomic_fetch_add(aom_atomic_int *atomic, int value) {
+#if !CONFIG_MULTITHREAD
+  const int prev = atomic->value;
+  atomic->value = prev + value;
+  return prev;
+#elif AOM_USE_ATOMIC_BUILTINS
+  return __atomic_fetch_add(&atomic->value, value, __ATOMIC_SEQ_CST);
+#else
+  return (int)InterlockedExchangeAdd((volatile LONG *)&atomic->value, value);
+#endif
+}
+
+// Sequentially consistent compare and exchange. On failure, *expected is set
+// to the current value.
+static inline int aom_atomic_compare_exchange(aom_atomic_int *atomic,
+                                              int *expected, int desired) {
+#if !CONFIG_MULTITHREAD
+  if (atomic->value != *expected) {
+    *expected = atomic->value;
+    return 0;
+  }
+  atomic->value = desired;
+  return 1;
+#elif AOM_USE_ATOMIC_BUILTINS
+  return __atomic_compare_exchange_n(&atomic->value, expected, desired, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#else
+  const int prev = (int)InterlockedCompareExchange(
+      (volatile LONG *)&atomic->value, desired, *expected);
+  if (prev == *expected) return 1;
+  *expected = prev;
+  return 0;
+#endif
+}
+
+// Sequentially consistent fence.
+static inline void aom_atomic_thread_fence(void) {
+#if !CONFIG_MULTITHREAD
+#elif AOM_USE_ATOMIC_BUILTINS
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#else
+  MemoryBarrier();
+#endif
+}
+
+// Hint to the processor that the thread is spinning on a shared value.
+static inline void aom_atomic_spin_pause(void) {
+#if !CONFIG_MULTITHREAD
+#elif AOM_USE_ATOMIC_BUILTINS && (defined(__i386__) || defined(__x86_64__))
+  __builtin_ia32_pause();
+#elif AOM_USE_ATOMIC_BUILTINS && defined(__aarch64__)
+  __asm__ __volatile__("yield" ::: "memory");
+#elif AOM_USE_MSVC_INTERLOCKED
+  YieldProcessor();
+#endif
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AOM_UTIL_AOM_ATOMICS_H_
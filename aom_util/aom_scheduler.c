@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2025, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#include "aom_mem/aom_mem.h"
+#include "aom_util/aom_scheduler.h"
+
+void aom_scheduler_group_init(AVxTaskGroup *group) {
+  aom_atomic_init(&group->pending, 0);
+}
+
+static int run_task(const AVxTask *task) {
+  const int ok = task->hook(task->data1, task->data2);
+  if (!ok && task->had_error != NULL) *task->had_error = 1;
+  // Returns true if this was the last task of the group.
+  return aom_atomic_fetch_add(&task->group->pending, -1) == 1;
+}
+
+#if CONFIG_MULTITHREAD
+
+// Number of polls of the scheduler state before blocking on its condition
+// variable.
+#define SCHEDULER_SPIN_COUNT 1024
+
+static int queue_push(AVxTaskQueue *queue, const AVxTask *task) {
+  int ok = 1;
+  pthread_mutex_lock(&queue->mutex_);
+  if (queue->count == queue->size) {
+    const int size = queue->size ? 2 * queue->size : 4;
+    AVxTask *const tasks = (AVxTask *)aom_malloc(size * sizeof(*tasks));
+    if (tasks == NULL) {
+      ok = 0;
+    } else {
+      for (int i = 0; i < queue->count; ++i) {
+        tasks[i] = queue->tasks[(queue->head + i) % queue->size];
+      }
+      aom_free(queue->tasks);
+      queue->tasks = tasks;
+      queue->size = size;
+      queue->head = 0;
+    }
+  }
+  if (ok) {
+    queue->tasks[(queue->head + queue->count) % queue->size] = *task;
+    ++queue->count;
+  }
+  pthread_mutex_unlock(&queue->mutex_);
+  return ok;
+}
+
+// The owner of a queue takes its newest task, while other threads steal the
+// oldest one.
+static int queue_pop(AVxTaskQueue *queue, AVxTask *task, int newest) {
+  int found = 0;
+  pthread_mutex_lock(&queue->mutex_);
+  if (queue->count > 0) {
+    --queue->count;
+    if (newest) {
+      *task = queue->tasks[(queue->head + queue->count) % queue->size];
+    } else {
+      *task = queue->tasks[queue->head];
+      queue->head = (queue->head + 1) % queue->size;
+    }
+    found = 1;
+  }
+  pthread_mutex_unlock(&queue->mutex_);
+  return found;
+}
+
+static void wake_all(AVxScheduler *scheduler) {
+  pthread_mutex_lock(&scheduler->mutex_);
+  pthread_cond_broadcast(&scheduler->cond_);
+  pthread_mutex_unlock(&scheduler->mutex_);
+}
+
+static int run_next_task(AVxScheduler *scheduler, int thread_id) {
+  if (aom_atomic_load_acquire(&scheduler->num_queued) == 0) return 0;
+
+  const int num_threads = scheduler->num_threads;
+  AVxTask task;
+  int found = queue_pop(&scheduler->queues[thread_id], &task, 1);
+  for (int i = 1; !found && i < num_threads; ++i) {
+    found = queue_pop(&scheduler->queues[(thread_id + i) % num_threads], &task,
+                      0);
+  }
+  if (!found) return 0;
+
+  aom_atomic_fetch_add(&scheduler->num_queued, -1);
+  if (run_task(&task)) wake_all(scheduler);
+  return 1;
+}
+
+// Waits until a task is queued or the scheduler is stopped. Returns false in
+// the latter case.
+static int wait_for_task(AVxScheduler *scheduler) {
+  for (int i = 0; i < SCHEDULER_SPIN_COUNT; ++i) {
+    if (aom_atomic_load_acquire(&scheduler->num_queued) > 0) return 1;
+    if (aom_atomic_load_acquire(&scheduler->stop)) return 0;
+    aom_atomic_spin_pause();
+  }
+
+  int has_task;
+  pthread_mutex_lock(&scheduler->mutex_);
+  while (!(has_task = aom_atomic_load_acquire(&scheduler->num_queued) > 0) &&
+         !aom_atomic_load_acquire(&scheduler->stop)) {
+    pthread_cond_wait(&scheduler->cond_, &scheduler->mutex_);
+  }
+  pthread_mutex_unlock(&scheduler->mutex_);
+  return has_task;
+}
+
+static int scheduler_worker_hook(void *arg1, void *arg2) {
+  AVxScheduler *const scheduler = (AVxScheduler *)arg1;
+  const int thread_id = (int)(intptr_t)arg2;
+
+  pthread_mutex_lock(&scheduler->mutex_);
+  ++scheduler->num_started;
+  pthread_cond_broadcast(&scheduler->cond_);
+  pthread_mutex_unlock(&scheduler->mutex_);
+
+  for (;;) {
+    if (run_next_task(scheduler, thread_id)) continue;
+    if (!wait_for_task(scheduler)) break;
+  }
+  return 1;
+}
+
+static void free_queues(AVxScheduler *scheduler) {
+  for (int i = 0; i < scheduler->alloc_threads; ++i) {
+    pthread_mutex_destroy(&scheduler->queues[i].mutex_);
+    aom_free(scheduler->queues[i].tasks);
+  }
+  aom_free(scheduler->queues);
+  aom_free(scheduler->worker_jobs);
+  scheduler->queues = NULL;
+  scheduler->worker_jobs = NULL;
+  scheduler->alloc_threads = 0;
+}
+
+static int alloc_queues(AVxScheduler *scheduler, int num_threads) {
+  if (scheduler->alloc_threads >= num_threads) return 1;
+
+  if (scheduler->alloc_threads == 0) {
+    if (pthread_mutex_init(&scheduler->mutex_, NULL)) return 0;
+    if (pthread_cond_init(&scheduler->cond_, NULL)) {
+      pthread_mutex_destroy(&scheduler->mutex_);
+      return 0;
+    }
+  } else {
+    free_queues(scheduler);
+  }
+
+  scheduler->queues =
+      (AVxTaskQueue *)aom_calloc(num_threads, sizeof(*scheduler->queues));
+  scheduler->worker_jobs =
+      (AVxTask *)aom_calloc(num_threads, sizeof(*scheduler->worker_jobs));
+  if (scheduler->queues == NULL || scheduler->worker_jobs == NULL) {
+    free_queues(scheduler);
+    pthread_mutex_destroy(&scheduler->mutex_);
+    pthread_cond_destroy(&scheduler->cond_);
+    return 0;
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    pthread_mutex_init(&scheduler->queues[i].mutex_, NULL);
+  }
+  scheduler->alloc_threads = num_threads;
+  return 1;
+}
+
+int aom_scheduler_start(AVxScheduler *scheduler, AVxWorker *workers,
+                        int num_threads) {
+  if (scheduler->running) {
+    if (scheduler->workers == workers && scheduler->num_threads == num_threads)
+      return 1;
+    aom_scheduler_stop(scheduler);
+  }
+  // The workers must run the scheduler on their own threads.
+  if (num_threads < 2 || !aom_is_default_worker_interface()) return 0;
+  for (int i = 1; i < num_threads; ++i) {
+    if (workers[i].status_ != AVX_WORKER_STATUS_OK) return 0;
+  }
+  if (!alloc_queues(scheduler, num_threads)) return 0;
+
+  scheduler->workers = workers;
+  scheduler->num_threads = num_threads;
+  scheduler->num_started = 0;
+  aom_atomic_init(&scheduler->num_queued, 0);
+  aom_atomic_init(&scheduler->stop, 0);
+
+  // The worker threads read their hook and data when they wake up. The jobs
+  // set up by the caller are restored once every thread has entered the
+  // scheduler.
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  for (int i = 1; i < num_threads; ++i) {
+    AVxWorker *const worker = &workers[i];
+    AVxTask *const job = &scheduler->worker_jobs[i];
+    job->hook = worker->hook;
+    job->data1 = worker->data1;
+    job->data2 = worker->data2;
+    worker->hook = scheduler_worker_hook;
+    worker->data1 = scheduler;
+    worker->data2 = (void *)(intptr_t)i;
+    winterface->launch(worker);
+  }
+
+  pthread_mutex_lock(&scheduler->mutex_);
+  while (scheduler->num_started < num_threads - 1) {
+    pthread_cond_wait(&scheduler->cond_, &scheduler->mutex_);
+  }
+  pthread_mutex_unlock(&scheduler->mutex_);
+
+  for (int i = 1; i < num_threads; ++i) {
+    AVxWorker *const worker = &workers[i];
+    const AVxTask *const job = &scheduler->worker_jobs[i];
+    worker->hook = job->hook;
+    worker->data1 = job->data1;
+    worker->data2 = job->data2;
+  }
+  scheduler->running = 1;
+  return 1;
+}
+
+int aom_scheduler_submit(AVxScheduler *scheduler, int thread_id,
+                         AVxTaskGroup *group, AVxWorkerHook hook, void *data1,
+                         void *data2, int *had_error) {
+  assert(scheduler->running);
+  assert(thread_id >= 0 && thread_id < scheduler->num_threads);
+  const AVxTask task = { hook, data1, data2, had_error, group };
+
+  aom_atomic_fetch_add(&group->pending, 1);
+  if (!queue_push(&scheduler->queues[thread_id], &task)) {
+    aom_atomic_fetch_add(&group->pending, -1);
+    return 0;
+  }
+  aom_atomic_fetch_add(&scheduler->num_queued, 1);
+  wake_all(scheduler);
+  return 1;
+}
+
+void aom_scheduler_wait(AVxScheduler *scheduler, AVxTaskGroup *group) {
+  while (aom_atomic_load_acquire(&group->pending) > 0) {
+    if (run_next_task(scheduler, 0)) continue;
+
+    int idle = 1;
+    for (int i = 0; i < SCHEDULER_SPIN_COUNT && idle; ++i) {
+      idle = aom_atomic_load_acquire(&group->pending) > 0 &&
+             aom_atomic_load_acquire(&scheduler->num_queued) == 0;
+      aom_atomic_spin_pause();
+    }
+    if (!idle) continue;
+
+    pthread_mutex_lock(&scheduler->mutex_);
+    while (aom_atomic_load_acquire(&group->pending) > 0 &&
+           aom_atomic_load_acquire(&scheduler->num_queued) == 0) {
+      pthread_cond_wait(&scheduler->cond_, &scheduler->mutex_);
+    }
+    pthread_mutex_unlock(&scheduler->mutex_);
+  }
+}
+
+void aom_scheduler_stop(AVxScheduler *scheduler) {
+  if (!scheduler->running) return;
+
+  pthread_mutex_lock(&scheduler->mutex_);
+  aom_atomic_store_release(&scheduler->stop, 1);
+  pthread_cond_broadcast(&scheduler->cond_);
+  pthread_mutex_unlock(&scheduler->mutex_);
+
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  for (int i = 1; i < scheduler->num_threads; ++i) {
+    winterface->sync(&scheduler->workers[i]);
+  }
+  scheduler->running = 0;
+}
+
+void aom_scheduler_dealloc(AVxScheduler *scheduler) {
+  aom_scheduler_stop(scheduler);
+  if (scheduler->alloc_threads > 0) {
+    free_queues(scheduler);
+    pthread_mutex_destroy(&scheduler->mutex_);
+    pthread_cond_destroy(&scheduler->cond_);
+  }
+  memset(scheduler, 0, sizeof(*scheduler));
+}
+
+#else  // !CONFIG_MULTITHREAD
+
+int aom_scheduler_start(AVxScheduler *scheduler, AVxWorker *workers,
+                        int num_threads) {
+  (void)scheduler;
+  (void)workers;
+  (void)num_threads;
+  return 0;
+}
+
+// Without threads, tasks run as soon as they are submitted.
+int aom_scheduler_submit(AVxScheduler *scheduler, int thread_id,
+                         AVxTaskGroup *group, AVxWorkerHook hook, void *data1,
+                         void *data2, int *had_error) {
+  (void)scheduler;
+  (void)thread_id;
+  const AVxTask task = { hook, data1, data2, had_error, group };
+  aom_atomic_fetch_add(&group->pending, 1);
+  run_task(&task);
+  return 1;
+}
+
+void aom_scheduler_wait(AVxScheduler *scheduler, AVxTaskGroup *group) {
+  (void)scheduler;
+  assert(aom_atomic_load_acquire(&group->pending) == 0);
+  (void)group;
+}
+
+void aom_scheduler_stop(AVxScheduler *scheduler) { (void)scheduler; }
+
+void aom_scheduler_dealloc(AVxScheduler *scheduler) {
+  memset(scheduler, 0, sizeof(*scheduler));
+}
+
+#endif  // CONFIG_MULTITHREAD
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+//
+// Work-stealing task scheduler
+//
+// The scheduler runs tasks on a set of AVxWorkers. Once started, the workers
+// stay in the scheduler until it is stopped, so a series of task batches only
+// wakes them up once. Each thread has its own task queue. A thread takes the
+// newest task of its own queue first and, when that is empty, steals the
+// oldest task of another thread's queue. Tasks are joined through task groups,
+// which count the tasks that have not finished yet.
+//
+// Thread 0 is the thread that calls aom_scheduler_start(); it runs tasks while
+// it waits for a group. Threads 1 to num_threads - 1 run on workers[1] to
+// workers[num_threads - 1]. While the scheduler runs, these workers must not
+// be launched, synced or reset through the AVxWorkerInterface.
+
+#ifndef AOM_AOM_UTIL_AOM_SCHEDULER_H_
+#define AOM_AOM_UTIL_AOM_SCHEDULER_H_
+
+#include "config/aom_config.h"
+
+#include "aom_util/aom_atomics.h"
+#include "aom_util/aom_pthread.h"
+#include "aom_util/aom_thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tasks that have been submitted to the scheduler and have not finished yet.
+typedef struct AVxTaskGroup {
+  aom_atomic_int pending;
+} AVxTaskGroup;
+
+typedef struct AVxTask {
+  AVxWorkerHook hook;
+  void *data1;
+  void *data2;
+  // Set to 1 if hook returns false. May be NULL.
+  int *had_error;
+  AVxTaskGroup *group;
+} AVxTask;
+
+// Ring buffer of the tasks queued on a thread.
+typedef struct AVxTaskQueue {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex_;
+#endif
+  AVxTask *tasks;
+  int size;
+  int head;
+  int count;
+} AVxTaskQueue;
+
+typedef struct AVxScheduler {
+  AVxWorker *workers;
+  int num_threads;
+  // Number of task queues allocated.
+  int alloc_threads;
+  AVxTaskQueue *queues;
+  // Hooks and data of the workers saved while they enter the scheduler.
+  AVxTask *worker_jobs;
+  // Number of tasks in all the queues.
+  aom_atomic_int num_queued;
+  aom_atomic_int stop;
+  // Number of workers that have entered the scheduler since it was started.
+  int num_started;
+  int running;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex_;
+  pthread_cond_t cond_;
+#endif
+} AVxScheduler;
+
+void aom_scheduler_group_init(AVxTaskGroup *group);
+
+// Starts running tasks on workers[1] to workers[num_threads - 1]. Does nothing
+// if the scheduler is already running on the same workers. Returns false if
+// the scheduler could not be started, in which case the workers are left
+// untouched. This function is not thread-safe.
+int aom_scheduler_start(AVxScheduler *scheduler, AVxWorker *workers,
+                        int num_threads);
+
+// Queues a task on the given thread of a running scheduler. Returns false in
+// case of allocation failure, in which case the task is not run.
+int aom_scheduler_submit(AVxScheduler *scheduler, int thread_id,
+                         AVxTaskGroup *group, AVxWorkerHook hook, void *data1,
+                         void *data2, int *had_error);
+
+// Runs tasks on the calling thread, which must be thread 0, until all the
+// tasks of the group have finished.
+void aom_scheduler_wait(AVxScheduler *scheduler, AVxTaskGroup *group);
+
+// Returns the workers to the caller once the queued tasks are done. Does
+// nothing if the scheduler is not running.
+void aom_scheduler_stop(AVxScheduler *scheduler);
+
+// Stops the scheduler and frees its queues.
+void aom_scheduler_dealloc(AVxScheduler *scheduler);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AOM_UTIL_AOM_SCHEDULER_H_
@@ -243,4 +243,9 @@ const AVxWorkerInterface *aom_get_worker_interface(void) {
   return &g_worker_interface;
 }
 
+int aom_is_default_worker_interface(void) {
+  return g_worker_interface.launch == launch &&
+         g_worker_interface.sync == sync;
+}
+
 //------------------------------------------------------------------------------
@@ -85,6 +85,10 @@ int aom_set_worker_interface(const AVxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const AVxWorkerInterface *aom_get_worker_interface(void);
 
+// Returns true if the default thread worker interface is in use, in which case
+// launch() runs the hook on the worker's own thread.
+int aom_is_default_worker_interface(void);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
@@ -105,15 +105,18 @@ static const arg_def_t outallarg = ARG_DEF(
     NULL, "all-layers", 0, "Output all decoded frames of a scalable bitstream");
 static const arg_def_t skipfilmgrain =
     ARG_DEF(NULL, "skip-film-grain", 0, "Skip film grain application");
+static const arg_def_t extrefbordersarg =
+    ARG_DEF(NULL, "extend-ref-borders", 1,
+            "Extend the borders of the reference frames, default: 0");
 
 static const arg_def_t *all_args[] = {
-  &help,           &codecarg, &use_yv12,      &use_i420,
-  &flipuvarg,      &rawvideo, &noblitarg,     &progressarg,
-  &limitarg,       &skiparg,  &summaryarg,    &outputfile,
-  &threadsarg,     &rowmtarg, &verbosearg,    &scalearg,
-  &fb_arg,         &md5arg,   &framestatsarg, &continuearg,
-  &outbitdeptharg, &isannexb, &oppointarg,    &outallarg,
-  &skipfilmgrain,  NULL
+  &help,           &codecarg,         &use_yv12,      &use_i420,
+  &flipuvarg,      &rawvideo,         &noblitarg,     &progressarg,
+  &limitarg,       &skiparg,          &summaryarg,    &outputfile,
+  &threadsarg,     &rowmtarg,         &verbosearg,    &scalearg,
+  &fb_arg,         &md5arg,           &framestatsarg, &continuearg,
+  &outbitdeptharg, &isannexb,         &oppointarg,    &outallarg,
+  &skipfilmgrain,  &extrefbordersarg, NULL
 };
 
 #if CONFIG_LIBYUV
@@ -472,6 +475,7 @@ static int main_loop(int argc, const char **argv_) {
   int output_all_layers = 0;
   int skip_film_grain = 0;
   int enable_row_mt = 0;
+  int extend_ref_borders = 0;
   aom_image_t *scaled_img = NULL;
   aom_image_t *img_shifted = NULL;
   int frame_avail, got_data, flush_decoder = 0;
@@ -593,6 +597,8 @@ static int main_loop(int argc, const char **argv_) {
       output_all_layers = 1;
     } else if (arg_match(&arg, &skipfilmgrain, argi)) {
       skip_film_grain = 1;
+    } else if (arg_match(&arg, &extrefbordersarg, argi)) {
+      extend_ref_borders = arg_parse_uint(&arg);
     } else {
       argj++;
     }
@@ -748,6 +754,13 @@ static int main_loop(int argc, const char **argv_) {
     goto fail;
   }
 
+  if (AOM_CODEC_CONTROL_TYPECHECKED(&decoder, AV1D_SET_EXTEND_REF_BORDERS,
+                                    extend_ref_borders)) {
+    fprintf(stderr, "Failed to set extend_ref_borders: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
   if (arg_skip) fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
   while (arg_skip) {
     if (read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) break;
@@ -104,11 +104,20 @@ list(APPEND AOM_AV1_DECODER_SOURCES
             "${AOM_ROOT}/av1/decoder/decodetxb.h"
             "${AOM_ROOT}/av1/decoder/detokenize.c"
             "${AOM_ROOT}/av1/decoder/detokenize.h"
+            "${AOM_ROOT}/av1/decoder/dthread.c"
             "${AOM_ROOT}/av1/decoder/dthread.h"
             "${AOM_ROOT}/av1/decoder/grain_synthesis.c"
             "${AOM_ROOT}/av1/decoder/grain_synthesis.h"
             "${AOM_ROOT}/av1/decoder/obu.h"
-            "${AOM_ROOT}/av1/decoder/obu.c")
+            "${AOM_ROOT}/av1/decoder/obu.c"
+            "${AOM_ROOT}/av1/decoder/tile_cache.c"
+            "${AOM_ROOT}/av1/decoder/tile_cache.h")
+
+list(APPEND AOM_AV1_DECODER_INTRIN_SSE4_1
+            "${AOM_ROOT}/av1/decoder/x86/grain_synthesis_sse4.c")
+
+list(APPEND AOM_AV1_DECODER_INTRIN_AVX2
+            "${AOM_ROOT}/av1/decoder/x86/grain_synthesis_avx2.c")
 
 list(APPEND AOM_AV1_ENCODER_SOURCES
             "${AOM_ROOT}/av1/av1_cx_iface.c"
@@ -357,6 +366,9 @@ list(APPEND AOM_AV1_ENCODER_INTRIN_AVX2
             "${AOM_ROOT}/av1/encoder/x86/temporal_filter_avx2.c"
             "${AOM_ROOT}/av1/encoder/x86/pickrst_avx2.c")
 
+list(APPEND AOM_AV1_ENCODER_INTRIN_AVX512
+            "${AOM_ROOT}/av1/encoder/x86/error_intrin_avx512.c")
+
 # The functions defined in these files are removed from rtcd when
 # CONFIG_EXCLUDE_SIMD_MISMATCH=1.
 if(NOT CONFIG_EXCLUDE_SIMD_MISMATCH)
@@ -735,6 +747,13 @@ function(setup_av1_targets)
     add_intrinsics_object_library("-msse4.1" "sse4" "aom_av1_common"
                                   "AOM_AV1_COMMON_INTRIN_SSE4_1")
 
+    if(CONFIG_AV1_DECODER)
+      if(AOM_AV1_DECODER_INTRIN_SSE4_1)
+        add_intrinsics_object_library("-msse4.1" "sse4" "aom_av1_decoder"
+                                      "AOM_AV1_DECODER_INTRIN_SSE4_1")
+      endif()
+    endif()
+
     if(CONFIG_AV1_ENCODER)
       if("${AOM_TARGET_CPU}" STREQUAL "x86_64")
         add_asm_library("aom_av1_encoder_ssse3"
@@ -763,12 +782,27 @@ function(setup_av1_targets)
     add_intrinsics_object_library("-mavx2" "avx2" "aom_av1_common"
                                   "AOM_AV1_COMMON_INTRIN_AVX2")
 
+    if(CONFIG_AV1_DECODER)
+      if(AOM_AV1_DECODER_INTRIN_AVX2)
+        add_intrinsics_object_library("-mavx2" "avx2" "aom_av1_decoder"
+                                      "AOM_AV1_DECODER_INTRIN_AVX2")
+      endif()
+    endif()
+
     if(CONFIG_AV1_ENCODER)
       add_intrinsics_object_library("-mavx2" "avx2" "aom_av1_encoder"
                                     "AOM_AV1_ENCODER_INTRIN_AVX2")
     endif()
   endif()
 
+  if(HAVE_AVX512)
+    if(CONFIG_AV1_ENCODER)
+      add_intrinsics_object_library("${AOM_AVX512_FLAGS}" "avx512"
+                                    "aom_av1_encoder"
+                                    "AOM_AV1_ENCODER_INTRIN_AVX512")
+    endif()
+  endif()
+
   if(HAVE_NEON)
     add_intrinsics_object_library("${AOM_NEON_INTRIN_FLAG}" "neon"
                                   "aom_av1_common" "AOM_AV1_COMMON_INTRIN_NEON")
@@ -544,6 +544,8 @@ struct aom_codec_alg_priv {
   int num_lap_buffers;
   STATS_BUFFER_CTX stats_buf_context;
   bool monochrome_on_init;
+  // Release callback of the source images lent to the encoder.
+  aom_source_lending_t source_lending;
 };
 
 static inline int gcd(int64_t a, int b) {
@@ -3061,32 +3063,36 @@ static aom_codec_frame_flags_t get_frame_pkt_flags(const AV1_COMP *cpi,
   return flags;
 }
 
-static inline int get_src_border_in_pixels(AV1_COMP *cpi, BLOCK_SIZE sb_size) {
-  if (cpi->oxcf.mode != REALTIME || av1_is_resize_needed(&cpi->oxcf))
-    return cpi->oxcf.border_in_pixels;
+static inline int get_src_border_in_pixels(const AV1EncoderConfig *oxcf,
+                                           BLOCK_SIZE sb_size) {
+  if (oxcf->mode != REALTIME || av1_is_resize_needed(oxcf))
+    return oxcf->border_in_pixels;
 
   const int sb_size_in_pixels_log2 = mi_size_wide_log2[sb_size] + MI_SIZE_LOG2;
   const int sb_aligned_width =
-      ALIGN_POWER_OF_TWO(cpi->oxcf.frm_dim_cfg.width, sb_size_in_pixels_log2);
+      ALIGN_POWER_OF_TWO(oxcf->frm_dim_cfg.width, sb_size_in_pixels_log2);
   const int sb_aligned_height =
-      ALIGN_POWER_OF_TWO(cpi->oxcf.frm_dim_cfg.height, sb_size_in_pixels_log2);
+      ALIGN_POWER_OF_TWO(oxcf->frm_dim_cfg.height, sb_size_in_pixels_log2);
   // Align the border pixels to a multiple of 32.
   const int border_pixels_width =
-      ALIGN_POWER_OF_TWO(sb_aligned_width - cpi->oxcf.frm_dim_cfg.width, 5);
+      ALIGN_POWER_OF_TWO(sb_aligned_width - oxcf->frm_dim_cfg.width, 5);
   const int border_pixels_height =
-      ALIGN_POWER_OF_TWO(sb_aligned_height - cpi->oxcf.frm_dim_cfg.height, 5);
+      ALIGN_POWER_OF_TWO(sb_aligned_height - oxcf->frm_dim_cfg.height, 5);
   const int border_in_pixels =
       AOMMAX(AOMMAX(border_pixels_width, border_pixels_height), 32);
   return border_in_pixels;
 }
 
+// Encodes img. *lent is cleared once the ownership of a lent img has been
+// handed to the lookahead.
 // TODO(Mufaddal): Check feasibility of abstracting functions related to LAP
 // into a separate function.
-static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
-                                      const aom_image_t *img,
-                                      aom_codec_pts_t pts,
-                                      unsigned long duration,
-                                      aom_enc_frame_flags_t enc_flags) {
+static aom_codec_err_t encode_lent_img(aom_codec_alg_priv_t *ctx,
+                                       const aom_image_t *img,
+                                       aom_codec_pts_t pts,
+                                       unsigned long duration,
+                                       aom_enc_frame_flags_t enc_flags,
+                                       bool *lent) {
   const size_t kMinCompressedSize = 8192;
   volatile aom_codec_err_t res = AOM_CODEC_OK;
   AV1_PRIMARY *const ppi = ctx->ppi;
@@ -3099,6 +3105,12 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
   AV1_COMP *cpi_lap = ppi->cpi_lap;
   if (ppi->cpi == NULL) return AOM_CODEC_INVALID_PARAM;
 
+  // AV1E_GET_FRAME_STAGE_TIMINGS reports the stages run by this call.
+  for (int i = 0; i < MAX_PARALLEL_FRAMES; i++) {
+    AV1_COMP *const parallel_cpi = ppi->parallel_cpi[i];
+    if (parallel_cpi != NULL) av1_zero(parallel_cpi->stage_time);
+  }
+
   ppi->cpi->last_coded_width = ppi->cpi->oxcf.frm_dim_cfg.width;
   ppi->cpi->last_coded_height = ppi->cpi->oxcf.frm_dim_cfg.height;
 
@@ -3273,7 +3285,8 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
           ppi->parallel_cpi[i]->oxcf.border_in_pixels = oxcf->border_in_pixels;
         }
 
-        const int src_border_in_pixels = get_src_border_in_pixels(cpi, sb_size);
+        const int src_border_in_pixels =
+            get_src_border_in_pixels(&cpi->oxcf, sb_size);
         ppi->lookahead = av1_lookahead_init(
             cpi->oxcf.frm_dim_cfg.width, cpi->oxcf.frm_dim_cfg.height,
             subsampling_x, subsampling_y, use_highbitdepth, lag_in_frames,
@@ -3304,8 +3317,14 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
 
       // Store the original flags in to the frame buffer. Will extract the
       // key frame flag when we actually encode this frame.
+      // The lookahead releases the lent image from here on.
+      *lent = false;
       if (av1_receive_raw_frame(cpi, flags | ctx->next_frame_flags, &sd,
-                                src_time_stamp, src_end_time_stamp)) {
+                                src_time_stamp, src_end_time_stamp,
+                                ctx->source_lending.release_cb
+                                    ? &ctx->source_lending
+                                    : NULL,
+                                img)) {
         res = update_error_state(ctx, cpi->common.error);
       }
       ctx->next_frame_flags = 0;
@@ -3616,11 +3635,77 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
   return res;
 }
 
+static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
+                                      const aom_image_t *img,
+                                      aom_codec_pts_t pts,
+                                      unsigned long duration,
+                                      aom_enc_frame_flags_t enc_flags) {
+  bool lent = img != NULL && ctx->source_lending.release_cb != NULL;
+  const aom_codec_err_t res =
+      encode_lent_img(ctx, img, pts, duration, enc_flags, &lent);
+  // The image was rejected before reaching the lookahead.
+  if (lent) ctx->source_lending.release_cb(ctx->source_lending.cb_priv, img);
+  return res;
+}
+
 static const aom_codec_cx_pkt_t *encoder_get_cxdata(aom_codec_alg_priv_t *ctx,
                                                     aom_codec_iter_t *iter) {
   return aom_codec_pkt_list_get(&ctx->pkt_list.head, iter);
 }
 
+static aom_codec_err_t ctrl_set_source_lending(aom_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  aom_source_lending_t *lending = CAST(AV1E_SET_SOURCE_LENDING, args);
+  if (lending == NULL || lending->release_cb == NULL) {
+    memset(&ctx->source_lending, 0, sizeof(ctx->source_lending));
+    return AOM_CODEC_OK;
+  }
+
+  // Report the border of the lookahead buffers, as allocated by
+  // encoder_encode() for the current configuration.
+  const AV1_PRIMARY *const ppi = ctx->ppi;
+  if (ppi->lookahead != NULL) {
+    lending->border = ppi->lookahead->buf[0].img.border;
+  } else {
+    AV1EncoderConfig oxcf = ppi->cpi->oxcf;
+    const BLOCK_SIZE sb_size =
+        av1_select_sb_size(&oxcf, oxcf.frm_dim_cfg.width,
+                           oxcf.frm_dim_cfg.height, ppi->number_spatial_layers);
+    oxcf.border_in_pixels = av1_get_enc_border_size(
+        av1_is_resize_needed(&oxcf), oxcf.kf_cfg.key_freq_max == 0, sb_size);
+    lending->border = get_src_border_in_pixels(&oxcf, sb_size);
+  }
+  ctx->source_lending = *lending;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_frame_stage_timings(aom_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  aom_enc_stage_timings_t *const timings =
+      va_arg(args, aom_enc_stage_timings_t *);
+  if (timings == NULL) return AOM_CODEC_INVALID_PARAM;
+
+  int64_t stage_time[kNumEncStages] = { 0 };
+  for (int i = 0; i < MAX_PARALLEL_FRAMES; i++) {
+    const AV1_COMP *const cpi = ctx->ppi->parallel_cpi[i];
+    if (cpi == NULL) continue;
+    for (int stage = 0; stage < kNumEncStages; stage++) {
+      stage_time[stage] += cpi->stage_time[stage];
+    }
+  }
+  timings->temporal_filter = stage_time[kStageTemporalFilter];
+  timings->tpl = stage_time[kStageTpl];
+  timings->encode_frame = stage_time[kStageEncodeFrame];
+  timings->loop_filter_pick = stage_time[kStageLoopFilterPick];
+  timings->loop_filter_apply = stage_time[kStageLoopFilterApply];
+  timings->cdef_pick = stage_time[kStageCdefPick];
+  timings->cdef_apply = stage_time[kStageCdefApply];
+  timings->loop_restoration_pick = stage_time[kStageRestorationPick];
+  timings->loop_restoration_apply = stage_time[kStageRestorationApply];
+  timings->pack_bitstream = stage_time[kStagePackBitstream];
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_set_reference(aom_codec_alg_priv_t *ctx,
                                           va_list args) {
   av1_ref_frame_t *const frame = va_arg(args, av1_ref_frame_t *);
@@ -4704,6 +4789,7 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_SET_MAX_CONSEC_FRAME_DROP_CBR, ctrl_set_max_consec_frame_drop_cbr },
   { AV1E_SET_SVC_FRAME_DROP_MODE, ctrl_set_svc_frame_drop_mode },
   { AV1E_SET_AUTO_TILES, ctrl_set_auto_tiles },
+  { AV1E_SET_SOURCE_LENDING, ctrl_set_source_lending },
   { AV1E_SET_POSTENCODE_DROP_RTC, ctrl_set_postencode_drop_rtc },
   { AV1E_SET_MAX_CONSEC_FRAME_DROP_MS_CBR,
     ctrl_set_max_consec_frame_drop_ms_cbr },
@@ -4725,6 +4811,7 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_GET_LUMA_CDEF_STRENGTH, ctrl_get_luma_cdef_strength },
   { AV1E_GET_HIGH_MOTION_CONTENT_SCREEN_RTC,
     ctrl_get_high_motion_content_screen_rtc },
+  { AV1E_GET_FRAME_STAGE_TIMINGS, ctrl_get_frame_stage_timings },
 
   CTRL_MAP_END,
 };
@@ -53,12 +53,14 @@ struct aom_codec_alg_priv {
   int byte_alignment;
   int skip_loop_filter;
   int skip_film_grain;
+  int extend_ref_borders;
   int decode_tile_row;
   int decode_tile_col;
   unsigned int tile_mode;
   unsigned int ext_tile_debug;
   unsigned int row_mt;
   EXTERNAL_REFERENCES ext_refs;
+  unsigned int tile_cache_size;
   unsigned int is_annexb;
   int operating_point;
   int output_all_layers;
@@ -81,6 +83,8 @@ struct aom_codec_alg_priv {
   aom_inspect_cb inspect_cb;
   void *inspect_ctx;
 #endif
+  aom_row_output_cb_fn_t row_output_cb;
+  void *row_output_cb_priv;
 };
 
 static aom_codec_err_t decoder_init(aom_codec_ctx_t *ctx) {
@@ -143,6 +147,7 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
     av1_free_ref_frame_buffers(ctx->buffer_pool);
     av1_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
 #if CONFIG_MULTITHREAD
+    pthread_cond_destroy(&ctx->buffer_pool->progress_cond);
     pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
 #endif
   }
@@ -390,6 +395,8 @@ static void init_buffer_callbacks(aom_codec_alg_priv_t *ctx) {
   cm->features.byte_alignment = ctx->byte_alignment;
   pbi->skip_loop_filter = ctx->skip_loop_filter;
   pbi->skip_film_grain = ctx->skip_film_grain;
+  pbi->extend_ref_borders = ctx->extend_ref_borders;
+  av1_tile_cache_set_budget(&pbi->tile_cache, ctx->tile_cache_size);
 
   if (ctx->get_ext_fb_cb != NULL && ctx->release_ext_fb_cb != NULL) {
     pool->get_fb_cb = ctx->get_ext_fb_cb;
@@ -452,6 +459,16 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
     set_error_detail(ctx, "Failed to allocate buffer pool mutex");
     return AOM_CODEC_MEM_ERROR;
   }
+  if (pthread_cond_init(&ctx->buffer_pool->progress_cond, NULL)) {
+    pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
+    aom_free(ctx->buffer_pool->frame_bufs);
+    ctx->buffer_pool->frame_bufs = NULL;
+    ctx->buffer_pool->num_frame_bufs = 0;
+    aom_free(ctx->buffer_pool);
+    ctx->buffer_pool = NULL;
+    set_error_detail(ctx, "Failed to allocate buffer pool condition variable");
+    return AOM_CODEC_MEM_ERROR;
+  }
 #endif
 
   ctx->frame_worker = (AVxWorker *)aom_malloc(sizeof(*ctx->frame_worker));
@@ -514,6 +531,21 @@ static inline void check_resync(aom_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
+// Wraps the rows of the frame being decoded in an image for the row output
+// callback of the application.
+static void decoder_row_output(void *priv, const RefCntBuffer *frame,
+                               int rows_done) {
+  aom_codec_alg_priv_t *const ctx = (aom_codec_alg_priv_t *)priv;
+  const FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_worker->data1;
+  aom_image_t img;
+  yuvconfig2image(&img, &frame->buf, frame_worker_data->user_priv);
+  img.fb_priv = frame->raw_frame_buffer.priv;
+  img.temporal_id = frame->temporal_id;
+  img.spatial_id = frame->spatial_id;
+  ctx->row_output_cb(ctx->row_output_cb_priv, &img, (unsigned int)rows_done);
+}
+
 static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
                                   const uint8_t **data, size_t data_sz,
                                   void *user_priv) {
@@ -545,6 +577,9 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
   frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
   frame_worker_data->pbi->row_mt = ctx->row_mt;
   frame_worker_data->pbi->ext_refs = ctx->ext_refs;
+  frame_worker_data->pbi->row_output_cb =
+      ctx->row_output_cb != NULL ? decoder_row_output : NULL;
+  frame_worker_data->pbi->row_output_priv = ctx;
 
   frame_worker_data->pbi->is_annexb = ctx->is_annexb;
 
@@ -701,6 +736,9 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
     res = init_decoder(ctx);
     if (res != AOM_CODEC_OK) return res;
   }
+  FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_worker->data1;
+  av1_zero(frame_worker_data->pbi->stage_time);
 
   const uint8_t *data_start = data;
   const uint8_t *data_end = data + data_sz;
@@ -764,9 +802,10 @@ static void *AllocWithGetFrameBufferCb(void *priv, size_t size) {
 }
 
 // If grain_params->apply_grain is false, returns img. Otherwise, adds film
-// grain to img, saves the result in grain_img, and returns grain_img.
+// grain to img, saves the result in grain_img, and returns grain_img. The
+// decoder's tile workers, idle once the frame is decoded, share the work.
 static aom_image_t *add_grain_if_needed(aom_codec_alg_priv_t *ctx,
-                                        aom_image_t *img,
+                                        AV1Decoder *pbi, aom_image_t *img,
                                         aom_image_t *grain_img,
                                         aom_film_grain_t *grain_params) {
   if (!grain_params->apply_grain) return img;
@@ -787,7 +826,11 @@ static aom_image_t *add_grain_if_needed(aom_codec_alg_priv_t *ctx,
 
   grain_img->user_priv = img->user_priv;
   grain_img->fb_priv = fb->priv;
-  if (av1_add_film_grain(grain_params, img, grain_img)) {
+  dec_start_stage_timing(pbi, kDecStageFilmGrain);
+  const int grain_error = av1_add_film_grain_mt(
+      grain_params, img, grain_img, pbi->tile_workers, pbi->num_workers);
+  dec_end_stage_timing(pbi, kDecStageFilmGrain);
+  if (grain_error) {
     pool->release_fb_cb(pool->cb_priv, fb);
     return NULL;
   }
@@ -912,7 +955,7 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
   img->spatial_id = output_frame_buf->spatial_id;
   if (pbi->skip_film_grain) grain_params->apply_grain = 0;
   aom_image_t *res =
-      add_grain_if_needed(ctx, img, &ctx->image_with_grain, grain_params);
+      add_grain_if_needed(ctx, pbi, img, &ctx->image_with_grain, grain_params);
   if (!res) {
     pbi->error.error_code = AOM_CODEC_CORRUPT_FRAME;
     pbi->error.has_detail = 1;
@@ -1339,6 +1382,13 @@ static aom_codec_err_t ctrl_set_ext_ref_ptr(aom_codec_alg_priv_t *ctx,
     for (int i = 0; i < ctx->ext_refs.num; i++) {
       image2yuvconfig(ext_frames->img++, &ctx->ext_refs.refs[i]);
     }
+    if (ctx->frame_worker) {
+      AVxWorker *const worker = ctx->frame_worker;
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)worker->data1;
+      // The cached tiles may be predicted from the old references.
+      av1_tile_cache_reset(&frame_worker_data->pbi->tile_cache);
+    }
     return AOM_CODEC_OK;
   } else {
     return AOM_CODEC_INVALID_PARAM;
@@ -1578,6 +1628,74 @@ static aom_codec_err_t ctrl_set_skip_film_grain(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_extend_ref_borders(aom_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  ctx->extend_ref_borders = va_arg(args, int);
+
+  if (ctx->frame_worker) {
+    AVxWorker *const worker = ctx->frame_worker;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->pbi->extend_ref_borders = ctx->extend_ref_borders;
+  }
+
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_tile_cache_size(aom_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  ctx->tile_cache_size = va_arg(args, unsigned int);
+
+  if (ctx->frame_worker) {
+    AVxWorker *const worker = ctx->frame_worker;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    av1_tile_cache_set_budget(&frame_worker_data->pbi->tile_cache,
+                              ctx->tile_cache_size);
+  }
+
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_frame_stage_timings(aom_codec_alg_priv_t *ctx,
+                                                    va_list args) {
+  aom_dec_stage_timings_t *const timings =
+      va_arg(args, aom_dec_stage_timings_t *);
+  if (timings == NULL) return AOM_CODEC_INVALID_PARAM;
+
+  AVxWorker *const worker = ctx->frame_worker;
+  if (worker == NULL) return AOM_CODEC_ERROR;
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  const int64_t *const stage_time = frame_worker_data->pbi->stage_time;
+  timings->frame_header = stage_time[kDecStageFrameHeader];
+  timings->decode_tiles = stage_time[kDecStageDecodeTiles];
+  timings->loop_filter = stage_time[kDecStageLoopFilter];
+  timings->cdef = stage_time[kDecStageCdef];
+  timings->superres = stage_time[kDecStageSuperres];
+  timings->loop_restoration = stage_time[kDecStageRestoration];
+  timings->film_grain = stage_time[kDecStageFilmGrain];
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_tile_cache_stats(aom_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  av1_tile_cache_stats_t *const stats = va_arg(args, av1_tile_cache_stats_t *);
+
+  if (stats) {
+    AVxWorker *const worker = ctx->frame_worker;
+    if (worker) {
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)worker->data1;
+      const TileCache *const tile_cache = &frame_worker_data->pbi->tile_cache;
+      stats->hits = tile_cache->hits;
+      stats->misses = tile_cache->misses;
+      stats->bytes = tile_cache->bytes;
+      return AOM_CODEC_OK;
+    } else {
+      return AOM_CODEC_ERROR;
+    }
+  }
+  return AOM_CODEC_INVALID_PARAM;
+}
+
 static aom_codec_err_t ctrl_get_accounting(aom_codec_alg_priv_t *ctx,
                                            va_list args) {
 #if !CONFIG_ACCOUNTING
@@ -1654,6 +1772,15 @@ static aom_codec_err_t ctrl_set_inspection_callback(aom_codec_alg_priv_t *ctx,
 #endif
 }
 
+static aom_codec_err_t ctrl_set_row_output_callback(
+    aom_codec_alg_priv_t *ctx, va_list args) {
+  const aom_row_output_cb_init *init = va_arg(args, aom_row_output_cb_init *);
+  if (init == NULL) return AOM_CODEC_INVALID_PARAM;
+  ctx->row_output_cb = init->row_output_cb;
+  ctx->row_output_cb_priv = init->cb_priv;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t ctrl_ext_tile_debug(aom_codec_alg_priv_t *ctx,
                                            va_list args) {
   ctx->ext_tile_debug = va_arg(args, int);
@@ -1685,6 +1812,9 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1D_SET_ROW_MT, ctrl_set_row_mt },
   { AV1D_SET_EXT_REF_PTR, ctrl_set_ext_ref_ptr },
   { AV1D_SET_SKIP_FILM_GRAIN, ctrl_set_skip_film_grain },
+  { AV1D_SET_ROW_OUTPUT_CALLBACK, ctrl_set_row_output_callback },
+  { AV1D_SET_EXTEND_REF_BORDERS, ctrl_set_extend_ref_borders },
+  { AV1D_SET_TILE_CACHE_SIZE, ctrl_set_tile_cache_size },
 
   // Getters
   { AOMD_GET_FRAME_CORRUPTED, ctrl_get_frame_corrupted },
@@ -1694,6 +1824,8 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1D_GET_IMG_FORMAT, ctrl_get_img_format },
   { AV1D_GET_TILE_SIZE, ctrl_get_tile_size },
   { AV1D_GET_TILE_COUNT, ctrl_get_tile_count },
+  { AV1D_GET_TILE_CACHE_STATS, ctrl_get_tile_cache_stats },
+  { AV1D_GET_FRAME_STAGE_TIMINGS, ctrl_get_frame_stage_timings },
   { AV1D_GET_DISPLAY_SIZE, ctrl_get_render_size },
   { AV1D_GET_FRAME_SIZE, ctrl_get_frame_size },
   { AV1_GET_ACCOUNTING, ctrl_get_accounting },
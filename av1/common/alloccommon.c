@@ -362,8 +362,6 @@ void av1_free_restoration_buffers(AV1_COMMON *cm) {
     boundaries->stripe_boundary_above = NULL;
     boundaries->stripe_boundary_below = NULL;
   }
-
-  aom_free_frame_buffer(&cm->rst_frame);
 }
 #endif  // !CONFIG_REALTIME_ONLY || CONFIG_AV1_DECODER
 
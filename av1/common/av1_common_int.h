@@ -169,6 +169,16 @@ typedef struct RefCntBuffer {
   int8_t mode_deltas[MAX_MODE_LF_DELTAS];
 
   FRAME_CONTEXT frame_context;
+
+  // Decoder only: number of superblock rows of this frame that are fully
+  // reconstructed and filtered, and so may be used for prediction by other
+  // frames. Set to INT_MAX once the frame is complete (or abandoned on error).
+  // Protected by BufferPool::pool_mutex. See av1_frameworker_broadcast() and
+  // av1_frameworker_wait().
+  int sb_rows_done;
+  // Decoder only: true if the borders of buf are extended from the final
+  // pixels of the frame. Reset whenever the buffer holds a new frame.
+  int border_extended;
 } RefCntBuffer;
 
 typedef struct BufferPool {
@@ -179,6 +189,8 @@ typedef struct BufferPool {
 // https://chromium-review.googlesource.com/c/webm/libvpx/+/560630.
 #if CONFIG_MULTITHREAD
   pthread_mutex_t pool_mutex;
+  // Decoder only: signalled whenever RefCntBuffer::sb_rows_done advances.
+  pthread_cond_t progress_cond;
 #endif
 
   // Private data associated with the frame buffer callbacks.
@@ -953,7 +965,6 @@ typedef struct AV1Common {
   RestorationInfo rst_info[MAX_MB_PLANE]; /*!< Loop Restoration filter info */
   int32_t *rst_tmpbuf; /*!< Scratch buffer for self-guided restoration */
   RestorationLineBuffers *rlbs; /*!< Line buffers needed by loop restoration */
-  YV12_BUFFER_CONFIG rst_frame; /*!< Stores the output of loop restoration */
   /**@}*/
 
   /*!
@@ -116,6 +116,12 @@ if ((aom_config("CONFIG_REALTIME_ONLY") ne "yes") || (aom_config("CONFIG_AV1_DEC
   specialize qw/av1_wiener_convolve_add_src sse2 avx2 neon/;
 }
 
+# Film grain synthesis
+if (aom_config("CONFIG_AV1_DECODER") eq "yes") {
+  add_proto qw/void av1_add_film_grain_row/, "uint8_t *pix, const uint8_t *luma, const int *grain, int width, int luma_subsamp_x, const int *scaling_lut, int mult, int luma_mult, int offset, int scaling_shift, int min_val, int max_val";
+  specialize qw/av1_add_film_grain_row sse4_1 avx2/;
+}
+
 # directional intra predictor functions
 add_proto qw/void av1_dr_prediction_z1/, "uint8_t *dst, ptrdiff_t stride, int bw, int bh, const uint8_t *above, const uint8_t *left, int upsample_above, int dx, int dy";
 specialize qw/av1_dr_prediction_z1 sse4_1 avx2 neon/;
@@ -290,7 +296,7 @@ if (aom_config("CONFIG_AV1_ENCODER") eq "yes") {
   # the transform coefficients are held in 32-bit
   # values, so the assembler code for  av1_block_error can no longer be used.
   add_proto qw/int64_t av1_block_error/, "const tran_low_t *coeff, const tran_low_t *dqcoeff, intptr_t block_size, int64_t *ssz";
-  specialize qw/av1_block_error sse2 avx2 neon sve/;
+  specialize qw/av1_block_error sse2 avx2 avx512 neon sve/;
 
   add_proto qw/int64_t av1_block_error_lp/, "const int16_t *coeff, const int16_t *dqcoeff, intptr_t block_size";
   specialize qw/av1_block_error_lp sse2 avx2 neon sve/;
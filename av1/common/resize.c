@@ -25,6 +25,7 @@
 #include "aom_ports/mem.h"
 #include "av1/common/common.h"
 #include "av1/common/resize.h"
+#include "av1/common/thread_common.h"
 
 #include "config/aom_dsp_rtcd.h"
 #include "config/aom_scale_rtcd.h"
@@ -1116,9 +1117,10 @@ bool av1_resize_and_extend_frame_nonnormative(const YV12_BUFFER_CONFIG *src,
   return true;
 }
 
-void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
-                                int src_stride, uint8_t *dst, int dst_stride,
-                                int plane, int rows) {
+static void upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
+                                   int src_stride, uint8_t *dst, int dst_stride,
+                                   int plane, int rows,
+                                   struct aom_internal_error_info *error_info) {
   const int is_uv = (plane > 0);
   const int ss_x = is_uv && cm->seq_params->subsampling_x;
   const int downscaled_plane_width = ROUND_POWER_OF_TWO(cm->width, ss_x);
@@ -1178,7 +1180,7 @@ void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
                                      x_step_qn, x0_qn, pad_left, pad_right);
 #endif
     if (!success) {
-      aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
+      aom_internal_error(error_info, AOM_CODEC_MEM_ERROR,
                          "Error upscaling frame");
     }
     // Update the fractional pixel offset to prepare for the next tile column.
@@ -1186,18 +1188,44 @@ void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
   }
 }
 
+void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
+                                int src_stride, uint8_t *dst, int dst_stride,
+                                int plane, int rows) {
+  upscale_normative_rows(cm, src, src_stride, dst, dst_stride, plane, rows,
+                         cm->error);
+}
+
+void av1_upscale_normative_and_extend_plane_rows(
+    const AV1_COMMON *cm, const YV12_BUFFER_CONFIG *src,
+    YV12_BUFFER_CONFIG *dst, int plane, int row_start, int row_end,
+    struct aom_internal_error_info *error_info) {
+  const int is_uv = (plane > 0);
+  const int src_stride = src->strides[is_uv];
+  const int dst_stride = dst->strides[is_uv];
+  const uint8_t *src_rows = src->buffers[plane];
+  uint8_t *dst_rows = dst->buffers[plane];
+  if (cm->seq_params->use_highbitdepth) {
+    src_rows = CONVERT_TO_BYTEPTR(CONVERT_TO_SHORTPTR(src_rows) +
+                                  row_start * src_stride);
+    dst_rows = CONVERT_TO_BYTEPTR(CONVERT_TO_SHORTPTR(dst_rows) +
+                                  row_start * dst_stride);
+  } else {
+    src_rows += row_start * src_stride;
+    dst_rows += row_start * dst_stride;
+  }
+  upscale_normative_rows(cm, src_rows, src_stride, dst_rows, dst_stride, plane,
+                         row_end - row_start, error_info);
+  aom_extend_frame_borders_plane_row(dst, plane, row_start, row_end);
+}
+
 static void upscale_normative_and_extend_frame(const AV1_COMMON *cm,
                                                const YV12_BUFFER_CONFIG *src,
                                                YV12_BUFFER_CONFIG *dst) {
   const int num_planes = av1_num_planes(cm);
   for (int i = 0; i < num_planes; ++i) {
-    const int is_uv = (i > 0);
-    av1_upscale_normative_rows(cm, src->buffers[i], src->strides[is_uv],
-                               dst->buffers[i], dst->strides[is_uv], i,
-                               src->crop_heights[is_uv]);
+    av1_upscale_normative_and_extend_plane_rows(
+        cm, src, dst, i, 0, src->crop_heights[i > 0], cm->error);
   }
-
-  aom_extend_frame_borders(dst, num_planes);
 }
 
 YV12_BUFFER_CONFIG *av1_realloc_and_scale_if_required(
@@ -1315,7 +1343,8 @@ static void copy_buffer_config(const YV12_BUFFER_CONFIG *const src,
 // TODO(afergs): aom_ vs av1_ functions? Which can I use?
 // Upscale decoded image.
 void av1_superres_upscale(AV1_COMMON *cm, BufferPool *const pool,
-                          bool alloc_pyramid) {
+                          bool alloc_pyramid, AVxWorker *workers,
+                          int num_workers) {
   const int num_planes = av1_num_planes(cm);
   if (!av1_superres_scaled(cm)) return;
   const SequenceHeader *const seq_params = cm->seq_params;
@@ -1397,7 +1426,12 @@ void av1_superres_upscale(AV1_COMMON *cm, BufferPool *const pool,
 
   // Scale up and back into frame_to_show.
   assert(frame_to_show->y_crop_width != cm->width);
-  upscale_normative_and_extend_frame(cm, &copy_buffer, frame_to_show);
+  if (num_workers > 1) {
+    av1_superres_upscale_frame_mt(cm, &copy_buffer, frame_to_show, workers,
+                                  num_workers);
+  } else {
+    upscale_normative_and_extend_frame(cm, &copy_buffer, frame_to_show);
+  }
 
   // Free the copy buffer
   aom_free_frame_buffer(&copy_buffer);
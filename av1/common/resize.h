@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include "aom/aom_integer.h"
+#include "aom_util/aom_thread.h"
 #include "av1/common/av1_common_int.h"
 
 #ifdef __cplusplus
@@ -32,6 +33,15 @@ void av1_upscale_normative_rows(const AV1_COMMON *cm, const uint8_t *src,
                                 int src_stride, uint8_t *dst, int dst_stride,
                                 int plane, int rows);
 
+// Upscales the rows [row_start, row_end) of a plane of src into dst, and
+// extends the borders of those rows of dst. The top and bottom borders are
+// extended along with the first and last rows of the plane. Errors are
+// reported to error_info.
+void av1_upscale_normative_and_extend_plane_rows(
+    const AV1_COMMON *cm, const YV12_BUFFER_CONFIG *src,
+    YV12_BUFFER_CONFIG *dst, int plane, int row_start, int row_end,
+    struct aom_internal_error_info *error_info);
+
 YV12_BUFFER_CONFIG *av1_realloc_and_scale_if_required(
     AV1_COMMON *cm, YV12_BUFFER_CONFIG *unscaled, YV12_BUFFER_CONFIG *scaled,
     const InterpFilter filter, const int phase, const bool use_optimized_scaler,
@@ -50,8 +60,11 @@ void av1_calculate_scaled_size(int *width, int *height, int resize_denom);
 void av1_calculate_scaled_superres_size(int *width, int *height,
                                         int superres_denom);
 
+// Upscales the current frame in place. The upscaling is spread over the
+// workers when num_workers is greater than 1.
 void av1_superres_upscale(AV1_COMMON *cm, BufferPool *const pool,
-                          bool alloc_pyramid);
+                          bool alloc_pyramid, AVxWorker *workers,
+                          int num_workers);
 
 bool av1_resize_plane_to_half(const uint8_t *const input, int height, int width,
                               int in_stride, uint8_t *output, int height2,
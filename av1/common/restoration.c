@@ -10,6 +10,7 @@
  *
  */
 
+#include <limits.h>
 #include <math.h>
 #include <stddef.h>
 
@@ -983,13 +984,61 @@ static const stripe_filter_fun stripe_filters[NUM_STRIPE_FILTERS] = {
 };
 #endif  // CONFIG_AV1_HIGHBITDEPTH
 
-// Filter one restoration unit
-void av1_loop_restoration_filter_unit(
-    const RestorationTileLimits *limits, const RestorationUnitInfo *rui,
-    const RestorationStripeBoundaries *rsb, RestorationLineBuffers *rlbs,
-    int plane_w, int plane_h, int ss_x, int ss_y, int highbd, int bit_depth,
-    uint8_t *data8, int stride, uint8_t *dst8, int dst_stride, int32_t *tmpbuf,
-    int optimized_lr, struct aom_internal_error_info *error_info) {
+// Filters a processing stripe of a restoration unit in place, one processing
+// unit at a time, through rlbs->tmp_filtered. As a processing unit reads the
+// RESTORATION_BORDER_HORZ columns to its left, their restored values are held
+// back in rlbs->tmp_save_right until the processing unit to their right is
+// filtered. The columns held back by the last processing unit are written back
+// by the next restoration unit of the row, so hold_left says whether the
+// restoration unit to the left holds back columns, and end_of_row whether the
+// stripe is the last one of the row.
+static void filter_stripe_in_place(
+    const RestorationUnitInfo *rui, stripe_filter_fun stripe_filter,
+    int stripe_width, int stripe_height, int procunit_width, uint8_t *data8,
+    int stride, RestorationLineBuffers *rlbs, int unit_row, int hold_left,
+    int end_of_row, int32_t *tmpbuf, int highbd, int bit_depth,
+    struct aom_internal_error_info *error_info) {
+  const int hold = RESTORATION_BORDER_HORZ;
+  const int buf_stride = RESTORATION_FILTERED_WIDTH;
+  uint8_t *const buf8 = highbd ? CONVERT_TO_BYTEPTR(rlbs->tmp_filtered)
+                               : (uint8_t *)rlbs->tmp_filtered;
+
+  for (int j = 0; j < stripe_width; j += procunit_width) {
+    const int w = AOMMIN(procunit_width, stripe_width - j);
+    // Each row of the buffer starts with the held back columns to the left of
+    // the processing unit, followed by its restored pixels.
+    const int held = (j > 0 || hold_left) ? hold : 0;
+    const int keep = (end_of_row && j + w == stripe_width) ? 0 : hold;
+    assert(held + w >= keep);
+    stripe_filter(rui, w, stripe_height, procunit_width, data8 + j, stride,
+                  buf8 + hold, buf_stride, tmpbuf, bit_depth, error_info);
+
+    const int start = hold - held;
+    const int end = hold + w - keep;
+    for (int i = 0; i < stripe_height; ++i) {
+      uint8_t *const buf_row = REAL_PTR(highbd, buf8 + i * buf_stride);
+      uint8_t *const data_row =
+          REAL_PTR(highbd, data8 + i * (ptrdiff_t)stride + j - hold);
+      uint16_t *const saved = rlbs->tmp_save_right[unit_row + i];
+      memcpy(buf_row, saved, held << highbd);
+      memcpy(data_row + (start << highbd), buf_row + (start << highbd),
+             (end - start) << highbd);
+      memcpy(saved, buf_row + (end << highbd), keep << highbd);
+    }
+  }
+}
+
+// Filters one restoration unit into dst8, or in place in data8 if dst8 is NULL
+// (see filter_stripe_in_place()).
+static void filter_unit(const RestorationTileLimits *limits,
+                        const RestorationUnitInfo *rui,
+                        const RestorationStripeBoundaries *rsb,
+                        RestorationLineBuffers *rlbs, int plane_w, int plane_h,
+                        int ss_x, int ss_y, int highbd, int bit_depth,
+                        uint8_t *data8, int stride, uint8_t *dst8,
+                        int dst_stride, int32_t *tmpbuf, int optimized_lr,
+                        int hold_left,
+                        struct aom_internal_error_info *error_info) {
   RestorationType unit_rtype = rui->restoration_type;
 
   int unit_h = limits->v_end - limits->v_start;
@@ -997,11 +1046,22 @@ void av1_loop_restoration_filter_unit(
   uint8_t *data8_tl =
       data8 + limits->v_start * (ptrdiff_t)stride + limits->h_start;
   uint8_t *dst8_tl =
-      dst8 + limits->v_start * (ptrdiff_t)dst_stride + limits->h_start;
+      dst8 ? dst8 + limits->v_start * (ptrdiff_t)dst_stride + limits->h_start
+           : NULL;
 
   if (unit_rtype == RESTORE_NONE) {
-    copy_rest_unit(unit_w, unit_h, data8_tl, stride, dst8_tl, dst_stride,
-                   highbd);
+    if (dst8) {
+      copy_rest_unit(unit_w, unit_h, data8_tl, stride, dst8_tl, dst_stride,
+                     highbd);
+    } else if (hold_left) {
+      // Nothing to filter, only the columns held back to the left remain to
+      // be written back.
+      for (int i = 0; i < unit_h; ++i) {
+        memcpy(REAL_PTR(highbd, data8_tl + i * (ptrdiff_t)stride -
+                                    RESTORATION_BORDER_HORZ),
+               rlbs->tmp_save_right[i], RESTORATION_BORDER_HORZ << highbd);
+      }
+    }
     return;
   }
 
@@ -1042,9 +1102,16 @@ void av1_loop_restoration_filter_unit(
                                      h, data8, stride, rlbs, copy_above,
                                      copy_below, optimized_lr);
 
-    stripe_filter(rui, unit_w, h, procunit_width, data8_tl + i * stride, stride,
-                  dst8_tl + i * dst_stride, dst_stride, tmpbuf, bit_depth,
-                  error_info);
+    if (dst8) {
+      stripe_filter(rui, unit_w, h, procunit_width, data8_tl + i * stride,
+                    stride, dst8_tl + i * dst_stride, dst_stride, tmpbuf,
+                    bit_depth, error_info);
+    } else {
+      filter_stripe_in_place(rui, stripe_filter, unit_w, h, procunit_width,
+                             data8_tl + i * stride, stride, rlbs, i, hold_left,
+                             limits->h_end == plane_w, tmpbuf, highbd,
+                             bit_depth, error_info);
+    }
 
     restore_processing_stripe_boundary(&remaining_stripes, rlbs, highbd, h,
                                        data8, stride, copy_above, copy_below,
@@ -1054,45 +1121,52 @@ void av1_loop_restoration_filter_unit(
   }
 }
 
+// Filter one restoration unit
+void av1_loop_restoration_filter_unit(
+    const RestorationTileLimits *limits, const RestorationUnitInfo *rui,
+    const RestorationStripeBoundaries *rsb, RestorationLineBuffers *rlbs,
+    int plane_w, int plane_h, int ss_x, int ss_y, int highbd, int bit_depth,
+    uint8_t *data8, int stride, uint8_t *dst8, int dst_stride, int32_t *tmpbuf,
+    int optimized_lr, struct aom_internal_error_info *error_info) {
+  filter_unit(limits, rui, rsb, rlbs, plane_w, plane_h, ss_x, ss_y, highbd,
+              bit_depth, data8, stride, dst8, dst_stride, tmpbuf, optimized_lr,
+              /*hold_left=*/0, error_info);
+}
+
 static void filter_frame_on_unit(const RestorationTileLimits *limits,
                                  int rest_unit_idx, void *priv, int32_t *tmpbuf,
                                  RestorationLineBuffers *rlbs,
                                  struct aom_internal_error_info *error_info) {
   FilterFrameCtxt *ctxt = (FilterFrameCtxt *)priv;
   const RestorationInfo *rsi = ctxt->rsi;
-
-  av1_loop_restoration_filter_unit(
-      limits, &rsi->unit_info[rest_unit_idx], &rsi->boundaries, rlbs,
-      ctxt->plane_w, ctxt->plane_h, ctxt->ss_x, ctxt->ss_y, ctxt->highbd,
-      ctxt->bit_depth, ctxt->data8, ctxt->data_stride, ctxt->dst8,
-      ctxt->dst_stride, tmpbuf, rsi->optimized_lr, error_info);
+  // The units of a row are filtered from left to right, and a unit which is
+  // not the last of its row holds back its last columns.
+  const int hold_left =
+      limits->h_start > 0 &&
+      rsi->unit_info[rest_unit_idx - 1].restoration_type != RESTORE_NONE;
+
+  // The rows around each stripe are always taken from the saved boundary
+  // lines, as the rows of the stripes above are already restored.
+  filter_unit(limits, &rsi->unit_info[rest_unit_idx], &rsi->boundaries, rlbs,
+              ctxt->plane_w, ctxt->plane_h, ctxt->ss_x, ctxt->ss_y,
+              ctxt->highbd, ctxt->bit_depth, ctxt->data8, ctxt->data_stride,
+              /*dst8=*/NULL, 0, tmpbuf, /*optimized_lr=*/0, hold_left,
+              error_info);
 }
 
-void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
-                                            YV12_BUFFER_CONFIG *frame,
-                                            AV1_COMMON *cm, int optimized_lr,
-                                            int num_planes) {
+static void loop_restoration_filter_init(AV1LrStruct *lr_ctxt,
+                                         YV12_BUFFER_CONFIG *frame,
+                                         AV1_COMMON *cm, int num_planes,
+                                         int extend_frame) {
   const SequenceHeader *const seq_params = cm->seq_params;
   const int bit_depth = seq_params->bit_depth;
   const int highbd = seq_params->use_highbitdepth;
-  lr_ctxt->dst = &cm->rst_frame;
-
-  const int frame_width = frame->crop_widths[0];
-  const int frame_height = frame->crop_heights[0];
-  if (aom_realloc_frame_buffer(
-          lr_ctxt->dst, frame_width, frame_height, seq_params->subsampling_x,
-          seq_params->subsampling_y, highbd, AOM_RESTORATION_FRAME_BORDER,
-          cm->features.byte_alignment, NULL, NULL, NULL, false,
-          0) != AOM_CODEC_OK)
-    aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
-                       "Failed to allocate restoration dst buffer");
 
   lr_ctxt->on_rest_unit = filter_frame_on_unit;
   lr_ctxt->frame = frame;
   for (int plane = 0; plane < num_planes; ++plane) {
     RestorationInfo *rsi = &cm->rst_info[plane];
     RestorationType rtype = rsi->frame_restoration_type;
-    rsi->optimized_lr = optimized_lr;
     lr_ctxt->ctxt[plane].rsi = rsi;
 
     if (rtype == RESTORE_NONE) {
@@ -1105,9 +1179,11 @@ void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
     assert(plane_w == frame->crop_widths[is_uv]);
     assert(plane_h == frame->crop_heights[is_uv]);
 
-    av1_extend_frame(frame->buffers[plane], plane_w, plane_h,
-                     frame->strides[is_uv], RESTORATION_BORDER,
-                     RESTORATION_BORDER, highbd);
+    if (extend_frame) {
+      av1_extend_frame(frame->buffers[plane], plane_w, plane_h,
+                       frame->strides[is_uv], RESTORATION_BORDER,
+                       RESTORATION_BORDER, highbd);
+    }
 
     FilterFrameCtxt *lr_plane_ctxt = &lr_ctxt->ctxt[plane];
     lr_plane_ctxt->ss_x = is_uv && seq_params->subsampling_x;
@@ -1117,27 +1193,22 @@ void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
     lr_plane_ctxt->highbd = highbd;
     lr_plane_ctxt->bit_depth = bit_depth;
     lr_plane_ctxt->data8 = frame->buffers[plane];
-    lr_plane_ctxt->dst8 = lr_ctxt->dst->buffers[plane];
     lr_plane_ctxt->data_stride = frame->strides[is_uv];
-    lr_plane_ctxt->dst_stride = lr_ctxt->dst->strides[is_uv];
   }
 }
 
-static void loop_restoration_copy_planes(AV1LrStruct *loop_rest_ctxt,
-                                         AV1_COMMON *cm, int num_planes) {
-  typedef void (*copy_fun)(const YV12_BUFFER_CONFIG *src_ybc,
-                           YV12_BUFFER_CONFIG *dst_ybc, int hstart, int hend,
-                           int vstart, int vend);
-  static const copy_fun copy_funs[3] = { aom_yv12_partial_coloc_copy_y,
-                                         aom_yv12_partial_coloc_copy_u,
-                                         aom_yv12_partial_coloc_copy_v };
-  assert(num_planes <= 3);
-  for (int plane = 0; plane < num_planes; ++plane) {
-    if (cm->rst_info[plane].frame_restoration_type == RESTORE_NONE) continue;
-    FilterFrameCtxt *lr_plane_ctxt = &loop_rest_ctxt->ctxt[plane];
-    copy_funs[plane](loop_rest_ctxt->dst, loop_rest_ctxt->frame, 0,
-                     lr_plane_ctxt->plane_w, 0, lr_plane_ctxt->plane_h);
-  }
+void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
+                                            YV12_BUFFER_CONFIG *frame,
+                                            AV1_COMMON *cm, int num_planes) {
+  loop_restoration_filter_init(lr_ctxt, frame, cm, num_planes,
+                               /*extend_frame=*/1);
+}
+
+void av1_loop_restoration_filter_stripes_init(AV1LrStruct *lr_ctxt,
+                                              YV12_BUFFER_CONFIG *frame,
+                                              AV1_COMMON *cm, int num_planes) {
+  loop_restoration_filter_init(lr_ctxt, frame, cm, num_planes,
+                               /*extend_frame=*/0);
 }
 
 // Call on_rest_unit for each loop restoration unit in the plane.
@@ -1195,19 +1266,86 @@ static void foreach_rest_unit_in_planes(AV1LrStruct *lr_ctxt, AV1_COMMON *cm,
 }
 
 void av1_loop_restoration_filter_frame(YV12_BUFFER_CONFIG *frame,
-                                       AV1_COMMON *cm, int optimized_lr,
-                                       void *lr_ctxt) {
+                                       AV1_COMMON *cm, void *lr_ctxt) {
   assert(!cm->features.all_lossless);
   const int num_planes = av1_num_planes(cm);
 
   AV1LrStruct *loop_rest_ctxt = (AV1LrStruct *)lr_ctxt;
 
   av1_loop_restoration_filter_frame_init(loop_rest_ctxt, frame, cm,
-                                         optimized_lr, num_planes);
+                                         num_planes);
 
   foreach_rest_unit_in_planes(loop_rest_ctxt, cm, num_planes);
+}
 
-  loop_restoration_copy_planes(loop_rest_ctxt, cm, num_planes);
+int av1_lr_count_stripes(const AV1_COMMON *cm) {
+  int plane_w, plane_h;
+  av1_get_upsampled_plane_size(cm, 0, &plane_w, &plane_h);
+  return (plane_h + RESTORATION_UNIT_OFFSET + RESTORATION_PROC_UNIT_SIZE - 1) /
+         RESTORATION_PROC_UNIT_SIZE;
+}
+
+// Copies the extended row src_row of a plane over num_rows rows starting at
+// dst_row.
+static void replicate_plane_row(uint8_t *data8, int width, int stride,
+                                int src_row, int dst_row, int num_rows,
+                                int highbd) {
+  uint8_t *const data = REAL_PTR(highbd, data8);
+  const ptrdiff_t row_bytes = (ptrdiff_t)stride << highbd;
+  const uint8_t *const src =
+      data + src_row * row_bytes - (RESTORATION_BORDER << highbd);
+  const size_t line_size = (width + 2 * RESTORATION_BORDER) << highbd;
+  for (int i = 0; i < num_rows; ++i) {
+    memcpy(data + (dst_row + i) * row_bytes - (RESTORATION_BORDER << highbd),
+           src, line_size);
+  }
+}
+
+void av1_loop_restoration_filter_stripe(
+    AV1LrStruct *lr_ctxt, AV1_COMMON *cm, int stripe, int num_planes,
+    int32_t *tmpbuf, RestorationLineBuffers *rlbs,
+    struct aom_internal_error_info *error_info) {
+  for (int plane = 0; plane < num_planes; ++plane) {
+    const RestorationInfo *rsi = &cm->rst_info[plane];
+    if (rsi->frame_restoration_type == RESTORE_NONE) continue;
+
+    FilterFrameCtxt *ctxt = &lr_ctxt->ctxt[plane];
+    const int stripe_height = RESTORATION_PROC_UNIT_SIZE >> ctxt->ss_y;
+    const int stripe_off = RESTORATION_UNIT_OFFSET >> ctxt->ss_y;
+    const int y0 = AOMMAX(0, stripe * stripe_height - stripe_off);
+    const int y1 =
+        AOMMIN((stripe + 1) * stripe_height - stripe_off, ctxt->plane_h);
+    if (y0 >= y1) continue;
+
+    // Extend the rows of the stripe as av1_extend_frame() does for the whole
+    // plane: the rows above the first stripe and below the last one are
+    // copies of the outermost rows of the plane.
+    av1_extend_frame(ctxt->data8 + y0 * (ptrdiff_t)ctxt->data_stride,
+                     ctxt->plane_w, y1 - y0, ctxt->data_stride,
+                     RESTORATION_BORDER, 0, ctxt->highbd);
+    if (y0 == 0) {
+      replicate_plane_row(ctxt->data8, ctxt->plane_w, ctxt->data_stride, 0,
+                          -RESTORATION_BORDER, RESTORATION_BORDER,
+                          ctxt->highbd);
+    }
+    if (y1 == ctxt->plane_h) {
+      replicate_plane_row(ctxt->data8, ctxt->plane_w, ctxt->data_stride,
+                          y1 - 1, y1, RESTORATION_BORDER, ctxt->highbd);
+    }
+
+    // A stripe never crosses the boundary between two rows of restoration
+    // units, and the last row of units absorbs the remaining stripes.
+    const int unit_row = AOMMIN((y0 + stripe_off) / rsi->restoration_unit_size,
+                                rsi->vert_units - 1);
+    RestorationTileLimits limits;
+    limits.v_start = y0;
+    limits.v_end = y1;
+    av1_foreach_rest_unit_in_row(
+        &limits, ctxt->plane_w, lr_ctxt->on_rest_unit, unit_row,
+        rsi->restoration_unit_size, rsi->horz_units, rsi->vert_units, plane,
+        ctxt, tmpbuf, rlbs, av1_lr_sync_read_dummy, av1_lr_sync_write_dummy,
+        NULL, error_info);
+  }
 }
 
 void av1_foreach_rest_unit_in_row(
@@ -1439,8 +1577,11 @@ static void save_cdef_boundary_lines(const YV12_BUFFER_CONFIG *frame,
                RESTORATION_EXTRA_HORZ, use_highbd);
 }
 
+// Saves the boundary lines of a plane whose first source row is in
+// [row_start, row_end).
 static void save_boundary_lines(const YV12_BUFFER_CONFIG *frame, int use_highbd,
-                                int plane, AV1_COMMON *cm, int after_cdef) {
+                                int plane, AV1_COMMON *cm, int after_cdef,
+                                int row_start, int row_end) {
   const int is_uv = plane > 0;
   const int ss_y = is_uv && cm->seq_params->subsampling_y;
   const int stripe_height = RESTORATION_PROC_UNIT_SIZE >> ss_y;
@@ -1469,21 +1610,22 @@ static void save_boundary_lines(const YV12_BUFFER_CONFIG *frame, int use_highbd,
 
     if (!after_cdef) {
       // Save deblocked context at internal stripe boundaries
-      if (use_deblock_above) {
-        save_deblock_boundary_lines(frame, cm, plane, y0 - RESTORATION_CTX_VERT,
-                                    stripe_idx, use_highbd, 1, boundaries);
+      const int row_above = y0 - RESTORATION_CTX_VERT;
+      if (use_deblock_above && row_above >= row_start && row_above < row_end) {
+        save_deblock_boundary_lines(frame, cm, plane, row_above, stripe_idx,
+                                    use_highbd, 1, boundaries);
       }
-      if (use_deblock_below) {
+      if (use_deblock_below && y1 >= row_start && y1 < row_end) {
         save_deblock_boundary_lines(frame, cm, plane, y1, stripe_idx,
                                     use_highbd, 0, boundaries);
       }
     } else {
       // Save CDEF context at frame boundaries
-      if (!use_deblock_above) {
+      if (!use_deblock_above && y0 >= row_start && y0 < row_end) {
         save_cdef_boundary_lines(frame, cm, plane, y0, stripe_idx, use_highbd,
                                  1, boundaries);
       }
-      if (!use_deblock_below) {
+      if (!use_deblock_below && y1 - 1 >= row_start && y1 - 1 < row_end) {
         save_cdef_boundary_lines(frame, cm, plane, y1 - 1, stripe_idx,
                                  use_highbd, 0, boundaries);
       }
@@ -1499,6 +1641,18 @@ void av1_loop_restoration_save_boundary_lines(const YV12_BUFFER_CONFIG *frame,
   const int num_planes = av1_num_planes(cm);
   const int use_highbd = cm->seq_params->use_highbitdepth;
   for (int p = 0; p < num_planes; ++p) {
-    save_boundary_lines(frame, use_highbd, p, cm, after_cdef);
+    save_boundary_lines(frame, use_highbd, p, cm, after_cdef, 0, INT_MAX);
+  }
+}
+
+void av1_loop_restoration_save_boundary_lines_in_rows(
+    const YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm, int row_start,
+    int row_end, int after_cdef) {
+  const int num_planes = av1_num_planes(cm);
+  const int use_highbd = cm->seq_params->use_highbitdepth;
+  for (int p = 0; p < num_planes; ++p) {
+    const int ss_y = p > 0 && cm->seq_params->subsampling_y;
+    save_boundary_lines(frame, use_highbd, p, cm, after_cdef,
+                        row_start >> ss_y, (row_end + ss_y) >> ss_y);
   }
 }
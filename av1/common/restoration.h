@@ -211,11 +211,25 @@ typedef struct {
 #define RESTORATION_LINEBUFFER_WIDTH \
   (RESTORATION_UNITSIZE_MAX * 3 / 2 + 2 * RESTORATION_EXTRA_HORZ)
 
+// The frame filter restores each processing unit into a line buffer, behind
+// the held back restored columns to its left.
+#define RESTORATION_FILTERED_WIDTH \
+  (RESTORATION_BORDER_HORZ + RESTORATION_PROC_UNIT_SIZE)
+
 typedef struct {
   // Temporary buffers to save/restore 3 lines above/below the restoration
   // stripe.
   uint16_t tmp_save_above[RESTORATION_BORDER][RESTORATION_LINEBUFFER_WIDTH];
   uint16_t tmp_save_below[RESTORATION_BORDER][RESTORATION_LINEBUFFER_WIDTH];
+  // Output of the frame filter for the current processing unit, before it is
+  // written back into the frame.
+  uint16_t tmp_filtered[RESTORATION_PROC_UNIT_SIZE][RESTORATION_FILTERED_WIDTH];
+  // Restored values of the last RESTORATION_BORDER_HORZ columns filtered by
+  // the frame filter, indexed by the row within the restoration unit. They are
+  // written back once the processing unit to their right, which reads their
+  // unrestored values, is filtered.
+  uint16_t
+      tmp_save_right[RESTORATION_UNITPELS_VERT_MAX][RESTORATION_BORDER_HORZ];
 } RestorationLineBuffers;
 /*!\endcond */
 
@@ -283,13 +297,6 @@ typedef struct {
    * Restoration Stripe boundary info
    */
   RestorationStripeBoundaries boundaries;
-
-  /*!
-   * Whether optimized lr can be used for speed.
-   * That includes cases of no cdef and no superres, or if fast trial runs
-   * are used on the encoder side.
-   */
-  int optimized_lr;
 } RestorationInfo;
 
 /*!\cond */
@@ -326,15 +333,14 @@ typedef struct FilterFrameCtxt {
   int ss_x, ss_y;
   int plane_w, plane_h;
   int highbd, bit_depth;
-  uint8_t *data8, *dst8;
-  int data_stride, dst_stride;
+  uint8_t *data8;
+  int data_stride;
 } FilterFrameCtxt;
 
 typedef struct AV1LrStruct {
   rest_unit_visitor_t on_rest_unit;
   FilterFrameCtxt ctxt[MAX_MB_PLANE];
   YV12_BUFFER_CONFIG *frame;
-  YV12_BUFFER_CONFIG *dst;
 } AV1LrStruct;
 
 extern const sgr_params_type av1_sgr_params[SGRPROJ_PARAMS];
@@ -395,19 +401,19 @@ void av1_loop_restoration_filter_unit(
 /*!\brief Function for applying loop restoration filter to a frame
  *
  * \ingroup in_loop_restoration
- * This function applies the loop restoration filter to a frame.
+ * This function applies the loop restoration filter to a frame. The frame is
+ * filtered in place, so the stripe boundary lines must have been saved with
+ * av1_loop_restoration_save_boundary_lines().
  *
  * \param[in,out]   frame         Compressed frame buffer
  * \param[in,out]   cm            Pointer to top level common structure
- * \param[in]       optimized_lr  Whether to use fast optimized Loop Restoration
  * \param[in]       lr_ctxt       Loop restoration context
  *
  * \remark Nothing is returned. Instead, the filtered frame is output in
  * \c frame.
  */
 void av1_loop_restoration_filter_frame(YV12_BUFFER_CONFIG *frame,
-                                       struct AV1Common *cm, int optimized_lr,
-                                       void *lr_ctxt);
+                                       struct AV1Common *cm, void *lr_ctxt);
 /*!\cond */
 
 void av1_loop_restoration_precal(void);
@@ -435,10 +441,33 @@ int av1_loop_restoration_corners_in_sb(const struct AV1Common *cm, int plane,
 void av1_loop_restoration_save_boundary_lines(const YV12_BUFFER_CONFIG *frame,
                                               struct AV1Common *cm,
                                               int after_cdef);
+// Saves the boundary lines of av1_loop_restoration_save_boundary_lines()
+// which lie in luma rows [row_start, row_end) of the frame, or in the
+// matching chroma rows.
+void av1_loop_restoration_save_boundary_lines_in_rows(
+    const YV12_BUFFER_CONFIG *frame, struct AV1Common *cm, int row_start,
+    int row_end, int after_cdef);
 void av1_loop_restoration_filter_frame_init(AV1LrStruct *lr_ctxt,
                                             YV12_BUFFER_CONFIG *frame,
                                             struct AV1Common *cm,
-                                            int optimized_lr, int num_planes);
+                                            int num_planes);
+
+// Prepares lr_ctxt for av1_loop_restoration_filter_stripe(). Unlike
+// av1_loop_restoration_filter_frame_init(), the frame is not extended here,
+// as its lower rows may not be ready yet.
+void av1_loop_restoration_filter_stripes_init(AV1LrStruct *lr_ctxt,
+                                              YV12_BUFFER_CONFIG *frame,
+                                              struct AV1Common *cm,
+                                              int num_planes);
+// Returns the number of 64 luma row processing stripes in the frame.
+int av1_lr_count_stripes(const struct AV1Common *cm);
+// Filters the processing stripe with the given index in every plane, in place.
+// The stripes must be filtered in order, each one once the CDEF output and the
+// saved boundary lines of its rows are final.
+void av1_loop_restoration_filter_stripe(
+    AV1LrStruct *lr_ctxt, struct AV1Common *cm, int stripe, int num_planes,
+    int32_t *tmpbuf, RestorationLineBuffers *rlbs,
+    struct aom_internal_error_info *error_info);
 void av1_foreach_rest_unit_in_row(
     RestorationTileLimits *limits, int plane_w,
     rest_unit_visitor_t on_rest_unit, int row_number, int unit_size,
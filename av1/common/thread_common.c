@@ -26,6 +26,7 @@
 #include "av1/common/thread_common.h"
 #include "av1/common/reconinter.h"
 #include "av1/common/reconintra.h"
+#include "av1/common/resize.h"
 #include "av1/common/restoration.h"
 
 // Set up nsync by width.
@@ -110,6 +111,114 @@ void av1_loop_filter_alloc(AV1LfSync *lf_sync, AV1_COMMON *cm, int rows,
   lf_sync->sync_range = get_sync_range(width);
 }
 
+// Number of polls of a row's progress before blocking on its condition
+// variable.
+#define ROW_MT_PROGRESS_SPIN_COUNT 256
+
+void av1_row_mt_progress_alloc(AV1RowMTProgress *row_progress, AV1_COMMON *cm,
+                               int rows) {
+  row_progress->rows = rows;
+#if CONFIG_MULTITHREAD
+  CHECK_MEM_ERROR(cm, row_progress->mutex_,
+                  aom_malloc(sizeof(*row_progress->mutex_) * rows));
+  if (row_progress->mutex_) {
+    for (int i = 0; i < rows; ++i) {
+      pthread_mutex_init(&row_progress->mutex_[i], NULL);
+    }
+  }
+
+  CHECK_MEM_ERROR(cm, row_progress->cond_,
+                  aom_malloc(sizeof(*row_progress->cond_) * rows));
+  if (row_progress->cond_) {
+    for (int i = 0; i < rows; ++i) {
+      pthread_cond_init(&row_progress->cond_[i], NULL);
+    }
+  }
+
+  CHECK_MEM_ERROR(cm, row_progress->num_waiters,
+                  aom_calloc(rows, sizeof(*row_progress->num_waiters)));
+#endif  // CONFIG_MULTITHREAD
+
+  CHECK_MEM_ERROR(cm, row_progress->progress,
+                  aom_malloc(sizeof(*row_progress->progress) * rows));
+  av1_row_mt_progress_reset(row_progress);
+}
+
+void av1_row_mt_progress_dealloc(AV1RowMTProgress *row_progress) {
+#if CONFIG_MULTITHREAD
+  if (row_progress->mutex_ != NULL) {
+    for (int i = 0; i < row_progress->rows; ++i) {
+      pthread_mutex_destroy(&row_progress->mutex_[i]);
+    }
+    aom_free(row_progress->mutex_);
+  }
+  if (row_progress->cond_ != NULL) {
+    for (int i = 0; i < row_progress->rows; ++i) {
+      pthread_cond_destroy(&row_progress->cond_[i]);
+    }
+    aom_free(row_progress->cond_);
+  }
+  aom_free(row_progress->num_waiters);
+#endif  // CONFIG_MULTITHREAD
+  aom_free(row_progress->progress);
+  av1_zero(*row_progress);
+}
+
+void av1_row_mt_progress_reset(AV1RowMTProgress *row_progress) {
+  for (int i = 0; i < row_progress->rows; ++i) {
+    aom_atomic_init(&row_progress->progress[i], -1);
+  }
+}
+
+void av1_row_mt_progress_wait(AV1RowMTProgress *row_progress, int r,
+                              int value) {
+#if CONFIG_MULTITHREAD
+  aom_atomic_int *const progress = &row_progress->progress[r];
+  for (int i = 0; i < ROW_MT_PROGRESS_SPIN_COUNT; ++i) {
+    if (aom_atomic_load_acquire(progress) >= value) return;
+    aom_atomic_spin_pause();
+  }
+
+  pthread_mutex_t *const mutex = &row_progress->mutex_[r];
+  pthread_mutex_lock(mutex);
+  // Pairs with the fence in av1_row_mt_progress_set(): either the writer sees
+  // this thread waiting, or this thread sees the new progress.
+  aom_atomic_fetch_add(&row_progress->num_waiters[r], 1);
+  aom_atomic_thread_fence();
+  while (aom_atomic_load_acquire(progress) < value) {
+    pthread_cond_wait(&row_progress->cond_[r], mutex);
+  }
+  aom_atomic_fetch_add(&row_progress->num_waiters[r], -1);
+  pthread_mutex_unlock(mutex);
+#else
+  (void)row_progress;
+  (void)r;
+  (void)value;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void av1_row_mt_progress_set(AV1RowMTProgress *row_progress, int r,
+                             int value) {
+#if CONFIG_MULTITHREAD
+  aom_atomic_int *const progress = &row_progress->progress[r];
+  int cur = aom_atomic_load_acquire(progress);
+  do {
+    if (cur >= value) return;
+  } while (!aom_atomic_compare_exchange(progress, &cur, value));
+
+  aom_atomic_thread_fence();
+  if (aom_atomic_load_acquire(&row_progress->num_waiters[r])) {
+    pthread_mutex_lock(&row_progress->mutex_[r]);
+    pthread_cond_broadcast(&row_progress->cond_[r]);
+    pthread_mutex_unlock(&row_progress->mutex_[r]);
+  }
+#else
+  (void)row_progress;
+  (void)r;
+  (void)value;
+#endif  // CONFIG_MULTITHREAD
+}
+
 // Deallocate lf synchronization related mutex and data
 void av1_loop_filter_dealloc(AV1LfSync *lf_sync) {
   if (lf_sync != NULL) {
@@ -844,14 +953,6 @@ static int loop_restoration_row_worker(void *arg1, void *arg2) {
   }
   error_info->setjmp = 1;
 
-  typedef void (*copy_fun)(const YV12_BUFFER_CONFIG *src_ybc,
-                           YV12_BUFFER_CONFIG *dst_ybc, int hstart, int hend,
-                           int vstart, int vend);
-  static const copy_fun copy_funs[MAX_MB_PLANE] = {
-    aom_yv12_partial_coloc_copy_y, aom_yv12_partial_coloc_copy_u,
-    aom_yv12_partial_coloc_copy_v
-  };
-
   while (1) {
     AV1LrMTInfo *cur_job_info = get_lr_job_info(lr_sync);
     if (cur_job_info != NULL) {
@@ -878,9 +979,6 @@ static int loop_restoration_row_worker(void *arg1, void *arg2) {
           lrworkerdata->rst_tmpbuf, lrworkerdata->rlbs, on_sync_read,
           on_sync_write, lr_sync, error_info);
 
-      copy_funs[plane](lr_ctxt->dst, lr_ctxt->frame, 0, plane_w,
-                       cur_job_info->v_copy_start, cur_job_info->v_copy_end);
-
       if (lrworkerdata->do_extend_border) {
         aom_extend_frame_borders_plane_row(lr_ctxt->frame, plane,
                                            cur_job_info->v_copy_start,
@@ -978,10 +1076,9 @@ static void foreach_rest_unit_in_planes_mt(AV1LrStruct *lr_ctxt,
 }
 
 void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
-                                          AV1_COMMON *cm, int optimized_lr,
-                                          AVxWorker *workers, int num_workers,
-                                          AV1LrSync *lr_sync, void *lr_ctxt,
-                                          int do_extend_border) {
+                                          AV1_COMMON *cm, AVxWorker *workers,
+                                          int num_workers, AV1LrSync *lr_sync,
+                                          void *lr_ctxt, int do_extend_border) {
   assert(!cm->features.all_lossless);
 
   const int num_planes = av1_num_planes(cm);
@@ -989,7 +1086,7 @@ void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
   AV1LrStruct *loop_rest_ctxt = (AV1LrStruct *)lr_ctxt;
 
   av1_loop_restoration_filter_frame_init(loop_rest_ctxt, frame, cm,
-                                         optimized_lr, num_planes);
+                                         num_planes);
 
   foreach_rest_unit_in_planes_mt(loop_rest_ctxt, workers, num_workers, lr_sync,
                                  cm, do_extend_border);
@@ -1247,6 +1344,120 @@ void av1_cdef_frame_mt(AV1_COMMON *const cm, MACROBLOCKD *const xd,
   sync_cdef_workers(workers, cm, num_workers);
 }
 
+// Height in luma rows of the bands processed by the superres upscale jobs.
+#define SUPERRES_BAND_HEIGHT 64
+
+// Data shared by the workers upscaling a frame with superres.
+typedef struct AV1SuperresSyncData {
+  const AV1_COMMON *cm;
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *dst;
+  // Number of bands in each plane.
+  int num_bands[MAX_MB_PLANE];
+  int num_jobs;
+  // Index of the next job to be processed.
+  aom_atomic_int next_job;
+  // Set by the worker which encounters an error, in order to abort the
+  // processing of the other workers.
+  aom_atomic_int mt_exit;
+} AV1SuperresSync;
+
+// Hook function for each thread in superres upscale multi-threading.
+static int superres_upscale_worker_hook(void *arg1, void *arg2) {
+  AV1SuperresSync *const superres_sync = (AV1SuperresSync *)arg1;
+  struct aom_internal_error_info *const error_info =
+      (struct aom_internal_error_info *)arg2;
+  const YV12_BUFFER_CONFIG *const src = superres_sync->src;
+
+  // The jmp_buf is valid only for the duration of the function that calls
+  // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
+  // before it returns.
+  if (setjmp(error_info->jmp)) {
+    error_info->setjmp = 0;
+    aom_atomic_store_release(&superres_sync->mt_exit, 1);
+    return 0;
+  }
+  error_info->setjmp = 1;
+
+  while (!aom_atomic_load_acquire(&superres_sync->mt_exit)) {
+    int job = aom_atomic_fetch_add(&superres_sync->next_job, 1);
+    if (job >= superres_sync->num_jobs) break;
+    int plane = 0;
+    while (job >= superres_sync->num_bands[plane]) {
+      job -= superres_sync->num_bands[plane];
+      ++plane;
+    }
+    const int is_uv = plane > 0;
+    const int band_height =
+        SUPERRES_BAND_HEIGHT >> (is_uv ? src->subsampling_y : 0);
+    const int row_start = job * band_height;
+    const int row_end =
+        AOMMIN(row_start + band_height, src->crop_heights[is_uv]);
+    av1_upscale_normative_and_extend_plane_rows(
+        superres_sync->cm, src, superres_sync->dst, plane, row_start, row_end,
+        error_info);
+  }
+  error_info->setjmp = 0;
+  return 1;
+}
+
+void av1_superres_upscale_frame_mt(const AV1_COMMON *cm,
+                                   const YV12_BUFFER_CONFIG *src,
+                                   YV12_BUFFER_CONFIG *dst, AVxWorker *workers,
+                                   int num_workers) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int num_planes = av1_num_planes(cm);
+  AV1SuperresSync superres_sync;
+  struct aom_internal_error_info *error_info;
+
+  superres_sync.cm = cm;
+  superres_sync.src = src;
+  superres_sync.dst = dst;
+  superres_sync.num_jobs = 0;
+  for (int plane = 0; plane < num_planes; ++plane) {
+    const int is_uv = plane > 0;
+    const int band_height =
+        SUPERRES_BAND_HEIGHT >> (is_uv ? src->subsampling_y : 0);
+    superres_sync.num_bands[plane] =
+        (src->crop_heights[is_uv] + band_height - 1) / band_height;
+    superres_sync.num_jobs += superres_sync.num_bands[plane];
+  }
+  aom_atomic_init(&superres_sync.next_job, 0);
+  aom_atomic_init(&superres_sync.mt_exit, 0);
+
+  CHECK_MEM_ERROR(cm, error_info,
+                  aom_calloc(num_workers, sizeof(*error_info)));
+  for (int i = num_workers - 1; i >= 0; --i) {
+    AVxWorker *const worker = &workers[i];
+    worker->hook = superres_upscale_worker_hook;
+    worker->data1 = &superres_sync;
+    worker->data2 = &error_info[i];
+    worker->had_error = 0;
+    if (i == 0) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+
+  // Wait till all bands are finished.
+  int had_error = workers[0].had_error;
+  int error_worker = 0;
+  for (int i = num_workers - 1; i > 0; --i) {
+    if (!winterface->sync(&workers[i])) {
+      had_error = 1;
+      error_worker = i;
+    }
+  }
+  if (had_error) {
+    struct aom_internal_error_info worker_error = error_info[error_worker];
+    aom_free(error_info);
+    aom_internal_error_copy(cm->error, &worker_error);
+  } else {
+    aom_free(error_info);
+  }
+}
+
 int av1_get_intrabc_extra_top_right_sb_delay(const AV1_COMMON *cm) {
   // No additional top-right delay when intraBC tool is not enabled.
   if (!av1_allow_intrabc(cm)) return 0;
@@ -16,6 +16,7 @@
 
 #include "av1/common/av1_loopfilter.h"
 #include "av1/common/cdef.h"
+#include "aom_util/aom_atomics.h"
 #include "aom_util/aom_pthread.h"
 #include "aom_util/aom_thread.h"
 
@@ -25,6 +26,22 @@ extern "C" {
 
 struct AV1Common;
 
+// Progress of the rows of a tile processed in row-based multi-threading. Each
+// row has a counter that only increases and is published without a lock.
+// Threads waiting on a row spin on its counter for a short while before
+// blocking on the row's condition variable.
+typedef struct AV1RowMTProgress {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+  // Number of threads blocked on each row.
+  aom_atomic_int *num_waiters;
+#endif
+  // Progress of each row, -1 before the row starts.
+  aom_atomic_int *progress;
+  int rows;
+} AV1RowMTProgress;
+
 typedef struct AV1LfMTInfo {
   int mi_row;
   int plane;
@@ -67,6 +84,9 @@ typedef struct AV1LrMTInfo {
   int lr_unit_row;
   int plane;
   int sync_mode;
+  // Rows which are final once the job is done, and whose borders it extends.
+  // The outer rows of an even row of units are left to the odd rows next to
+  // it, which swap them with the stripe boundary lines while being filtered.
   int v_copy_start;
   int v_copy_end;
 } AV1LrMTInfo;
@@ -174,6 +194,19 @@ void av1_alloc_cdef_sync(AV1_COMMON *const cm, AV1CdefSync *cdef_sync,
                          int num_workers);
 void av1_free_cdef_sync(AV1CdefSync *cdef_sync);
 
+void av1_row_mt_progress_alloc(AV1RowMTProgress *row_progress,
+                               struct AV1Common *cm, int rows);
+void av1_row_mt_progress_dealloc(AV1RowMTProgress *row_progress);
+// Resets the progress of all rows to -1.
+void av1_row_mt_progress_reset(AV1RowMTProgress *row_progress);
+// Waits until the progress of row r reaches at least value.
+void av1_row_mt_progress_wait(AV1RowMTProgress *row_progress, int r,
+                              int value);
+// Raises the progress of row r to value and wakes up the waiting threads. The
+// progress is left unchanged if it is already larger, as when it was set to
+// the end of the row after an error.
+void av1_row_mt_progress_set(AV1RowMTProgress *row_progress, int r, int value);
+
 // Deallocate loopfilter synchronization related mutex and data.
 void av1_loop_filter_dealloc(AV1LfSync *lf_sync);
 void av1_loop_filter_alloc(AV1LfSync *lf_sync, AV1_COMMON *cm, int rows,
@@ -191,15 +224,23 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
 #if !CONFIG_REALTIME_ONLY || CONFIG_AV1_DECODER
 void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
                                           struct AV1Common *cm,
-                                          int optimized_lr, AVxWorker *workers,
-                                          int num_workers, AV1LrSync *lr_sync,
-                                          void *lr_ctxt, int do_extend_border);
+                                          AVxWorker *workers, int num_workers,
+                                          AV1LrSync *lr_sync, void *lr_ctxt,
+                                          int do_extend_border);
 void av1_loop_restoration_dealloc(AV1LrSync *lr_sync);
 void av1_loop_restoration_alloc(AV1LrSync *lr_sync, AV1_COMMON *cm,
                                 int num_workers, int num_rows_lr,
                                 int num_planes, int width);
 #endif  // !CONFIG_REALTIME_ONLY || CONFIG_AV1_DECODER
 
+// Upscales src into dst with superres, and extends the borders of dst. The
+// rows of the planes are split into bands which the workers process
+// independently.
+void av1_superres_upscale_frame_mt(const AV1_COMMON *cm,
+                                   const YV12_BUFFER_CONFIG *src,
+                                   YV12_BUFFER_CONFIG *dst, AVxWorker *workers,
+                                   int num_workers);
+
 int av1_get_intrabc_extra_top_right_sb_delay(const AV1_COMMON *cm);
 
 void av1_thread_loop_filter_rows(
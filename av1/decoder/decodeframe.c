@@ -482,10 +482,13 @@ static inline void build_mc_border(const uint8_t *src, int src_stride,
   } while (--b_h);
 }
 
+// border_x and border_y give the width of the extended border of the
+// reference frame, which the block may read without building its own border.
 static inline int update_extend_mc_border_params(
     const struct scale_factors *const sf, struct buf_2d *const pre_buf,
     MV32 scaled_mv, PadBlock *block, int subpel_x_mv, int subpel_y_mv,
-    int do_warp, int is_intrabc, int *x_pad, int *y_pad) {
+    int do_warp, int is_intrabc, int border_x, int border_y, int *x_pad,
+    int *y_pad) {
   const int is_scaled = av1_is_scaled(sf);
   // Get reference width and height.
   int frame_width = pre_buf->width;
@@ -508,9 +511,9 @@ static inline int update_extend_mc_border_params(
       *y_pad = 1;
     }
 
-    // Skip border extension if block is inside the frame.
-    if (block->x0 < 0 || block->x1 > frame_width - 1 || block->y0 < 0 ||
-        block->y1 > frame_height - 1) {
+    // Skip border extension if block is inside the frame and its border.
+    if (block->x0 < -border_x || block->x1 > frame_width + border_x - 1 ||
+        block->y0 < -border_y || block->y1 > frame_height + border_y - 1) {
       return 1;
     }
   }
@@ -521,13 +524,13 @@ static inline void extend_mc_border(const struct scale_factors *const sf,
                                     struct buf_2d *const pre_buf,
                                     MV32 scaled_mv, PadBlock block,
                                     int subpel_x_mv, int subpel_y_mv,
-                                    int do_warp, int is_intrabc, int highbd,
-                                    uint8_t *mc_buf, uint8_t **pre,
-                                    int *src_stride) {
+                                    int do_warp, int is_intrabc, int border_x,
+                                    int border_y, int highbd, uint8_t *mc_buf,
+                                    uint8_t **pre, int *src_stride) {
   int x_pad = 0, y_pad = 0;
-  if (update_extend_mc_border_params(sf, pre_buf, scaled_mv, &block,
-                                     subpel_x_mv, subpel_y_mv, do_warp,
-                                     is_intrabc, &x_pad, &y_pad)) {
+  if (update_extend_mc_border_params(
+          sf, pre_buf, scaled_mv, &block, subpel_x_mv, subpel_y_mv, do_warp,
+          is_intrabc, border_x, border_y, &x_pad, &y_pad)) {
     // Get reference block pointer.
     const uint8_t *const buf_ptr =
         pre_buf->buf0 + block.y0 * pre_buf->stride + block.x0;
@@ -644,8 +647,9 @@ static inline void dec_calc_subpel_params(
 
 static inline void dec_calc_subpel_params_and_extend(
     const MV *const src_mv, InterPredParams *const inter_pred_params,
-    MACROBLOCKD *const xd, int mi_x, int mi_y, int ref, uint8_t **mc_buf,
-    uint8_t **pre, SubpelParams *subpel_params, int *src_stride) {
+    MACROBLOCKD *const xd, int mi_x, int mi_y, int ref,
+    const DecoderCodingBlock *dcb, uint8_t **pre, SubpelParams *subpel_params,
+    int *src_stride) {
   PadBlock block;
   MV32 scaled_mv;
   int subpel_x_mv, subpel_y_mv;
@@ -656,7 +660,9 @@ static inline void dec_calc_subpel_params_and_extend(
       inter_pred_params->scale_factors, &inter_pred_params->ref_frame_buf,
       scaled_mv, block, subpel_x_mv, subpel_y_mv,
       inter_pred_params->mode == WARP_PRED, inter_pred_params->is_intrabc,
-      inter_pred_params->use_hbd_buf, mc_buf[ref], pre, src_stride);
+      dcb->ref_border >> inter_pred_params->subsampling_x,
+      dcb->ref_border >> inter_pred_params->subsampling_y,
+      inter_pred_params->use_hbd_buf, dcb->mc_buf[ref], pre, src_stride);
 }
 
 #define IS_DEC 1
@@ -669,7 +675,7 @@ static void dec_build_inter_predictors(const AV1_COMMON *cm,
                                        int build_for_obmc, int bw, int bh,
                                        int mi_x, int mi_y) {
   build_inter_predictors(cm, &dcb->xd, plane, mi, build_for_obmc, bw, bh, mi_x,
-                         mi_y, dcb->mc_buf);
+                         mi_y, dcb);
 }
 
 static inline void dec_build_inter_predictor(const AV1_COMMON *cm,
@@ -2451,6 +2457,31 @@ static inline void get_tile_buffers(
   }
 }
 
+int av1_get_tile_group_buffers(AV1Decoder *pbi, const uint8_t *data,
+                               const uint8_t *data_end, int start_tile,
+                               int end_tile) {
+  const int tile_cols = pbi->common.tiles.cols;
+  const int tile_size_bytes = pbi->tile_size_bytes;
+
+  // Same checks as get_tile_buffers(), which reports them as errors.
+  for (int tile = start_tile; tile <= end_tile; ++tile) {
+    TileBufferDec *const buf =
+        &pbi->tile_buffers[tile / tile_cols][tile % tile_cols];
+    if (data >= data_end) return 0;
+    size_t size = data_end - data;
+    if (tile != end_tile) {
+      if (!read_is_valid(data, tile_size_bytes, data_end)) return 0;
+      size = mem_get_varsize(data, tile_size_bytes) + AV1_MIN_TILE_SIZE_BYTES;
+      data += tile_size_bytes;
+      if (size > (size_t)(data_end - data)) return 0;
+    }
+    buf->data = data;
+    buf->size = size;
+    data += size;
+  }
+  return 1;
+}
+
 static inline void set_cb_buffer(AV1Decoder *pbi, DecoderCodingBlock *dcb,
                                  CB_BUFFER *cb_buffer_base,
                                  const int num_planes, int mi_row, int mi_col) {
@@ -2509,30 +2540,7 @@ static inline int get_sync_range(int width) {
 static inline void dec_row_mt_alloc(AV1DecRowMTSync *dec_row_mt_sync,
                                     AV1_COMMON *cm, int rows) {
   dec_row_mt_sync->allocated_sb_rows = rows;
-#if CONFIG_MULTITHREAD
-  {
-    int i;
-
-    CHECK_MEM_ERROR(cm, dec_row_mt_sync->mutex_,
-                    aom_malloc(sizeof(*(dec_row_mt_sync->mutex_)) * rows));
-    if (dec_row_mt_sync->mutex_) {
-      for (i = 0; i < rows; ++i) {
-        pthread_mutex_init(&dec_row_mt_sync->mutex_[i], NULL);
-      }
-    }
-
-    CHECK_MEM_ERROR(cm, dec_row_mt_sync->cond_,
-                    aom_malloc(sizeof(*(dec_row_mt_sync->cond_)) * rows));
-    if (dec_row_mt_sync->cond_) {
-      for (i = 0; i < rows; ++i) {
-        pthread_cond_init(&dec_row_mt_sync->cond_[i], NULL);
-      }
-    }
-  }
-#endif  // CONFIG_MULTITHREAD
-
-  CHECK_MEM_ERROR(cm, dec_row_mt_sync->cur_sb_col,
-                  aom_malloc(sizeof(*(dec_row_mt_sync->cur_sb_col)) * rows));
+  av1_row_mt_progress_alloc(&dec_row_mt_sync->cur_sb_col, cm, rows);
 
   // Set up nsync.
   dec_row_mt_sync->sync_range = get_sync_range(cm->width);
@@ -2541,22 +2549,7 @@ static inline void dec_row_mt_alloc(AV1DecRowMTSync *dec_row_mt_sync,
 // Deallocate decoder row synchronization related mutex and data
 void av1_dec_row_mt_dealloc(AV1DecRowMTSync *dec_row_mt_sync) {
   if (dec_row_mt_sync != NULL) {
-#if CONFIG_MULTITHREAD
-    int i;
-    if (dec_row_mt_sync->mutex_ != NULL) {
-      for (i = 0; i < dec_row_mt_sync->allocated_sb_rows; ++i) {
-        pthread_mutex_destroy(&dec_row_mt_sync->mutex_[i]);
-      }
-      aom_free(dec_row_mt_sync->mutex_);
-    }
-    if (dec_row_mt_sync->cond_ != NULL) {
-      for (i = 0; i < dec_row_mt_sync->allocated_sb_rows; ++i) {
-        pthread_cond_destroy(&dec_row_mt_sync->cond_[i]);
-      }
-      aom_free(dec_row_mt_sync->cond_);
-    }
-#endif  // CONFIG_MULTITHREAD
-    aom_free(dec_row_mt_sync->cur_sb_col);
+    av1_row_mt_progress_dealloc(&dec_row_mt_sync->cur_sb_col);
 
     // clear the structure as the source of this call may be a resize in which
     // case this call will be followed by an _alloc() which may fail.
@@ -2570,14 +2563,9 @@ static inline void sync_read(AV1DecRowMTSync *const dec_row_mt_sync, int r,
   const int nsync = dec_row_mt_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &dec_row_mt_sync->mutex_[r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > dec_row_mt_sync->cur_sb_col[r - 1] - nsync -
-                   dec_row_mt_sync->intrabc_extra_top_right_sb_delay) {
-      pthread_cond_wait(&dec_row_mt_sync->cond_[r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
+    av1_row_mt_progress_wait(
+        &dec_row_mt_sync->cur_sb_col, r - 1,
+        c + nsync + dec_row_mt_sync->intrabc_extra_top_right_sb_delay);
   }
 #else
   (void)dec_row_mt_sync;
@@ -2600,14 +2588,7 @@ static inline void sync_write(AV1DecRowMTSync *const dec_row_mt_sync, int r,
     cur = sb_cols + nsync + dec_row_mt_sync->intrabc_extra_top_right_sb_delay;
   }
 
-  if (sig) {
-    pthread_mutex_lock(&dec_row_mt_sync->mutex_[r]);
-
-    dec_row_mt_sync->cur_sb_col[r] = cur;
-
-    pthread_cond_signal(&dec_row_mt_sync->cond_[r]);
-    pthread_mutex_unlock(&dec_row_mt_sync->mutex_[r]);
-  }
+  if (sig) av1_row_mt_progress_set(&dec_row_mt_sync->cur_sb_col, r, cur);
 #else
   (void)dec_row_mt_sync;
   (void)r;
@@ -3023,6 +3004,320 @@ static inline int get_max_row_mt_workers_per_tile(AV1_COMMON *cm,
   return max_workers;
 }
 
+static inline int frame_do_cdef(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  return !pbi->skip_loop_filter && !cm->features.coded_lossless &&
+         (cm->cdef_info.cdef_bits || cm->cdef_info.cdef_strengths[0] ||
+          cm->cdef_info.cdef_uv_strengths[0]);
+}
+
+static inline int frame_do_loop_restoration(const AV1_COMMON *cm) {
+  return cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
+}
+
+// Returns 1 if the in-loop filters of the frame can run in the filter pipeline
+// of row-based multi-threaded decoding. The whole frame must be decoded at
+// once, and the filter stages must not need the whole frame. The pipeline
+// also tracks the rows passed to pbi->row_output_cb, so it runs for those
+// frames even when they are not filtered.
+static int use_filter_pipeline(const AV1Decoder *pbi, int start_tile,
+                               int end_tile) {
+  const AV1_COMMON *const cm = &pbi->common;
+  const CommonTileParams *const tiles = &cm->tiles;
+  if (tiles->large_scale || tiles->single_tile_decoding ||
+      cm->features.allow_intrabc || av1_superres_scaled(cm))
+    return 0;
+  if (start_tile != 0 || end_tile != tiles->rows * tiles->cols - 1) return 0;
+  return pbi->row_output_rows >= 0 || cm->lf.filter_level[0] ||
+         cm->lf.filter_level[1] || frame_do_cdef(pbi) ||
+         frame_do_loop_restoration(cm);
+}
+
+// Returns 1 if the rows of the current frame are passed to
+// pbi->row_output_cb. Frames which get film grain are only output by
+// aom_codec_get_frame().
+static int frame_reports_output_rows(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  return pbi->row_output_cb != NULL && cm->show_frame &&
+         !cm->tiles.large_scale &&
+         !(cm->film_grain_params.apply_grain && !pbi->skip_film_grain);
+}
+
+// Passes the number of leading luma rows of the current frame which are final
+// to pbi->row_output_cb if it increased. When the filter pipeline runs, the
+// caller must hold pbi->row_mt_mutex_ so that the rows are reported in order.
+static void report_output_rows(AV1Decoder *const pbi, int rows_done) {
+  if (pbi->row_output_rows < 0 || rows_done <= pbi->row_output_rows) return;
+  pbi->row_output_rows = rows_done;
+  pbi->row_output_cb(pbi->row_output_priv, pbi->common.cur_frame, rows_done);
+}
+
+static void filter_pipeline_init(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
+  AV1DecFilterPipeline *const fp = &pbi->filter_pipeline;
+  YV12_BUFFER_CONFIG *const frame = &cm->cur_frame->buf;
+  MACROBLOCKD *const xd = &pbi->dcb.xd;
+  const int num_planes = av1_num_planes(cm);
+  const int mi_rows = cm->mi_params.mi_rows;
+
+  fp->sb_rows = CEIL_POWER_OF_TWO(mi_rows, cm->seq_params->mib_size_log2);
+  fp->lf_rows = CEIL_POWER_OF_TWO(mi_rows, MAX_MIB_SIZE_LOG2);
+  fp->cdef_rows = (mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+  fp->lr_stripes = av1_lr_count_stripes(cm);
+
+  if (fp->allocated_sb_rows < fp->sb_rows) {
+    aom_free(fp->num_tile_cols_done);
+    fp->num_tile_cols_done = NULL;
+    fp->allocated_sb_rows = 0;
+    CHECK_MEM_ERROR(
+        cm, fp->num_tile_cols_done,
+        aom_malloc(fp->sb_rows * sizeof(*fp->num_tile_cols_done)));
+    fp->allocated_sb_rows = fp->sb_rows;
+  }
+  if (fp->allocated_cdef_rows < fp->cdef_rows) {
+    aom_free(fp->cdef_row_done);
+    fp->cdef_row_done = NULL;
+    fp->allocated_cdef_rows = 0;
+    CHECK_MEM_ERROR(cm, fp->cdef_row_done,
+                    aom_malloc(fp->cdef_rows * sizeof(*fp->cdef_row_done)));
+    fp->allocated_cdef_rows = fp->cdef_rows;
+  }
+  memset(fp->num_tile_cols_done, 0,
+         fp->sb_rows * sizeof(*fp->num_tile_cols_done));
+  memset(fp->cdef_row_done, 0, fp->cdef_rows * sizeof(*fp->cdef_row_done));
+  fp->sb_rows_decoded = 0;
+  fp->lf_rows_started = 0;
+  fp->lf_rows_done = 0;
+  fp->cdef_rows_started = 0;
+  fp->cdef_rows_done = 0;
+  fp->lr_stripes_started = 0;
+  fp->lr_stripes_done = 0;
+
+  // The deblocking stage runs even when the frame is not deblocked, as it
+  // tells when the rows are ready for CDEF.
+  if ((cm->lf.filter_level[0] || cm->lf.filter_level[1]) &&
+      check_planes_to_loop_filter(&cm->lf, fp->planes_to_lf, 0, num_planes)) {
+    av1_loop_filter_frame_init(cm, 0, num_planes);
+  } else {
+    av1_zero(fp->planes_to_lf);
+  }
+  av1_setup_dst_planes(xd->plane, cm->seq_params->sb_size, frame, 0, 0, 0,
+                       num_planes);
+  loop_filter_data_reset(&fp->lf_data, frame, cm, xd);
+
+  // The chroma planes of a monochrome frame are only set once, before the
+  // rows are reported.
+  if (num_planes < 3) set_planes_to_neutral_grey(cm->seq_params, frame, 1);
+
+  fp->do_cdef = frame_do_cdef(pbi);
+  fp->do_loop_restoration = frame_do_loop_restoration(cm);
+  if (fp->do_cdef) {
+    av1_alloc_cdef_buffers(cm, &pbi->cdef_worker, &pbi->cdef_sync,
+                           pbi->num_workers, 1);
+    av1_alloc_cdef_sync(cm, &pbi->cdef_sync, pbi->num_workers);
+    pbi->cdef_sync.cdef_mt_exit = false;
+  }
+  // The CDEF stage also saves the boundary lines of loop restoration.
+  if (!fp->do_cdef && !fp->do_loop_restoration) {
+    fp->cdef_rows_started = fp->cdef_rows;
+    fp->cdef_rows_done = fp->cdef_rows;
+  }
+  if (fp->do_loop_restoration) {
+    av1_loop_restoration_filter_stripes_init(&pbi->lr_ctxt, frame, cm,
+                                             num_planes);
+  } else {
+    fp->lr_stripes_started = fp->lr_stripes;
+    fp->lr_stripes_done = fp->lr_stripes;
+  }
+  fp->enabled = 1;
+}
+
+// Returns the number of leading superblock rows which must be decoded before
+// deblocking row lf_row. Deblocking changes the last pixel row of lf_row,
+// which the intra prediction of the superblock row below it reads.
+static inline int lf_row_decode_deps(const AV1_COMMON *cm,
+                                     const AV1DecFilterPipeline *fp,
+                                     int lf_row) {
+  const int mi_row_below = (lf_row + 1) << MAX_MIB_SIZE_LOG2;
+  return AOMMIN(fp->sb_rows,
+                (mi_row_below >> cm->seq_params->mib_size_log2) + 1);
+}
+
+// Returns the number of leading deblocking rows which must be done before
+// CDEF row cdef_row. CDEF reads 2 pixel rows below cdef_row, and deblocking
+// changes up to 7 pixel rows above the edges of a row.
+static inline int cdef_row_lf_deps(const AV1DecFilterPipeline *fp,
+                                   int cdef_row) {
+  if (cdef_row == fp->cdef_rows - 1) return fp->lf_rows;
+  const int mi_rows = (cdef_row + 1) * MI_SIZE_64X64 + 4;
+  return AOMMIN(fp->lf_rows, CEIL_POWER_OF_TWO(mi_rows, MAX_MIB_SIZE_LOG2));
+}
+
+// Returns the number of leading CDEF rows which must be done before loop
+// restoration stripe lr_stripe. Apart from the last one, each stripe ends 8
+// luma rows above the end of the CDEF row with the same index.
+static inline int lr_stripe_cdef_deps(const AV1DecFilterPipeline *fp,
+                                      int lr_stripe) {
+  if (lr_stripe == fp->lr_stripes - 1) return fp->cdef_rows;
+  return AOMMIN(fp->cdef_rows, lr_stripe + 1);
+}
+
+static inline int filter_pipeline_done(const AV1DecFilterPipeline *fp) {
+  return fp->lf_rows_done == fp->lf_rows &&
+         fp->cdef_rows_done == fp->cdef_rows &&
+         fp->lr_stripes_done == fp->lr_stripes;
+}
+
+// Returns the number of leading luma rows of the frame which no stage of the
+// filter pipeline changes any more.
+static int filter_pipeline_rows_final(const AV1_COMMON *cm,
+                                      const AV1DecFilterPipeline *fp) {
+  if (filter_pipeline_done(fp)) return cm->height;
+  int rows;
+  if (fp->do_loop_restoration) {
+    // Each stripe but the first starts 8 luma rows above a 64-row boundary.
+    rows = fp->lr_stripes_done * RESTORATION_PROC_UNIT_SIZE -
+           RESTORATION_UNIT_OFFSET;
+  } else if (fp->do_cdef) {
+    rows = fp->cdef_rows_done * (MI_SIZE_64X64 << MI_SIZE_LOG2);
+  } else {
+    // Deblocking the next row changes up to 7 rows above it.
+    rows = fp->lf_rows_done * (MAX_MIB_SIZE << MI_SIZE_LOG2) - 8;
+  }
+  return clamp(rows, 0, cm->height);
+}
+
+// The caller must hold pbi->row_mt_mutex_. Returns 1 and stores the job in
+// *next_job_info if a row of a filter stage is ready. The later stages are
+// checked first, so that the rows closest to being final are finished first.
+static int get_next_filter_job(AV1Decoder *const pbi,
+                               AV1DecRowMTJobInfo *next_job_info) {
+  AV1DecFilterPipeline *const fp = &pbi->filter_pipeline;
+
+  if (fp->lr_stripes_started == fp->lr_stripes_done &&
+      fp->lr_stripes_started < fp->lr_stripes &&
+      fp->cdef_rows_done >= lr_stripe_cdef_deps(fp, fp->lr_stripes_started)) {
+    next_job_info->job_type = DEC_ROW_MT_LR_JOB;
+    next_job_info->filter_row = fp->lr_stripes_started++;
+    return 1;
+  }
+  // Unlike the other stages, CDEF filters several rows at a time.
+  if (fp->cdef_rows_started < fp->cdef_rows &&
+      fp->lf_rows_done >= cdef_row_lf_deps(fp, fp->cdef_rows_started)) {
+    next_job_info->job_type = DEC_ROW_MT_CDEF_JOB;
+    next_job_info->filter_row = fp->cdef_rows_started++;
+    return 1;
+  }
+  if (fp->lf_rows_started == fp->lf_rows_done &&
+      fp->lf_rows_started < fp->lf_rows &&
+      fp->sb_rows_decoded >=
+          lf_row_decode_deps(&pbi->common, fp, fp->lf_rows_started)) {
+    next_job_info->job_type = DEC_ROW_MT_LPF_JOB;
+    next_job_info->filter_row = fp->lf_rows_started++;
+    return 1;
+  }
+  return 0;
+}
+
+// The caller must hold pbi->row_mt_mutex_. Records that a tile column of the
+// superblock row at mi_row is decoded.
+static inline void filter_pipeline_sb_row_decoded(AV1Decoder *const pbi,
+                                                  int mi_row) {
+  const AV1_COMMON *const cm = &pbi->common;
+  AV1DecFilterPipeline *const fp = &pbi->filter_pipeline;
+  const int sb_row = mi_row >> cm->seq_params->mib_size_log2;
+
+  if (++fp->num_tile_cols_done[sb_row] < cm->tiles.cols) return;
+  while (fp->sb_rows_decoded < fp->sb_rows &&
+         fp->num_tile_cols_done[fp->sb_rows_decoded] == cm->tiles.cols) {
+    ++fp->sb_rows_decoded;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_cond_broadcast(pbi->row_mt_cond_);
+#endif
+}
+
+static void run_filter_job(AV1Decoder *const pbi,
+                           DecWorkerData *const thread_data,
+                           const AV1DecRowMTJobInfo *job_info) {
+  AV1_COMMON *const cm = &pbi->common;
+  AV1DecFilterPipeline *const fp = &pbi->filter_pipeline;
+  YV12_BUFFER_CONFIG *const frame = &cm->cur_frame->buf;
+  const int num_planes = av1_num_planes(cm);
+  const int row = job_info->filter_row;
+
+  switch (job_info->job_type) {
+    case DEC_ROW_MT_LPF_JOB: {
+      LFWorkerData *const lf_data = &fp->lf_data;
+      for (int plane = 0; plane < num_planes; ++plane) {
+        if (!fp->planes_to_lf[plane]) continue;
+        for (int dir = 0; dir < 2; ++dir) {
+          av1_thread_loop_filter_rows(
+              frame, cm, lf_data->planes, lf_data->xd,
+              row << MAX_MIB_SIZE_LOG2, plane, dir, /*lpf_opt_level=*/0,
+              /*lf_sync=*/NULL, &thread_data->error_info, lf_data->params_buf,
+              lf_data->tx_buf, MAX_MIB_SIZE_LOG2);
+        }
+      }
+      break;
+    }
+    case DEC_ROW_MT_CDEF_JOB: {
+      const int row_start = row * (MI_SIZE_64X64 << MI_SIZE_LOG2);
+      const int row_end = row == fp->cdef_rows - 1
+                              ? cm->height
+                              : row_start + (MI_SIZE_64X64 << MI_SIZE_LOG2);
+      // The boundary lines of the stripes are saved before and after CDEF
+      // changes the rows.
+      if (fp->do_loop_restoration) {
+        av1_loop_restoration_save_boundary_lines_in_rows(frame, cm, row_start,
+                                                         row_end, 0);
+      }
+      if (fp->do_cdef) {
+        const int worker_idx = (int)(thread_data - pbi->thread_data);
+        AV1CdefWorkerData *const cdef_worker = &pbi->cdef_worker[worker_idx];
+        av1_cdef_fb_row(
+            cm, &pbi->dcb.xd, cm->cdef_info.linebuf,
+            worker_idx ? cdef_worker->colbuf : cm->cdef_info.colbuf,
+            worker_idx ? cdef_worker->srcbuf : cm->cdef_info.srcbuf, row,
+            av1_cdef_init_fb_row_mt, &pbi->cdef_sync, &thread_data->error_info);
+      }
+      if (fp->do_loop_restoration) {
+        av1_loop_restoration_save_boundary_lines_in_rows(frame, cm, row_start,
+                                                         row_end, 1);
+      }
+      break;
+    }
+    case DEC_ROW_MT_LR_JOB:
+      av1_loop_restoration_filter_stripe(&pbi->lr_ctxt, cm, row, num_planes,
+                                         cm->rst_tmpbuf, cm->rlbs,
+                                         &thread_data->error_info);
+      break;
+    default: assert(0 && "Invalid filter job type");
+  }
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(pbi->row_mt_mutex_);
+#endif
+  switch (job_info->job_type) {
+    case DEC_ROW_MT_LPF_JOB: ++fp->lf_rows_done; break;
+    case DEC_ROW_MT_CDEF_JOB:
+      fp->cdef_row_done[row] = 1;
+      while (fp->cdef_rows_done < fp->cdef_rows &&
+             fp->cdef_row_done[fp->cdef_rows_done]) {
+        ++fp->cdef_rows_done;
+      }
+      break;
+    default: ++fp->lr_stripes_done; break;
+  }
+  report_output_rows(pbi, filter_pipeline_rows_final(cm, fp));
+#if CONFIG_MULTITHREAD
+  pthread_cond_broadcast(pbi->row_mt_cond_);
+  pthread_mutex_unlock(pbi->row_mt_mutex_);
+#endif
+}
+
 // The caller must hold pbi->row_mt_mutex_ when calling this function.
 // Returns 1 if either the next job is stored in *next_job_info or 1 is stored
 // in *end_of_frame.
@@ -3031,6 +3326,7 @@ static inline int get_max_row_mt_workers_per_tile(AV1_COMMON *cm,
 // - frame_row_mt_info->mi_rows_parse_done
 // - frame_row_mt_info->mi_rows_decode_started
 // - frame_row_mt_info->row_mt_exit
+// - the progress of the stages of pbi->filter_pipeline, when it is enabled
 // Therefore we may need to signal or broadcast pbi->row_mt_cond_ if any of
 // these variables is modified.
 static int get_next_job_info(AV1Decoder *const pbi,
@@ -3061,6 +3357,18 @@ static int get_next_job_info(AV1Decoder *const pbi,
   *end_of_frame = (frame_row_mt_info->mi_rows_decode_started ==
                    frame_row_mt_info->mi_rows_to_decode) ||
                   (frame_row_mt_info->row_mt_exit == 1);
+  if (pbi->filter_pipeline.enabled && !frame_row_mt_info->row_mt_exit) {
+    // Filter jobs come first, so that the rows are final as early as possible.
+    // The workers keep going until the whole frame is filtered.
+    if (get_next_filter_job(pbi, next_job_info)) {
+      *end_of_frame = 0;
+      return 1;
+    }
+    if (*end_of_frame) {
+      *end_of_frame = filter_pipeline_done(&pbi->filter_pipeline);
+      return *end_of_frame;
+    }
+  }
   if (*end_of_frame) {
     return 1;
   }
@@ -3206,6 +3514,8 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
   ThreadData *const td = thread_data->td;
   uint8_t allow_update_cdf;
   AV1DecRowMTInfo *frame_row_mt_info = &pbi->frame_row_mt_info;
+  // Set while the worker runs a filter job rather than a decode job.
+  volatile int filtering = 0;
   td->dcb.corrupted = 0;
 
   // The jmp_buf is valid only for the duration of the function that calls
@@ -3227,7 +3537,9 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     // of the erroneous row is complete. This ensures that other threads which
     // wait upon the completion of SB's present in erroneous row are not waiting
     // indefinitely.
-    signal_decoding_done_for_erroneous_row(pbi, &thread_data->td->dcb.xd);
+    if (!filtering) {
+      signal_decoding_done_for_erroneous_row(pbi, &thread_data->td->dcb.xd);
+    }
     return 0;
   }
   thread_data->error_info.setjmp = 1;
@@ -3301,6 +3613,13 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
 
     if (end_of_frame) break;
 
+    if (next_job_info.job_type != DEC_ROW_MT_DECODE_JOB) {
+      filtering = 1;
+      run_filter_job(pbi, thread_data, &next_job_info);
+      filtering = 0;
+      continue;
+    }
+
     int tile_row = next_job_info.tile_row;
     int tile_col = next_job_info.tile_col;
     int mi_row = next_job_info.mi_row;
@@ -3319,6 +3638,9 @@ static int row_mt_worker_hook(void *arg1, void *arg2) {
     pthread_mutex_lock(pbi->row_mt_mutex_);
 #endif
     dec_row_mt_sync->num_threads_working--;
+    if (pbi->filter_pipeline.enabled) {
+      filter_pipeline_sb_row_decoded(pbi, mi_row);
+    }
 #if CONFIG_MULTITHREAD
     pthread_mutex_unlock(pbi->row_mt_mutex_);
 #endif
@@ -3565,7 +3887,7 @@ static inline void tile_mt_queue(AV1Decoder *pbi, int tile_cols, int tile_rows,
 
 static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
                                       const uint8_t *data_end, int start_tile,
-                                      int end_tile) {
+                                      int end_tile, int tiles_located) {
   AV1_COMMON *const cm = &pbi->common;
   CommonTileParams *const tiles = &cm->tiles;
   const int tile_cols = tiles->cols;
@@ -3616,13 +3938,15 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
   decode_mt_init(pbi);
 
   // get tile size in tile group
+  if (!tiles_located) {
 #if EXT_TILE_DEBUG
-  if (tiles->large_scale) assert(pbi->ext_tile_debug == 1);
-  if (tiles->large_scale)
-    raw_data_end = get_ls_tile_buffers(pbi, data, data_end, tile_buffers);
-  else
+    if (tiles->large_scale) assert(pbi->ext_tile_debug == 1);
+    if (tiles->large_scale)
+      raw_data_end = get_ls_tile_buffers(pbi, data, data_end, tile_buffers);
+    else
 #endif  // EXT_TILE_DEBUG
-    get_tile_buffers(pbi, data, data_end, tile_buffers, start_tile, end_tile);
+      get_tile_buffers(pbi, data, data_end, tile_buffers, start_tile, end_tile);
+  }
 
   if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
     decoder_alloc_tile_data(pbi, n_tiles);
@@ -3680,7 +4004,7 @@ static inline void dec_alloc_cb_buf(AV1Decoder *pbi) {
 static inline void row_mt_frame_init(AV1Decoder *pbi, int tile_rows_start,
                                      int tile_rows_end, int tile_cols_start,
                                      int tile_cols_end, int start_tile,
-                                     int end_tile, int max_sb_rows) {
+                                     int end_tile) {
   AV1_COMMON *const cm = &pbi->common;
   AV1DecRowMTInfo *frame_row_mt_info = &pbi->frame_row_mt_info;
 
@@ -3721,8 +4045,7 @@ static inline void row_mt_frame_init(AV1Decoder *pbi, int tile_rows_start,
           tile_data->dec_row_mt_sync.mi_rows;
 
       // Initialize cur_sb_col to -1 for all SB rows.
-      memset(tile_data->dec_row_mt_sync.cur_sb_col, -1,
-             sizeof(*tile_data->dec_row_mt_sync.cur_sb_col) * max_sb_rows);
+      av1_row_mt_progress_reset(&tile_data->dec_row_mt_sync.cur_sb_col);
     }
   }
 
@@ -3747,7 +4070,8 @@ static inline void row_mt_frame_init(AV1Decoder *pbi, int tile_rows_start,
 
 static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
                                           const uint8_t *data_end,
-                                          int start_tile, int end_tile) {
+                                          int start_tile, int end_tile,
+                                          int tiles_located) {
   AV1_COMMON *const cm = &pbi->common;
   CommonTileParams *const tiles = &cm->tiles;
   const int tile_cols = tiles->cols;
@@ -3802,13 +4126,15 @@ static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
   decode_mt_init(pbi);
 
   // get tile size in tile group
+  if (!tiles_located) {
 #if EXT_TILE_DEBUG
-  if (tiles->large_scale) assert(pbi->ext_tile_debug == 1);
-  if (tiles->large_scale)
-    raw_data_end = get_ls_tile_buffers(pbi, data, data_end, tile_buffers);
-  else
+    if (tiles->large_scale) assert(pbi->ext_tile_debug == 1);
+    if (tiles->large_scale)
+      raw_data_end = get_ls_tile_buffers(pbi, data, data_end, tile_buffers);
+    else
 #endif  // EXT_TILE_DEBUG
-    get_tile_buffers(pbi, data, data_end, tile_buffers, start_tile, end_tile);
+      get_tile_buffers(pbi, data, data_end, tile_buffers, start_tile, end_tile);
+  }
 
   if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
     if (pbi->tile_data != NULL) {
@@ -3834,7 +4160,11 @@ static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
       num_workers += get_max_row_mt_workers_per_tile(cm, &tile_data->tile_info);
     }
   }
-  num_workers = AOMMIN(num_workers, max_threads);
+  const int filter_pipeline = use_filter_pipeline(pbi, start_tile, end_tile);
+  // The filter stages keep the workers busy beyond the number of workers
+  // which can decode the tiles.
+  num_workers =
+      filter_pipeline ? max_threads : AOMMIN(num_workers, max_threads);
 
   if (pbi->allocated_row_mt_sync_rows != max_sb_rows) {
     for (int i = 0; i < n_tiles; ++i) {
@@ -3851,7 +4181,8 @@ static const uint8_t *decode_tiles_row_mt(AV1Decoder *pbi, const uint8_t *data,
   dec_alloc_cb_buf(pbi);
 
   row_mt_frame_init(pbi, tile_rows_start, tile_rows_end, tile_cols_start,
-                    tile_cols_end, start_tile, end_tile, max_sb_rows);
+                    tile_cols_end, start_tile, end_tile);
+  if (filter_pipeline) filter_pipeline_init(pbi);
 
   reset_dec_workers(pbi, row_mt_worker_hook, num_workers);
   launch_dec_workers(pbi, data_end, num_workers);
@@ -4840,6 +5171,7 @@ static int read_uncompressed_header(AV1Decoder *pbi,
           // use a different approach.
           cm->ref_frame_map[ref_idx] = buf;
           buf->order_hint = order_hint;
+          buf->border_extended = 0;
         }
       }
     }
@@ -5169,7 +5501,9 @@ static inline void superres_post_decode(AV1Decoder *pbi) {
   if (!av1_superres_scaled(cm)) return;
   assert(!cm->features.all_lossless);
 
-  av1_superres_upscale(cm, pool, 0);
+  dec_start_stage_timing(pbi, kDecStageSuperres);
+  av1_superres_upscale(cm, pool, 0, pbi->tile_workers, pbi->num_workers);
+  dec_end_stage_timing(pbi, kDecStageSuperres);
 }
 
 uint32_t av1_decode_frame_headers_and_setup(AV1Decoder *pbi,
@@ -5273,31 +5607,40 @@ static inline void setup_frame_info(AV1Decoder *pbi) {
   }
 }
 
-void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
-                                    const uint8_t *data_end,
-                                    const uint8_t **p_data_end, int start_tile,
-                                    int end_tile, int initialize_flag) {
+// Extends the borders of the reference frames of the current frame which are
+// not extended yet. Returns the width in luma pixels of the border that motion
+// compensation may read from all of them, or 0 if the borders are not used.
+static int extend_ref_frame_borders(AV1Decoder *pbi) {
   AV1_COMMON *const cm = &pbi->common;
-  CommonTileParams *const tiles = &cm->tiles;
-  MACROBLOCKD *const xd = &pbi->dcb.xd;
-  const int tile_count_tg = end_tile - start_tile + 1;
+  if (!pbi->extend_ref_borders || frame_is_intra_only(cm) ||
+      cm->tiles.large_scale)
+    return 0;
 
-  xd->error_info = cm->error;
-  if (initialize_flag) setup_frame_info(pbi);
   const int num_planes = av1_num_planes(cm);
+  int border = AOM_BORDER_IN_PIXELS;
+  for (MV_REFERENCE_FRAME ref = LAST_FRAME; ref <= ALTREF_FRAME; ++ref) {
+    RefCntBuffer *const buf = get_ref_frame_buf(cm, ref);
+    if (buf == NULL) continue;
+    // The planes of an external reference belong to the application.
+    if (buf->buf.use_external_reference_buffers) return 0;
+    if (!buf->border_extended) {
+      aom_extend_frame_borders(&buf->buf, num_planes);
+      buf->border_extended = 1;
+    }
+    border = AOMMIN(border, buf->buf.border);
+  }
+  return border;
+}
 
-  if (pbi->max_threads > 1 && !(tiles->large_scale && !pbi->ext_tile_debug) &&
-      pbi->row_mt)
-    *p_data_end =
-        decode_tiles_row_mt(pbi, data, data_end, start_tile, end_tile);
-  else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
-           !(tiles->large_scale && !pbi->ext_tile_debug))
-    *p_data_end = decode_tiles_mt(pbi, data, data_end, start_tile, end_tile);
-  else
-    *p_data_end = decode_tiles(pbi, data, data_end, start_tile, end_tile);
+// Finishes the frame after its tile group up to 'end_tile' is decoded.
+static void decode_tg_wrapup(AV1Decoder *pbi, int end_tile) {
+  AV1_COMMON *const cm = &pbi->common;
+  CommonTileParams *const tiles = &cm->tiles;
+  MACROBLOCKD *const xd = &pbi->dcb.xd;
+  const int num_planes = av1_num_planes(cm);
 
   // If the bit stream is monochrome, set the U and V buffers to a constant.
-  if (num_planes < 3) {
+  if (num_planes < 3 && !pbi->filter_pipeline.enabled) {
     set_planes_to_neutral_grey(cm->seq_params, xd->cur_buf, 1);
   }
 
@@ -5309,74 +5652,58 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                          pbi->num_workers, 1);
   av1_alloc_cdef_sync(cm, &pbi->cdef_sync, pbi->num_workers);
 
-  if (!cm->features.allow_intrabc && !tiles->single_tile_decoding) {
+  // The filters already ran behind the decoding of the rows in the pipeline.
+  if (!cm->features.allow_intrabc && !tiles->single_tile_decoding &&
+      !pbi->filter_pipeline.enabled) {
     if (cm->lf.filter_level[0] || cm->lf.filter_level[1]) {
+      dec_start_stage_timing(pbi, kDecStageLoopFilter);
       av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, &pbi->dcb.xd, 0,
                                num_planes, 0, pbi->tile_workers,
                                pbi->num_workers, &pbi->lf_row_sync, 0);
+      dec_end_stage_timing(pbi, kDecStageLoopFilter);
     }
 
-    const int do_cdef =
-        !pbi->skip_loop_filter && !cm->features.coded_lossless &&
-        (cm->cdef_info.cdef_bits || cm->cdef_info.cdef_strengths[0] ||
-         cm->cdef_info.cdef_uv_strengths[0]);
-    const int do_superres = av1_superres_scaled(cm);
-    const int optimized_loop_restoration = !do_cdef && !do_superres;
-    const int do_loop_restoration =
-        cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
-        cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
-        cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
+    const int do_cdef = frame_do_cdef(pbi);
+    const int do_loop_restoration = frame_do_loop_restoration(cm);
     // Frame border extension is not required in the decoder
     // as it happens in extend_mc_border().
     int do_extend_border_mt = 0;
-    if (!optimized_loop_restoration) {
-      if (do_loop_restoration)
-        av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
-                                                 cm, 0);
-
-      if (do_cdef) {
-        if (pbi->num_workers > 1) {
-          av1_cdef_frame_mt(cm, &pbi->dcb.xd, pbi->cdef_worker,
-                            pbi->tile_workers, &pbi->cdef_sync,
-                            pbi->num_workers, av1_cdef_init_fb_row_mt,
-                            do_extend_border_mt);
-        } else {
-          av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->dcb.xd,
-                         av1_cdef_init_fb_row);
-        }
+    // Loop restoration filters the frame in place, so it needs the saved
+    // stripe boundary lines even when CDEF and superres leave the deblocked
+    // rows untouched.
+    if (do_loop_restoration)
+      av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf, cm,
+                                               0);
+
+    if (do_cdef) {
+      dec_start_stage_timing(pbi, kDecStageCdef);
+      if (pbi->num_workers > 1) {
+        av1_cdef_frame_mt(cm, &pbi->dcb.xd, pbi->cdef_worker, pbi->tile_workers,
+                          &pbi->cdef_sync, pbi->num_workers,
+                          av1_cdef_init_fb_row_mt, do_extend_border_mt);
+      } else {
+        av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->dcb.xd,
+                       av1_cdef_init_fb_row);
       }
+      dec_end_stage_timing(pbi, kDecStageCdef);
+    }
 
-      superres_post_decode(pbi);
-
-      if (do_loop_restoration) {
-        av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
-                                                 cm, 1);
-        if (pbi->num_workers > 1) {
-          av1_loop_restoration_filter_frame_mt(
-              (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
-              pbi->tile_workers, pbi->num_workers, &pbi->lr_row_sync,
-              &pbi->lr_ctxt, do_extend_border_mt);
-        } else {
-          av1_loop_restoration_filter_frame((YV12_BUFFER_CONFIG *)xd->cur_buf,
-                                            cm, optimized_loop_restoration,
-                                            &pbi->lr_ctxt);
-        }
-      }
-    } else {
-      // In no cdef and no superres case. Provide an optimized version of
-      // loop_restoration_filter.
-      if (do_loop_restoration) {
-        if (pbi->num_workers > 1) {
-          av1_loop_restoration_filter_frame_mt(
-              (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
-              pbi->tile_workers, pbi->num_workers, &pbi->lr_row_sync,
-              &pbi->lr_ctxt, do_extend_border_mt);
-        } else {
-          av1_loop_restoration_filter_frame((YV12_BUFFER_CONFIG *)xd->cur_buf,
-                                            cm, optimized_loop_restoration,
-                                            &pbi->lr_ctxt);
-        }
+    superres_post_decode(pbi);
+
+    if (do_loop_restoration) {
+      dec_start_stage_timing(pbi, kDecStageRestoration);
+      av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf, cm,
+                                               1);
+      if (pbi->num_workers > 1) {
+        av1_loop_restoration_filter_frame_mt(
+            (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, pbi->tile_workers,
+            pbi->num_workers, &pbi->lr_row_sync, &pbi->lr_ctxt,
+            do_extend_border_mt);
+      } else {
+        av1_loop_restoration_filter_frame((YV12_BUFFER_CONFIG *)xd->cur_buf,
+                                          cm, &pbi->lr_ctxt);
       }
+      dec_end_stage_timing(pbi, kDecStageRestoration);
     }
   }
 
@@ -5390,6 +5717,7 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
     aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
                        "Decode failed. Frame data is corrupted.");
   }
+  report_output_rows(pbi, cm->cur_frame->buf.y_crop_height);
 
 #if CONFIG_INSPECTION
   if (pbi->inspect_cb != NULL) {
@@ -5406,3 +5734,123 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
     ++cm->current_frame.frame_number;
   }
 }
+
+static void decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
+                                       const uint8_t *data_end,
+                                       const uint8_t **p_data_end,
+                                       int start_tile, int end_tile,
+                                       int initialize_flag, int tiles_located) {
+  AV1_COMMON *const cm = &pbi->common;
+  CommonTileParams *const tiles = &cm->tiles;
+  const int tile_count_tg = end_tile - start_tile + 1;
+
+  pbi->dcb.xd.error_info = cm->error;
+  if (initialize_flag) {
+    setup_frame_info(pbi);
+    pbi->row_output_rows = frame_reports_output_rows(pbi) ? 0 : -1;
+    pbi->dcb.ref_border = extend_ref_frame_borders(pbi);
+  }
+  pbi->filter_pipeline.enabled = 0;
+
+  dec_start_stage_timing(pbi, kDecStageDecodeTiles);
+  if (pbi->max_threads > 1 && !(tiles->large_scale && !pbi->ext_tile_debug) &&
+      pbi->row_mt)
+    *p_data_end = decode_tiles_row_mt(pbi, data, data_end, start_tile,
+                                      end_tile, tiles_located);
+  else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
+           !(tiles->large_scale && !pbi->ext_tile_debug))
+    *p_data_end = decode_tiles_mt(pbi, data, data_end, start_tile, end_tile,
+                                  tiles_located);
+  else
+    *p_data_end = decode_tiles(pbi, data, data_end, start_tile, end_tile);
+  dec_end_stage_timing(pbi, kDecStageDecodeTiles);
+
+  decode_tg_wrapup(pbi, end_tile);
+}
+
+void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
+                                    const uint8_t *data_end,
+                                    const uint8_t **p_data_end, int start_tile,
+                                    int end_tile, int initialize_flag) {
+  decode_tg_tiles_and_wrapup(pbi, data, data_end, p_data_end, start_tile,
+                             end_tile, initialize_flag, 0);
+}
+
+void av1_decode_located_tiles_and_wrapup(AV1Decoder *pbi,
+                                         const uint8_t *data_end,
+                                         const uint8_t **p_data_end,
+                                         int start_tile, int end_tile,
+                                         int initialize_flag) {
+  const CommonTileParams *const tiles = &pbi->common.tiles;
+  const int last_tile = tiles->rows * tiles->cols - 1;
+  const uint8_t *frame_tiles_end;
+
+  // The tile workers take the tiles of all the tile groups at once.
+  assert(pbi->max_threads > 1 && !tiles->large_scale);
+  assert(end_tile < last_tile);
+  decode_tg_tiles_and_wrapup(pbi, NULL, data_end, &frame_tiles_end,
+                             start_tile, last_tile, initialize_flag, 1);
+  *p_data_end = av1_get_tile_group_end(pbi, end_tile);
+}
+
+const uint8_t *av1_get_tile_group_end(AV1Decoder *pbi, int end_tile) {
+  return aom_reader_find_end(&pbi->tile_data[end_tile].bit_reader);
+}
+
+void av1_decode_tile_list_tiles_mt(AV1Decoder *pbi, const uint8_t *data_end,
+                                   const int *tile_ids, int num_tiles) {
+  AV1_COMMON *const cm = &pbi->common;
+  CommonTileParams *const tiles = &cm->tiles;
+  const int n_tiles = tiles->cols * tiles->rows;
+  const int num_workers = AOMMIN(pbi->max_threads, num_tiles);
+  AV1DecTileMT *const tile_mt_info = &pbi->tile_mt_info;
+
+  // Otherwise the frame is filtered after each tile.
+  assert(tiles->large_scale && tiles->single_tile_decoding);
+  assert(num_tiles > 0 && num_tiles <= n_tiles);
+
+  pbi->dcb.xd.error_info = cm->error;
+  pbi->filter_pipeline.enabled = 0;
+
+  decode_mt_init(pbi);
+  if (pbi->tile_data == NULL || n_tiles != pbi->allocated_tiles) {
+    decoder_alloc_tile_data(pbi, n_tiles);
+  }
+  if (pbi->dcb.xd.seg_mask == NULL)
+    CHECK_MEM_ERROR(cm, pbi->dcb.xd.seg_mask,
+                    (uint8_t *)aom_memalign(
+                        16, 2 * MAX_SB_SQUARE * sizeof(*pbi->dcb.xd.seg_mask)));
+  if (tile_mt_info->alloc_tile_cols != tiles->cols ||
+      tile_mt_info->alloc_tile_rows != tiles->rows) {
+    av1_dealloc_dec_jobs(tile_mt_info);
+    alloc_dec_jobs(tile_mt_info, cm, tiles->rows, tiles->cols);
+  }
+
+  tile_mt_info->jobs_enqueued = 0;
+  tile_mt_info->jobs_dequeued = 0;
+  for (int i = 0; i < num_tiles; ++i) {
+    const int row = tile_ids[i] / tiles->cols;
+    const int col = tile_ids[i] % tiles->cols;
+    TileJobsDec *const job = &tile_mt_info->job_queue[i];
+    job->tile_buffer = &pbi->tile_buffers[row][col];
+    job->tile_data = pbi->tile_data + tile_ids[i];
+    av1_tile_init(&job->tile_data->tile_info, cm, row, col);
+    tile_mt_info->jobs_enqueued++;
+  }
+  qsort(tile_mt_info->job_queue, tile_mt_info->jobs_enqueued,
+        sizeof(tile_mt_info->job_queue[0]), compare_tile_buffers);
+
+  dec_start_stage_timing(pbi, kDecStageDecodeTiles);
+  reset_dec_workers(pbi, tile_worker_hook, num_workers);
+  launch_dec_workers(pbi, data_end, num_workers);
+  sync_dec_workers(pbi, num_workers);
+  dec_end_stage_timing(pbi, kDecStageDecodeTiles);
+
+  if (pbi->dcb.corrupted)
+    aom_internal_error(&pbi->error, AOM_CODEC_CORRUPT_FRAME,
+                       "Failed to decode tile data");
+
+  // Leave the frame in the state that decoding the tiles one after the other
+  // with av1_decode_tg_tiles_and_wrapup() would.
+  for (int i = 0; i < num_tiles; ++i) decode_tg_wrapup(pbi, n_tiles - 1);
+}
@@ -44,6 +44,38 @@ void av1_decode_tg_tiles_and_wrapup(struct AV1Decoder *pbi, const uint8_t *data,
                                     const uint8_t **p_data_end, int start_tile,
                                     int end_tile, int initialize_flag);
 
+// Locates the tiles from 'start_tile' to 'end_tile' of the tile group whose
+// tile data runs from 'data' to 'data_end', and stores them in
+// pbi->tile_buffers. Returns 0 if the tile sizes do not fit in the tile group.
+int av1_get_tile_group_buffers(struct AV1Decoder *pbi, const uint8_t *data,
+                               const uint8_t *data_end, int start_tile,
+                               int end_tile);
+
+// Decodes all the tiles of the frame from 'start_tile' on with the tile
+// workers, then wraps up the frame. The tiles span several tile groups, which
+// must all have been located with av1_get_tile_group_buffers(), and
+// 'data_end' is the end of the last one. Sets '*p_data_end' to the end of the
+// tile data of the tile group that ends at 'end_tile'.
+void av1_decode_located_tiles_and_wrapup(struct AV1Decoder *pbi,
+                                         const uint8_t *data_end,
+                                         const uint8_t **p_data_end,
+                                         int start_tile, int end_tile,
+                                         int initialize_flag);
+
+// Returns the end of the tile data of the tile group that ends at 'end_tile',
+// after av1_decode_located_tiles_and_wrapup() decoded it.
+const uint8_t *av1_get_tile_group_end(struct AV1Decoder *pbi, int end_tile);
+
+// Decodes tiles of a tile list in large scale tile mode on the tile workers.
+// The tiles must be at distinct positions of the camera frame and use the
+// same anchor frame. 'tile_ids' holds the positions, as
+// tile_row * tiles.cols + tile_col, and pbi->tile_buffers the coded data of
+// each tile. Each tile is wrapped up as if decoded with
+// av1_decode_tg_tiles_and_wrapup().
+void av1_decode_tile_list_tiles_mt(struct AV1Decoder *pbi,
+                                   const uint8_t *data_end,
+                                   const int *tile_ids, int num_tiles);
+
 // Implements the color_config() function in the spec. Reports errors by
 // calling rb->error_handler() or aom_internal_error().
 void av1_read_color_config(struct aom_read_bit_buffer *rb,
@@ -179,6 +179,7 @@ void av1_decoder_remove(AV1Decoder *pbi) {
 
   // Free the tile list output buffer.
   aom_free_frame_buffer(&pbi->tile_list_outbuf);
+  av1_tile_cache_free(&pbi->tile_cache);
 
   aom_get_worker_interface()->end(&pbi->lf_worker);
   aom_free(pbi->lf_worker.data1);
@@ -215,6 +216,8 @@ void av1_decoder_remove(AV1Decoder *pbi) {
   }
   aom_free(pbi->tile_data);
   aom_free(pbi->tile_workers);
+  aom_free(pbi->filter_pipeline.num_tile_cols_done);
+  aom_free(pbi->filter_pipeline.cdef_row_done);
 
   if (pbi->num_workers > 0) {
     av1_loop_filter_dealloc(&pbi->lf_row_sync);
@@ -303,6 +306,7 @@ aom_codec_err_t av1_set_reference_dec(AV1_COMMON *cm, int idx,
     } else {
       // Overwrite the reference frame buffer.
       aom_yv12_copy_frame(sd, ref_buf, num_planes);
+      cm->ref_frame_map[idx]->border_extended = 0;
     }
   } else {
     if (!equal_dimensions_and_border(ref_buf, sd)) {
@@ -344,6 +348,8 @@ static void release_current_frame(AV1Decoder *pbi) {
   BufferPool *const pool = cm->buffer_pool;
 
   cm->cur_frame->buf.corrupted = 1;
+  // Release anyone waiting on rows of this frame; they will see it corrupted.
+  av1_frameworker_broadcast(pool, cm->cur_frame, INT_MAX);
   lock_buffer_pool(pool);
   decrease_ref_count(cm->cur_frame, pool);
   unlock_buffer_pool(pool);
@@ -446,6 +452,8 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     pbi->error.error_code = AOM_CODEC_MEM_ERROR;
     return 1;
   }
+  av1_frameworker_reset(cm->buffer_pool, cm->cur_frame);
+  cm->cur_frame->border_extended = 0;
 
   // The jmp_buf is valid only for the duration of the function that calls
   // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
@@ -488,6 +496,10 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
   cm->txb_count = 0;
 #endif
 
+  // Every row of the frame is final now (a frame that was not decoded, e.g. a
+  // header-only temporal unit, is never referenced, so publishing is harmless).
+  av1_frameworker_broadcast(cm->buffer_pool, cm->cur_frame, INT_MAX);
+
   // Note: At this point, this function holds a reference to cm->cur_frame
   // in the buffer pool. This reference is consumed by update_frame_buffers().
   update_frame_buffers(pbi, frame_decoded);
@@ -513,7 +525,6 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     }
   }
 
-  // Update progress in frame parallel decode.
   pbi->error.setjmp = 0;
 
   return 0;
@@ -16,12 +16,14 @@
 
 #include "aom/aom_codec.h"
 #include "aom_dsp/bitreader.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_scale/yv12config.h"
 #include "aom_util/aom_thread.h"
 
 #include "av1/common/av1_common_int.h"
 #include "av1/common/thread_common.h"
 #include "av1/decoder/dthread.h"
+#include "av1/decoder/tile_cache.h"
 #if CONFIG_ACCOUNTING
 #include "av1/decoder/accounting.h"
 #endif
@@ -56,6 +58,11 @@ typedef struct DecoderCodingBlock {
    * 'pbi->thread_data[i].td' (multi-threaded decoding).
    */
   uint8_t *mc_buf[2];
+  /*!
+   * Width in luma pixels of the extended border that all the reference frames
+   * of the current frame have, or 0 if their borders are not extended.
+   */
+  int ref_border;
   /*!
    * Pointer to 'dqcoeff' inside 'td->cb_buffer_base' or 'pbi->cb_buffer_base'
    * with appropriate offset for the current superblock, for each plane.
@@ -131,19 +138,30 @@ typedef struct ThreadData {
   cfl_store_inter_block_visitor_fn_t cfl_store_inter_block_visit;
 } ThreadData;
 
+// Jobs of row-based multi-threaded decoding.
+typedef enum {
+  // Decode a superblock row of a tile.
+  DEC_ROW_MT_DECODE_JOB,
+  // Run an in-loop filter stage on a row of the frame (see
+  // AV1DecFilterPipeline).
+  DEC_ROW_MT_LPF_JOB,
+  DEC_ROW_MT_CDEF_JOB,
+  DEC_ROW_MT_LR_JOB,
+} DEC_ROW_MT_JOB_TYPE;
+
 typedef struct AV1DecRowMTJobInfo {
+  DEC_ROW_MT_JOB_TYPE job_type;
   int tile_row;
   int tile_col;
   int mi_row;
+  // Index of the row processed by a filter job, in units of the stage.
+  int filter_row;
 } AV1DecRowMTJobInfo;
 
 typedef struct AV1DecRowMTSyncData {
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex_;
-  pthread_cond_t *cond_;
-#endif
   int allocated_sb_rows;
-  int *cur_sb_col;
+  // Number of decoded superblocks in each superblock row.
+  AV1RowMTProgress cur_sb_col;
   // Denotes the superblock interval at which conditional signalling should
   // happen. Also denotes the minimum number of extra superblocks of the top row
   // to be complete to start decoding the current superblock. A value of 1
@@ -191,6 +209,45 @@ typedef struct AV1DecRowMTInfo {
   int row_mt_exit;
 } AV1DecRowMTInfo;
 
+// State of the in-loop filter pipeline of row-based multi-threaded decoding.
+// When it is enabled, the decoding workers also deblock, CDEF filter and
+// restore the frame, each stage following the previous one a few rows behind,
+// instead of filtering the whole frame once all its tiles are decoded.
+// Deblocking runs on rows of MAX_MIB_SIZE mi rows and loop restoration on
+// processing stripes, one row at a time; CDEF runs on rows of 64x64 filter
+// blocks, several at a time.
+// Apart from the buffers, the fields are protected by pbi->row_mt_mutex_.
+typedef struct AV1DecFilterPipeline {
+  // Boolean: whether the in-loop filters of the current frame are pipelined.
+  int enabled;
+  int planes_to_lf[MAX_MB_PLANE];
+  // Boolean: whether CDEF filters the frame.
+  int do_cdef;
+  // Boolean: whether loop restoration filters the frame.
+  int do_loop_restoration;
+  // Number of tile columns decoded in each superblock row.
+  int *num_tile_cols_done;
+  // Boolean: set for each CDEF row which is done.
+  int *cdef_row_done;
+  int allocated_sb_rows;
+  int allocated_cdef_rows;
+  int sb_rows;
+  // Number of leading superblock rows which are fully decoded.
+  int sb_rows_decoded;
+  int lf_rows;
+  int lf_rows_started;
+  int lf_rows_done;
+  int cdef_rows;
+  int cdef_rows_started;
+  // Number of leading CDEF rows which are done.
+  int cdef_rows_done;
+  int lr_stripes;
+  int lr_stripes_started;
+  int lr_stripes_done;
+  // Deblocking data of the worker running the deblocking stage.
+  LFWorkerData lf_data;
+} AV1DecFilterPipeline;
+
 typedef struct TileDataDec {
   TileInfo tile_info;
   aom_reader bit_reader;
@@ -213,6 +270,17 @@ typedef struct EXTERNAL_REFERENCES {
   int num;
 } EXTERNAL_REFERENCES;
 
+// A tile of a tile list OBU in large scale tile mode.
+typedef struct TileListTileDec {
+  int ref_idx;
+  int tile_row;
+  int tile_col;
+  // Slot of the tile in the tile list output buffer.
+  int tile_idx;
+  const uint8_t *data;
+  uint32_t size;
+} TileListTileDec;
+
 typedef struct TileJobsDec {
   TileBufferDec *tile_buffer;
   TileDataDec *tile_data;
@@ -229,6 +297,18 @@ typedef struct AV1DecTileMTData {
   int alloc_tile_cols;
 } AV1DecTileMT;
 
+// Decoder stages timed for AV1D_GET_FRAME_STAGE_TIMINGS.
+enum {
+  kDecStageFrameHeader,
+  kDecStageDecodeTiles,
+  kDecStageLoopFilter,
+  kDecStageCdef,
+  kDecStageSuperres,
+  kDecStageRestoration,
+  kDecStageFilmGrain,
+  kNumDecStages,
+} UENUM1BYTE(DEC_STAGE);
+
 typedef struct AV1Decoder {
   DecoderCodingBlock dcb;
 
@@ -288,11 +368,21 @@ typedef struct AV1Decoder {
   aom_inspect_cb inspect_cb;
   void *inspect_ctx;
 #endif
+  // Called as the leading luma rows of cm->cur_frame become final. See
+  // AV1D_SET_ROW_OUTPUT_CALLBACK.
+  void (*row_output_cb)(void *priv, const RefCntBuffer *frame, int rows_done);
+  void *row_output_priv;
+  // Number of leading luma rows of the current frame passed to row_output_cb,
+  // or -1 if the rows of the current frame are not reported.
+  int row_output_rows;
   int operating_point;
   int current_operating_point;
   int seen_frame_header;
   // The expected start_tile (tg_start syntax element) of the next tile group.
   int next_start_tile;
+  // If true, the tiles of the remaining tile groups of the current frame were
+  // decoded along with an earlier tile group.
+  int tiles_decoded_ahead;
 
   // State if the camera frame header is already decoded while
   // large_scale_tile = 1.
@@ -315,6 +405,11 @@ typedef struct AV1Decoder {
 
   EXTERNAL_REFERENCES ext_refs;
   YV12_BUFFER_CONFIG tile_list_outbuf;
+  // Tiles decoded from tile lists, see AV1D_SET_TILE_CACHE_SIZE.
+  TileCache tile_cache;
+  // Tiles of the current tile list that are left to decode on the tile
+  // workers.
+  TileListTileDec tile_list_tiles[MAX_TILES];
 
   // Coding block buffer for the current frame.
   // Allocated and used only for multi-threaded decoding with 'row_mt == 0'.
@@ -332,11 +427,15 @@ typedef struct AV1Decoder {
 #endif
 
   AV1DecRowMTInfo frame_row_mt_info;
+  AV1DecFilterPipeline filter_pipeline;
   aom_metadata_array_t *metadata;
 
   int context_update_tile_id;
   int skip_loop_filter;
   int skip_film_grain;
+  // If true, the borders of the reference frames are extended, see
+  // AV1D_SET_EXTEND_REF_BORDERS.
+  int extend_ref_borders;
   int is_annexb;
   int valid_for_referencing[REF_FRAMES];
   int is_fwd_kf_present;
@@ -369,6 +468,17 @@ typedef struct AV1Decoder {
    * Number of spatial layers: may be > 1 for SVC (scalable vector coding).
    */
   unsigned int number_spatial_layers;
+
+  /*!
+   * Time spent in each stage of the decoder, in microseconds, since the start
+   * of the current aom_codec_decode() call.
+   */
+  int64_t stage_time[kNumDecStages];
+  /*!
+   * Stores the timing of the stages between calls of dec_start_stage_timing()
+   * and dec_end_stage_timing().
+   */
+  struct aom_usec_timer stage_timer[kNumDecStages];
 } AV1Decoder;
 
 // Returns 0 on success. Sets pbi->common.error.error_code to a nonzero error
@@ -421,6 +531,14 @@ static inline void decrease_ref_count(RefCntBuffer *const buf,
   }
 }
 
+static inline void dec_start_stage_timing(AV1Decoder *pbi, DEC_STAGE stage) {
+  aom_usec_timer_start(&pbi->stage_timer[stage]);
+}
+static inline void dec_end_stage_timing(AV1Decoder *pbi, DEC_STAGE stage) {
+  aom_usec_timer_mark(&pbi->stage_timer[stage]);
+  pbi->stage_time[stage] += aom_usec_timer_elapsed(&pbi->stage_timer[stage]);
+}
+
 #define ACCT_STR __func__
 static inline int av1_read_uniform(aom_reader *r, int n) {
   const int l = get_unsigned_bits(n);
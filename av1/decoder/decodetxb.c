@@ -59,12 +59,10 @@ static inline int get_dqv(const int16_t *dequant, int coeff_idx,
   return dqv;
 }
 
-static inline void read_coeffs_reverse_2d(aom_reader *r, TX_SIZE tx_size,
-                                          int start_si, int end_si,
-                                          const int16_t *scan, int bhl,
-                                          uint8_t *levels,
-                                          base_cdf_arr base_cdf,
-                                          br_cdf_arr br_cdf) {
+static AOM_FORCE_INLINE void read_coeffs_reverse_2d(
+    aom_reader *r, TX_SIZE tx_size, int start_si, int end_si,
+    const int16_t *scan, int bhl, uint8_t *levels, base_cdf_arr base_cdf,
+    br_cdf_arr br_cdf) {
   for (int c = end_si; c >= start_si; --c) {
     const int pos = scan[c];
     const int coeff_ctx = get_lower_levels_ctx_2d(levels, pos, bhl, tx_size);
@@ -83,11 +81,10 @@ static inline void read_coeffs_reverse_2d(aom_reader *r, TX_SIZE tx_size,
   }
 }
 
-static inline void read_coeffs_reverse(aom_reader *r, TX_SIZE tx_size,
-                                       TX_CLASS tx_class, int start_si,
-                                       int end_si, const int16_t *scan, int bhl,
-                                       uint8_t *levels, base_cdf_arr base_cdf,
-                                       br_cdf_arr br_cdf) {
+static AOM_FORCE_INLINE void read_coeffs_reverse(
+    aom_reader *r, TX_SIZE tx_size, TX_CLASS tx_class, int start_si, int end_si,
+    const int16_t *scan, int bhl, uint8_t *levels, base_cdf_arr base_cdf,
+    br_cdf_arr br_cdf) {
   for (int c = end_si; c >= start_si; --c) {
     const int pos = scan[c];
     const int coeff_ctx =
@@ -107,6 +104,50 @@ static inline void read_coeffs_reverse(aom_reader *r, TX_SIZE tx_size,
   }
 }
 
+// Reads the coefficients with scan indices end_si down to start_si. For 2D
+// transforms the caller reads the DC coefficient itself. The common square 2D
+// sizes get their own copy of the loop, in which bhl and the context offset
+// table are constants, and each 1D class gets a loop without the class
+// switches.
+static void read_coeffs_reverse_ac(aom_reader *r, TX_SIZE tx_size,
+                                   TX_CLASS tx_class, int start_si, int end_si,
+                                   const int16_t *scan, int bhl,
+                                   uint8_t *levels, base_cdf_arr base_cdf,
+                                   br_cdf_arr br_cdf) {
+  switch (tx_class) {
+    case TX_CLASS_2D:
+      assert(start_si > 0);
+      switch (tx_size) {
+        case TX_4X4:
+          read_coeffs_reverse_2d(r, TX_4X4, start_si, end_si, scan, 2, levels,
+                                 base_cdf, br_cdf);
+          break;
+        case TX_8X8:
+          read_coeffs_reverse_2d(r, TX_8X8, start_si, end_si, scan, 3, levels,
+                                 base_cdf, br_cdf);
+          break;
+        case TX_16X16:
+          read_coeffs_reverse_2d(r, TX_16X16, start_si, end_si, scan, 4,
+                                 levels, base_cdf, br_cdf);
+          break;
+        default:
+          read_coeffs_reverse_2d(r, tx_size, start_si, end_si, scan, bhl,
+                                 levels, base_cdf, br_cdf);
+          break;
+      }
+      break;
+    case TX_CLASS_HORIZ:
+      read_coeffs_reverse(r, tx_size, TX_CLASS_HORIZ, start_si, end_si, scan,
+                          bhl, levels, base_cdf, br_cdf);
+      break;
+    default:
+      assert(tx_class == TX_CLASS_VERT);
+      read_coeffs_reverse(r, tx_size, TX_CLASS_VERT, start_si, end_si, scan,
+                          bhl, levels, base_cdf, br_cdf);
+      break;
+  }
+}
+
 static uint8_t read_coeffs_txb(const AV1_COMMON *const cm,
                                DecoderCodingBlock *dcb, aom_reader *const r,
                                const int blk_row, const int blk_col,
@@ -267,13 +308,13 @@ static uint8_t read_coeffs_txb(const AV1_COMMON *const cm,
     br_cdf_arr br_cdf =
         ec_ctx->coeff_br_cdf[AOMMIN(txs_ctx, TX_32X32)][plane_type];
     if (tx_class == TX_CLASS_2D) {
-      read_coeffs_reverse_2d(r, tx_size, 1, *eob - 1 - 1, scan, bhl, levels,
-                             base_cdf, br_cdf);
+      read_coeffs_reverse_ac(r, tx_size, tx_class, 1, *eob - 1 - 1, scan, bhl,
+                             levels, base_cdf, br_cdf);
       read_coeffs_reverse(r, tx_size, tx_class, 0, 0, scan, bhl, levels,
                           base_cdf, br_cdf);
     } else {
-      read_coeffs_reverse(r, tx_size, tx_class, 0, *eob - 1 - 1, scan, bhl,
-                          levels, base_cdf, br_cdf);
+      read_coeffs_reverse_ac(r, tx_size, tx_class, 0, *eob - 1 - 1, scan, bhl,
+                             levels, base_cdf, br_cdf);
     }
   }
 
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <limits.h>
+
+#include "config/aom_config.h"
+
+#include "aom_util/aom_pthread.h"
+#include "av1/common/av1_common_int.h"
+#include "av1/decoder/dthread.h"
+
+void av1_frameworker_reset(BufferPool *pool, RefCntBuffer *buf) {
+  lock_buffer_pool(pool);
+  buf->sb_rows_done = 0;
+  unlock_buffer_pool(pool);
+}
+
+void av1_frameworker_broadcast(BufferPool *pool, RefCntBuffer *buf,
+                               int sb_rows_done) {
+  lock_buffer_pool(pool);
+  // Progress only ever moves forward within a frame.
+  if (sb_rows_done > buf->sb_rows_done) {
+    buf->sb_rows_done = sb_rows_done;
+#if CONFIG_MULTITHREAD
+    pthread_cond_broadcast(&pool->progress_cond);
+#endif
+  }
+  unlock_buffer_pool(pool);
+}
+
+void av1_frameworker_wait(BufferPool *pool, const RefCntBuffer *buf,
+                          int sb_row) {
+  assert(sb_row >= 0);
+  lock_buffer_pool(pool);
+#if CONFIG_MULTITHREAD
+  while (buf->sb_rows_done <= sb_row) {
+    pthread_cond_wait(&pool->progress_cond, &pool->pool_mutex);
+  }
+#else
+  // Without threads the producer of 'buf' has necessarily finished.
+  assert(buf->sb_rows_done > sb_row);
+#endif
+  unlock_buffer_pool(pool);
+}
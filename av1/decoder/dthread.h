@@ -22,6 +22,8 @@ extern "C" {
 
 struct AV1Common;
 struct AV1Decoder;
+struct BufferPool;
+struct RefCntBuffer;
 struct ThreadData;
 
 typedef struct DecWorkerData {
@@ -43,6 +45,21 @@ typedef struct FrameWorkerData {
   int frame_decoded;        // Finished decoding current frame.
 } FrameWorkerData;
 
+// Resets the decoding progress of 'buf' before it is (re)used as the target of
+// a new frame.
+void av1_frameworker_reset(struct BufferPool *pool, struct RefCntBuffer *buf);
+
+// Publishes that the first 'sb_rows_done' superblock rows of 'buf' are final.
+// Pass INT_MAX when the whole frame is done, including on error, so that no
+// waiter is left blocked on a frame that will never complete.
+void av1_frameworker_broadcast(struct BufferPool *pool,
+                               struct RefCntBuffer *buf, int sb_rows_done);
+
+// Blocks until superblock row 'sb_row' of 'buf' is final. Returns immediately
+// if the frame is already complete.
+void av1_frameworker_wait(struct BufferPool *pool,
+                          const struct RefCntBuffer *buf, int sb_row);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
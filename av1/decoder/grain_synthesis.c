@@ -19,6 +19,9 @@
 #include <string.h>
 #include <stdlib.h>
 #include <assert.h>
+
+#include "config/av1_rtcd.h"
+
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_mem/aom_mem.h"
 #include "av1/decoder/grain_synthesis.h"
@@ -237,14 +240,9 @@ static int scaling_lut_cr[256];
 static int grain_min;
 static int grain_max;
 
-static uint16_t random_register = 0;  // random number generator register
-
 static void dealloc_arrays(const aom_film_grain_t *params, int ***pred_pos_luma,
                            int ***pred_pos_chroma, int **luma_grain_block,
-                           int **cb_grain_block, int **cr_grain_block,
-                           int **y_line_buf, int **cb_line_buf,
-                           int **cr_line_buf, int **y_col_buf, int **cb_col_buf,
-                           int **cr_col_buf) {
+                           int **cb_grain_block, int **cr_grain_block) {
   int num_pos_luma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
   int num_pos_chroma = num_pos_luma;
   if (params->num_y_points > 0) ++num_pos_chroma;
@@ -265,24 +263,6 @@ static void dealloc_arrays(const aom_film_grain_t *params, int ***pred_pos_luma,
     *pred_pos_chroma = NULL;
   }
 
-  aom_free(*y_line_buf);
-  *y_line_buf = NULL;
-
-  aom_free(*cb_line_buf);
-  *cb_line_buf = NULL;
-
-  aom_free(*cr_line_buf);
-  *cr_line_buf = NULL;
-
-  aom_free(*y_col_buf);
-  *y_col_buf = NULL;
-
-  aom_free(*cb_col_buf);
-  *cb_col_buf = NULL;
-
-  aom_free(*cr_col_buf);
-  *cr_col_buf = NULL;
-
   aom_free(*luma_grain_block);
   *luma_grain_block = NULL;
 
@@ -293,25 +273,16 @@ static void dealloc_arrays(const aom_film_grain_t *params, int ***pred_pos_luma,
   *cr_grain_block = NULL;
 }
 
-static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
-                        int chroma_stride, int ***pred_pos_luma_p,
+static bool init_arrays(const aom_film_grain_t *params,
+                        int ***pred_pos_luma_p,
                         int ***pred_pos_chroma_p, int **luma_grain_block,
                         int **cb_grain_block, int **cr_grain_block,
-                        int **y_line_buf, int **cb_line_buf, int **cr_line_buf,
-                        int **y_col_buf, int **cb_col_buf, int **cr_col_buf,
-                        int luma_grain_samples, int chroma_grain_samples,
-                        int chroma_subsamp_y, int chroma_subsamp_x) {
+                        int luma_grain_samples, int chroma_grain_samples) {
   *pred_pos_luma_p = NULL;
   *pred_pos_chroma_p = NULL;
   *luma_grain_block = NULL;
   *cb_grain_block = NULL;
   *cr_grain_block = NULL;
-  *y_line_buf = NULL;
-  *cb_line_buf = NULL;
-  *cr_line_buf = NULL;
-  *y_col_buf = NULL;
-  *cb_col_buf = NULL;
-  *cr_col_buf = NULL;
 
   memset(scaling_lut_y, 0, sizeof(*scaling_lut_y) * 256);
   memset(scaling_lut_cb, 0, sizeof(*scaling_lut_cb) * 256);
@@ -331,9 +302,7 @@ static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
     pred_pos_luma[row] = (int *)aom_malloc(sizeof(**pred_pos_luma) * 3);
     if (!pred_pos_luma[row]) {
       dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p,
-                     luma_grain_block, cb_grain_block, cr_grain_block,
-                     y_line_buf, cb_line_buf, cr_line_buf, y_col_buf,
-                     cb_col_buf, cr_col_buf);
+                     luma_grain_block, cb_grain_block, cr_grain_block);
       return false;
     }
   }
@@ -342,8 +311,7 @@ static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
       (int **)aom_calloc(num_pos_chroma, sizeof(*pred_pos_chroma));
   if (!pred_pos_chroma) {
     dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p, luma_grain_block,
-                   cb_grain_block, cr_grain_block, y_line_buf, cb_line_buf,
-                   cr_line_buf, y_col_buf, cb_col_buf, cr_col_buf);
+                   cb_grain_block, cr_grain_block);
     return false;
   }
 
@@ -351,9 +319,7 @@ static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
     pred_pos_chroma[row] = (int *)aom_malloc(sizeof(**pred_pos_chroma) * 3);
     if (!pred_pos_chroma[row]) {
       dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p,
-                     luma_grain_block, cb_grain_block, cr_grain_block,
-                     y_line_buf, cb_line_buf, cr_line_buf, y_col_buf,
-                     cb_col_buf, cr_col_buf);
+                     luma_grain_block, cb_grain_block, cr_grain_block);
       return false;
     }
   }
@@ -395,63 +361,45 @@ static bool init_arrays(const aom_film_grain_t *params, int luma_stride,
   *pred_pos_luma_p = pred_pos_luma;
   *pred_pos_chroma_p = pred_pos_chroma;
 
-  *y_line_buf = (int *)aom_malloc(sizeof(**y_line_buf) * luma_stride * 2);
-  *cb_line_buf = (int *)aom_malloc(sizeof(**cb_line_buf) * chroma_stride *
-                                   (2 >> chroma_subsamp_y));
-  *cr_line_buf = (int *)aom_malloc(sizeof(**cr_line_buf) * chroma_stride *
-                                   (2 >> chroma_subsamp_y));
-
-  *y_col_buf =
-      (int *)aom_malloc(sizeof(**y_col_buf) * (luma_subblock_size_y + 2) * 2);
-  *cb_col_buf =
-      (int *)aom_malloc(sizeof(**cb_col_buf) *
-                        (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-                        (2 >> chroma_subsamp_x));
-  *cr_col_buf =
-      (int *)aom_malloc(sizeof(**cr_col_buf) *
-                        (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
-                        (2 >> chroma_subsamp_x));
-
   *luma_grain_block =
       (int *)aom_malloc(sizeof(**luma_grain_block) * luma_grain_samples);
   *cb_grain_block =
       (int *)aom_malloc(sizeof(**cb_grain_block) * chroma_grain_samples);
   *cr_grain_block =
       (int *)aom_malloc(sizeof(**cr_grain_block) * chroma_grain_samples);
-  if (!(*pred_pos_luma_p && *pred_pos_chroma_p && *y_line_buf && *cb_line_buf &&
-        *cr_line_buf && *y_col_buf && *cb_col_buf && *cr_col_buf &&
-        *luma_grain_block && *cb_grain_block && *cr_grain_block)) {
+  if (!(*pred_pos_luma_p && *pred_pos_chroma_p && *luma_grain_block &&
+        *cb_grain_block && *cr_grain_block)) {
     dealloc_arrays(params, pred_pos_luma_p, pred_pos_chroma_p, luma_grain_block,
-                   cb_grain_block, cr_grain_block, y_line_buf, cb_line_buf,
-                   cr_line_buf, y_col_buf, cb_col_buf, cr_col_buf);
+                   cb_grain_block, cr_grain_block);
     return false;
   }
   return true;
 }
 
 // get a number between 0 and 2^bits - 1
-static inline int get_random_number(int bits) {
+static inline int get_random_number(uint16_t *random_register, int bits) {
   uint16_t bit;
-  bit = ((random_register >> 0) ^ (random_register >> 1) ^
-         (random_register >> 3) ^ (random_register >> 12)) &
+  bit = ((*random_register >> 0) ^ (*random_register >> 1) ^
+         (*random_register >> 3) ^ (*random_register >> 12)) &
         1;
-  random_register = (random_register >> 1) | (bit << 15);
-  return (random_register >> (16 - bits)) & ((1 << bits) - 1);
+  *random_register = (*random_register >> 1) | (bit << 15);
+  return (*random_register >> (16 - bits)) & ((1 << bits) - 1);
 }
 
-static void init_random_generator(int luma_line, uint16_t seed) {
+static void init_random_generator(uint16_t *random_register, int luma_line,
+                                  uint16_t seed) {
   // same for the picture
 
   uint16_t msb = (seed >> 8) & 255;
   uint16_t lsb = seed & 255;
 
-  random_register = (msb << 8) + lsb;
+  *random_register = (msb << 8) + lsb;
 
   //  changes for each row
   int luma_num = luma_line >> 5;
 
-  random_register ^= ((luma_num * 37 + 178) & 255) << 8;
-  random_register ^= ((luma_num * 173 + 105) & 255);
+  *random_register ^= ((luma_num * 37 + 178) & 255) << 8;
+  *random_register ^= ((luma_num * 173 + 105) & 255);
 }
 
 static void generate_luma_grain_block(
@@ -469,11 +417,12 @@ static void generate_luma_grain_block(
 
   int num_pos_luma = 2 * params->ar_coeff_lag * (params->ar_coeff_lag + 1);
   int rounding_offset = (1 << (params->ar_coeff_shift - 1));
+  uint16_t random_register = params->random_seed;
 
   for (int i = 0; i < luma_block_size_y; i++)
     for (int j = 0; j < luma_block_size_x; j++)
       luma_grain_block[i * luma_grain_stride + j] =
-          (gaussian_sequence[get_random_number(gauss_bits)] +
+          (gaussian_sequence[get_random_number(&random_register, gauss_bits)] +
            ((1 << gauss_sec_shift) >> 1)) >>
           gauss_sec_shift;
 
@@ -506,14 +455,16 @@ static bool generate_chroma_grain_blocks(
   if (params->num_y_points > 0) ++num_pos_chroma;
   int rounding_offset = (1 << (params->ar_coeff_shift - 1));
   int chroma_grain_block_size = chroma_block_size_y * chroma_grain_stride;
+  uint16_t random_register;
 
   if (params->num_cb_points || params->chroma_scaling_from_luma) {
-    init_random_generator(7 << 5, params->random_seed);
+    init_random_generator(&random_register, 7 << 5, params->random_seed);
 
     for (int i = 0; i < chroma_block_size_y; i++)
       for (int j = 0; j < chroma_block_size_x; j++)
         cb_grain_block[i * chroma_grain_stride + j] =
-            (gaussian_sequence[get_random_number(gauss_bits)] +
+            (gaussian_sequence[get_random_number(&random_register,
+                                                 gauss_bits)] +
              ((1 << gauss_sec_shift) >> 1)) >>
             gauss_sec_shift;
   } else {
@@ -522,12 +473,14 @@ static bool generate_chroma_grain_blocks(
   }
 
   if (params->num_cr_points || params->chroma_scaling_from_luma) {
-    init_random_generator(11 << 5, params->random_seed);
+    init_random_generator(&random_register, 11 << 5,
+                          params->random_seed);
 
     for (int i = 0; i < chroma_block_size_y; i++)
       for (int j = 0; j < chroma_block_size_x; j++)
         cr_grain_block[i * chroma_grain_stride + j] =
-            (gaussian_sequence[get_random_number(gauss_bits)] +
+            (gaussian_sequence[get_random_number(&random_register,
+                                                 gauss_bits)] +
              ((1 << gauss_sec_shift) >> 1)) >>
             gauss_sec_shift;
   } else {
@@ -625,6 +578,28 @@ static int scale_LUT(int *scaling_lut, int index, int bit_depth) {
                              (bit_depth - 8));
 }
 
+void av1_add_film_grain_row_c(uint8_t *pix, const uint8_t *luma,
+                              const int *grain, int width, int luma_subsamp_x,
+                              const int *scaling_lut, int mult, int luma_mult,
+                              int offset, int scaling_shift, int min_val,
+                              int max_val) {
+  const int rounding_offset = 1 << (scaling_shift - 1);
+  for (int j = 0; j < width; j++) {
+    int average_luma;
+    if (luma_subsamp_x) {
+      average_luma = (luma[j << 1] + luma[(j << 1) + 1] + 1) >> 1;
+    } else {
+      average_luma = luma[j];
+    }
+    const int index =
+        clamp(((average_luma * luma_mult + mult * pix[j]) >> 6) + offset, 0,
+              255);
+    const int noise =
+        (scaling_lut[index] * grain[j] + rounding_offset) >> scaling_shift;
+    pix[j] = clamp(pix[j] + noise, min_val, max_val);
+  }
+}
+
 static void add_noise_to_block(const aom_film_grain_t *params, uint8_t *luma,
                                uint8_t *cb, uint8_t *cr, int luma_stride,
                                int chroma_stride, int *luma_grain,
@@ -633,6 +608,9 @@ static void add_noise_to_block(const aom_film_grain_t *params, uint8_t *luma,
                                int half_luma_height, int half_luma_width,
                                int bit_depth, int chroma_subsamp_y,
                                int chroma_subsamp_x, int mc_identity) {
+  assert(bit_depth == 8);
+  (void)bit_depth;
+
   int cb_mult = params->cb_mult - 128;            // fixed scale
   int cb_luma_mult = params->cb_luma_mult - 128;  // fixed scale
   int cb_offset = params->cb_offset - 256;
@@ -641,8 +619,6 @@ static void add_noise_to_block(const aom_film_grain_t *params, uint8_t *luma,
   int cr_luma_mult = params->cr_luma_mult - 128;  // fixed scale
   int cr_offset = params->cr_offset - 256;
 
-  int rounding_offset = (1 << (params->scaling_shift - 1));
-
   int apply_y = params->num_y_points > 0 ? 1 : 0;
   int apply_cb =
       (params->num_cb_points > 0 || params->chroma_scaling_from_luma) ? 1 : 0;
@@ -677,65 +653,35 @@ static void add_noise_to_block(const aom_film_grain_t *params, uint8_t *luma,
     max_luma = max_chroma = 255;
   }
 
-  for (int i = 0; i < (half_luma_height << (1 - chroma_subsamp_y)); i++) {
-    for (int j = 0; j < (half_luma_width << (1 - chroma_subsamp_x)); j++) {
-      int average_luma = 0;
-      if (chroma_subsamp_x) {
-        average_luma = (luma[(i << chroma_subsamp_y) * luma_stride +
-                             (j << chroma_subsamp_x)] +
-                        luma[(i << chroma_subsamp_y) * luma_stride +
-                             (j << chroma_subsamp_x) + 1] +
-                        1) >>
-                       1;
-      } else {
-        average_luma = luma[(i << chroma_subsamp_y) * luma_stride + j];
-      }
-
-      if (apply_cb) {
-        cb[i * chroma_stride + j] = clamp(
-            cb[i * chroma_stride + j] +
-                ((scale_LUT(scaling_lut_cb,
-                            clamp(((average_luma * cb_luma_mult +
-                                    cb_mult * cb[i * chroma_stride + j]) >>
-                                   6) +
-                                      cb_offset,
-                                  0, (256 << (bit_depth - 8)) - 1),
-                            8) *
-                      cb_grain[i * chroma_grain_stride + j] +
-                  rounding_offset) >>
-                 params->scaling_shift),
-            min_chroma, max_chroma);
-      }
-
-      if (apply_cr) {
-        cr[i * chroma_stride + j] = clamp(
-            cr[i * chroma_stride + j] +
-                ((scale_LUT(scaling_lut_cr,
-                            clamp(((average_luma * cr_luma_mult +
-                                    cr_mult * cr[i * chroma_stride + j]) >>
-                                   6) +
-                                      cr_offset,
-                                  0, (256 << (bit_depth - 8)) - 1),
-                            8) *
-                      cr_grain[i * chroma_grain_stride + j] +
-                  rounding_offset) >>
-                 params->scaling_shift),
-            min_chroma, max_chroma);
-      }
+  const int chroma_height = half_luma_height << (1 - chroma_subsamp_y);
+  const int chroma_width = half_luma_width << (1 - chroma_subsamp_x);
+
+  // Chroma is blended before luma since it is scaled by the noise-free luma.
+  for (int i = 0; i < chroma_height; i++) {
+    const uint8_t *luma_row = luma + (i << chroma_subsamp_y) * luma_stride;
+    if (apply_cb) {
+      av1_add_film_grain_row(cb + i * chroma_stride, luma_row,
+                             cb_grain + i * chroma_grain_stride, chroma_width,
+                             chroma_subsamp_x, scaling_lut_cb, cb_mult,
+                             cb_luma_mult, cb_offset, params->scaling_shift,
+                             min_chroma, max_chroma);
+    }
+    if (apply_cr) {
+      av1_add_film_grain_row(cr + i * chroma_stride, luma_row,
+                             cr_grain + i * chroma_grain_stride, chroma_width,
+                             chroma_subsamp_x, scaling_lut_cr, cr_mult,
+                             cr_luma_mult, cr_offset, params->scaling_shift,
+                             min_chroma, max_chroma);
     }
   }
 
   if (apply_y) {
     for (int i = 0; i < (half_luma_height << 1); i++) {
-      for (int j = 0; j < (half_luma_width << 1); j++) {
-        luma[i * luma_stride + j] =
-            clamp(luma[i * luma_stride + j] +
-                      ((scale_LUT(scaling_lut_y, luma[i * luma_stride + j], 8) *
-                            luma_grain[i * luma_grain_stride + j] +
-                        rounding_offset) >>
-                       params->scaling_shift),
-                  min_luma, max_luma);
-      }
+      uint8_t *luma_row = luma + i * luma_stride;
+      av1_add_film_grain_row(luma_row, luma_row,
+                             luma_grain + i * luma_grain_stride,
+                             half_luma_width << 1, 0, scaling_lut_y, 0, 64, 0,
+                             params->scaling_shift, min_luma, max_luma);
     }
   }
 }
@@ -969,156 +915,172 @@ static void hor_boundary_overlap(int *top_block, int top_stride,
   }
 }
 
-/*!\brief Add film grain
- *
- * Add film grain to an image
- *
- * Returns 0 for success, -1 for failure
- *
- * \param[in]    grain_params     Grain parameters
- * \param[in]    luma             luma plane
- * \param[in]    cb               cb plane
- * \param[in]    cr               cr plane
- * \param[in]    height           luma plane height
- * \param[in]    width            luma plane width
- * \param[in]    luma_stride      luma plane stride
- * \param[in]    chroma_stride    chroma plane stride
- */
-static int add_film_grain_run(const aom_film_grain_t *params, uint8_t *luma,
-                              uint8_t *cb, uint8_t *cr, int height, int width,
-                              int luma_stride, int chroma_stride,
-                              int use_high_bit_depth, int chroma_subsamp_y,
-                              int chroma_subsamp_x, int mc_identity) {
-  int **pred_pos_luma;
-  int **pred_pos_chroma;
-  int *luma_grain_block;
-  int *cb_grain_block;
-  int *cr_grain_block;
-
+// Grain of the overlap regions between neighbouring 32x32 blocks: the line
+// buffers carry the bottom rows of the stripe above, the column buffers the
+// right columns of the block to the left. Each thread needs its own set.
+typedef struct {
   int *y_line_buf;
   int *cb_line_buf;
   int *cr_line_buf;
-
   int *y_col_buf;
   int *cb_col_buf;
   int *cr_col_buf;
+} GrainOverlapBuffers;
+
+static void free_overlap_buffers(GrainOverlapBuffers *bufs) {
+  aom_free(bufs->y_line_buf);
+  aom_free(bufs->cb_line_buf);
+  aom_free(bufs->cr_line_buf);
+  aom_free(bufs->y_col_buf);
+  aom_free(bufs->cb_col_buf);
+  aom_free(bufs->cr_col_buf);
+  memset(bufs, 0, sizeof(*bufs));
+}
 
-  random_register = params->random_seed;
-
-  int left_pad = 3;
-  int right_pad = 3;  // padding to offset for AR coefficients
-  int top_pad = 3;
-  int bottom_pad = 0;
-
-  int ar_padding = 3;  // maximum lag used for stabilization of AR coefficients
-
-  luma_subblock_size_y = 32;
-  luma_subblock_size_x = 32;
-
-  chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
-  chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
-
-  // Initial padding is only needed for generation of
-  // film grain templates (to stabilize the AR process)
-  // Only a 64x64 luma and 32x32 chroma part of a template
-  // is used later for adding grain, padding can be discarded
-
-  int luma_block_size_y =
-      top_pad + 2 * ar_padding + luma_subblock_size_y * 2 + bottom_pad;
-  int luma_block_size_x = left_pad + 2 * ar_padding + luma_subblock_size_x * 2 +
-                          2 * ar_padding + right_pad;
+static bool alloc_overlap_buffers(GrainOverlapBuffers *bufs, int luma_stride,
+                                  int chroma_stride, int chroma_subsamp_y,
+                                  int chroma_subsamp_x) {
+  bufs->y_line_buf =
+      (int *)aom_malloc(sizeof(*bufs->y_line_buf) * luma_stride * 2);
+  bufs->cb_line_buf = (int *)aom_malloc(
+      sizeof(*bufs->cb_line_buf) * chroma_stride * (2 >> chroma_subsamp_y));
+  bufs->cr_line_buf = (int *)aom_malloc(
+      sizeof(*bufs->cr_line_buf) * chroma_stride * (2 >> chroma_subsamp_y));
+
+  bufs->y_col_buf = (int *)aom_malloc(sizeof(*bufs->y_col_buf) *
+                                      (luma_subblock_size_y + 2) * 2);
+  bufs->cb_col_buf =
+      (int *)aom_malloc(sizeof(*bufs->cb_col_buf) *
+                        (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
+                        (2 >> chroma_subsamp_x));
+  bufs->cr_col_buf =
+      (int *)aom_malloc(sizeof(*bufs->cr_col_buf) *
+                        (chroma_subblock_size_y + (2 >> chroma_subsamp_y)) *
+                        (2 >> chroma_subsamp_x));
 
-  int chroma_block_size_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
-                            chroma_subblock_size_y * 2 + bottom_pad;
-  int chroma_block_size_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
-                            chroma_subblock_size_x * 2 +
-                            (2 >> chroma_subsamp_x) * ar_padding + right_pad;
+  if (!(bufs->y_line_buf && bufs->cb_line_buf && bufs->cr_line_buf &&
+        bufs->y_col_buf && bufs->cb_col_buf && bufs->cr_col_buf)) {
+    free_overlap_buffers(bufs);
+    return false;
+  }
+  return true;
+}
 
-  int luma_grain_stride = luma_block_size_x;
-  int chroma_grain_stride = chroma_block_size_x;
+// Frame-level state shared by all the threads adding grain. It is read-only
+// once the grain templates have been generated.
+typedef struct {
+  const aom_film_grain_t *params;
+  uint8_t *luma;
+  uint8_t *cb;
+  uint8_t *cr;
+  int height;
+  int width;
+  int luma_stride;
+  int chroma_stride;
+  int use_high_bit_depth;
+  int chroma_subsamp_y;
+  int chroma_subsamp_x;
+  int mc_identity;
+  int *luma_grain_block;
+  int *cb_grain_block;
+  int *cr_grain_block;
+  int luma_grain_stride;
+  int chroma_grain_stride;
+  int left_pad;
+  int top_pad;
+  int ar_padding;
+} GrainStripeParams;
+
+/*!\brief Add film grain to one stripe
+ *
+ * Adds grain to the 32 luma rows starting at row 2 * y, and to the
+ * corresponding chroma rows. Each stripe seeds its own random generator, so
+ * stripes only depend on each other through the overlap line buffers.
+ *
+ * \param[in]    gp               Frame-level grain state
+ * \param[in]    bufs             Overlap buffers, holding the bottom grain rows
+ *                                of stripe y - 16 if overlap is enabled
+ * \param[in]    y                Stripe position in units of 2 luma rows
+ * \param[in]    apply_noise      If 0, only update the overlap buffers for
+ *                                stripe y + 16 without touching the image
+ */
+static void add_film_grain_stripe(const GrainStripeParams *gp,
+                                  GrainOverlapBuffers *bufs, int y,
+                                  int apply_noise) {
+  const aom_film_grain_t *params = gp->params;
+  uint8_t *luma = gp->luma;
+  uint8_t *cb = gp->cb;
+  uint8_t *cr = gp->cr;
+  const int height = gp->height;
+  const int width = gp->width;
+  const int luma_stride = gp->luma_stride;
+  const int chroma_stride = gp->chroma_stride;
+  const int use_high_bit_depth = gp->use_high_bit_depth;
+  const int chroma_subsamp_y = gp->chroma_subsamp_y;
+  const int chroma_subsamp_x = gp->chroma_subsamp_x;
+  const int mc_identity = gp->mc_identity;
+  int *luma_grain_block = gp->luma_grain_block;
+  int *cb_grain_block = gp->cb_grain_block;
+  int *cr_grain_block = gp->cr_grain_block;
+  const int luma_grain_stride = gp->luma_grain_stride;
+  const int chroma_grain_stride = gp->chroma_grain_stride;
+  const int left_pad = gp->left_pad;
+  const int top_pad = gp->top_pad;
+  const int ar_padding = gp->ar_padding;
+
+  int *y_line_buf = bufs->y_line_buf;
+  int *cb_line_buf = bufs->cb_line_buf;
+  int *cr_line_buf = bufs->cr_line_buf;
+  int *y_col_buf = bufs->y_col_buf;
+  int *cb_col_buf = bufs->cb_col_buf;
+  int *cr_col_buf = bufs->cr_col_buf;
 
   int overlap = params->overlap_flag;
   int bit_depth = params->bit_depth;
 
-  const int grain_center = 128 << (bit_depth - 8);
-  grain_min = 0 - grain_center;
-  grain_max = grain_center - 1;
-
-  if (!init_arrays(params, luma_stride, chroma_stride, &pred_pos_luma,
-                   &pred_pos_chroma, &luma_grain_block, &cb_grain_block,
-                   &cr_grain_block, &y_line_buf, &cb_line_buf, &cr_line_buf,
-                   &y_col_buf, &cb_col_buf, &cr_col_buf,
-                   luma_block_size_y * luma_block_size_x,
-                   chroma_block_size_y * chroma_block_size_x, chroma_subsamp_y,
-                   chroma_subsamp_x))
-    return -1;
-
-  generate_luma_grain_block(params, pred_pos_luma, luma_grain_block,
-                            luma_block_size_y, luma_block_size_x,
-                            luma_grain_stride, left_pad, top_pad, right_pad,
-                            bottom_pad);
-
-  if (!generate_chroma_grain_blocks(
-          params, pred_pos_chroma, luma_grain_block, cb_grain_block,
-          cr_grain_block, luma_grain_stride, chroma_block_size_y,
-          chroma_block_size_x, chroma_grain_stride, left_pad, top_pad,
-          right_pad, bottom_pad, chroma_subsamp_y, chroma_subsamp_x))
-    return -1;
-
-  init_scaling_function(params->scaling_points_y, params->num_y_points,
-                        scaling_lut_y);
-
-  if (params->chroma_scaling_from_luma) {
-    memcpy(scaling_lut_cb, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
-    memcpy(scaling_lut_cr, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
-  } else {
-    init_scaling_function(params->scaling_points_cb, params->num_cb_points,
-                          scaling_lut_cb);
-    init_scaling_function(params->scaling_points_cr, params->num_cr_points,
-                          scaling_lut_cr);
-  }
-  for (int y = 0; y < height / 2; y += (luma_subblock_size_y >> 1)) {
-    init_random_generator(y * 2, params->random_seed);
-
-    for (int x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
-      int offset_y = get_random_number(8);
-      int offset_x = (offset_y >> 4) & 15;
-      offset_y &= 15;
-
-      int luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
-      int luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
-
-      int chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
-                            offset_y * (2 >> chroma_subsamp_y);
-      int chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
-                            offset_x * (2 >> chroma_subsamp_x);
-
-      if (overlap && x) {
-        ver_boundary_overlap(
-            y_col_buf, 2,
-            luma_grain_block + luma_offset_y * luma_grain_stride +
-                luma_offset_x,
-            luma_grain_stride, y_col_buf, 2, 2,
-            AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
-
-        ver_boundary_overlap(
-            cb_col_buf, 2 >> chroma_subsamp_x,
-            cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                chroma_offset_x,
-            chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
-            2 >> chroma_subsamp_x,
-            AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                   (height - (y << 1)) >> chroma_subsamp_y));
-
-        ver_boundary_overlap(
-            cr_col_buf, 2 >> chroma_subsamp_x,
-            cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                chroma_offset_x,
-            chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
-            2 >> chroma_subsamp_x,
-            AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                   (height - (y << 1)) >> chroma_subsamp_y));
-
+  uint16_t random_register;
+  init_random_generator(&random_register, y * 2, params->random_seed);
+
+  for (int x = 0; x < width / 2; x += (luma_subblock_size_x >> 1)) {
+    int offset_y = get_random_number(&random_register, 8);
+    int offset_x = (offset_y >> 4) & 15;
+    offset_y &= 15;
+
+    int luma_offset_y = left_pad + 2 * ar_padding + (offset_y << 1);
+    int luma_offset_x = top_pad + 2 * ar_padding + (offset_x << 1);
+
+    int chroma_offset_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
+                          offset_y * (2 >> chroma_subsamp_y);
+    int chroma_offset_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
+                          offset_x * (2 >> chroma_subsamp_x);
+
+    if (overlap && x) {
+      ver_boundary_overlap(
+          y_col_buf, 2,
+          luma_grain_block + luma_offset_y * luma_grain_stride +
+              luma_offset_x,
+          luma_grain_stride, y_col_buf, 2, 2,
+          AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
+
+      ver_boundary_overlap(
+          cb_col_buf, 2 >> chroma_subsamp_x,
+          cb_grain_block + chroma_offset_y * chroma_grain_stride +
+              chroma_offset_x,
+          chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+          2 >> chroma_subsamp_x,
+          AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                 (height - (y << 1)) >> chroma_subsamp_y));
+
+      ver_boundary_overlap(
+          cr_col_buf, 2 >> chroma_subsamp_x,
+          cr_grain_block + chroma_offset_y * chroma_grain_stride +
+              chroma_offset_x,
+          chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+          2 >> chroma_subsamp_x,
+          AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                 (height - (y << 1)) >> chroma_subsamp_y));
+
+      if (apply_noise) {
         int i = y ? 1 : 0;
 
         if (use_high_bit_depth) {
@@ -1152,89 +1114,91 @@ static int add_film_grain_run(const aom_film_grain_t *params, uint8_t *luma,
               bit_depth, chroma_subsamp_y, chroma_subsamp_x, mc_identity);
         }
       }
+    }
 
-      if (overlap && y) {
-        if (x) {
-          hor_boundary_overlap(y_line_buf + (x << 1), luma_stride, y_col_buf, 2,
-                               y_line_buf + (x << 1), luma_stride, 2, 2);
-
-          hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
-                               chroma_stride, cb_col_buf, 2 >> chroma_subsamp_x,
-                               cb_line_buf + x * (2 >> chroma_subsamp_x),
-                               chroma_stride, 2 >> chroma_subsamp_x,
-                               2 >> chroma_subsamp_y);
-
-          hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
-                               chroma_stride, cr_col_buf, 2 >> chroma_subsamp_x,
-                               cr_line_buf + x * (2 >> chroma_subsamp_x),
-                               chroma_stride, 2 >> chroma_subsamp_x,
-                               2 >> chroma_subsamp_y);
-        }
+    if (overlap && y && apply_noise) {
+      if (x) {
+        hor_boundary_overlap(y_line_buf + (x << 1), luma_stride, y_col_buf, 2,
+                             y_line_buf + (x << 1), luma_stride, 2, 2);
+
+        hor_boundary_overlap(cb_line_buf + x * (2 >> chroma_subsamp_x),
+                             chroma_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+                             cb_line_buf + x * (2 >> chroma_subsamp_x),
+                             chroma_stride, 2 >> chroma_subsamp_x,
+                             2 >> chroma_subsamp_y);
+
+        hor_boundary_overlap(cr_line_buf + x * (2 >> chroma_subsamp_x),
+                             chroma_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+                             cr_line_buf + x * (2 >> chroma_subsamp_x),
+                             chroma_stride, 2 >> chroma_subsamp_x,
+                             2 >> chroma_subsamp_y);
+      }
 
-        hor_boundary_overlap(
-            y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-            luma_grain_block + luma_offset_y * luma_grain_stride +
-                luma_offset_x + (x ? 2 : 0),
-            luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-            AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
-                   width - ((x ? x + 1 : 0) << 1)),
-            2);
-
-        hor_boundary_overlap(
-            cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_stride,
-            cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_grain_stride,
-            cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_stride,
-            AOMMIN(chroma_subblock_size_x -
-                       ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                   (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-            2 >> chroma_subsamp_y);
-
-        hor_boundary_overlap(
-            cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_stride,
-            cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_grain_stride,
-            cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-            chroma_stride,
-            AOMMIN(chroma_subblock_size_x -
-                       ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
-                   (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
-            2 >> chroma_subsamp_y);
+      hor_boundary_overlap(
+          y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+          luma_grain_block + luma_offset_y * luma_grain_stride +
+              luma_offset_x + (x ? 2 : 0),
+          luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+          AOMMIN(luma_subblock_size_x - ((x ? 1 : 0) << 1),
+                 width - ((x ? x + 1 : 0) << 1)),
+          2);
+
+      hor_boundary_overlap(
+          cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_stride,
+          cb_grain_block + chroma_offset_y * chroma_grain_stride +
+              chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_grain_stride,
+          cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_stride,
+          AOMMIN(chroma_subblock_size_x -
+                     ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                 (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+          2 >> chroma_subsamp_y);
+
+      hor_boundary_overlap(
+          cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_stride,
+          cr_grain_block + chroma_offset_y * chroma_grain_stride +
+              chroma_offset_x + ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_grain_stride,
+          cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+          chroma_stride,
+          AOMMIN(chroma_subblock_size_x -
+                     ((x ? 1 : 0) << (1 - chroma_subsamp_x)),
+                 (width - ((x ? x + 1 : 0) << 1)) >> chroma_subsamp_x),
+          2 >> chroma_subsamp_y);
 
-        if (use_high_bit_depth) {
-          add_noise_to_block_hbd(
-              params, (uint16_t *)luma + (y << 1) * luma_stride + (x << 1),
-              (uint16_t *)cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << ((1 - chroma_subsamp_x))),
-              (uint16_t *)cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << ((1 - chroma_subsamp_x))),
-              luma_stride, chroma_stride, y_line_buf + (x << 1),
-              cb_line_buf + (x << (1 - chroma_subsamp_x)),
-              cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
-              chroma_stride, 1,
-              AOMMIN(luma_subblock_size_x >> 1, width / 2 - x), bit_depth,
-              chroma_subsamp_y, chroma_subsamp_x, mc_identity);
-        } else {
-          add_noise_to_block(
-              params, luma + (y << 1) * luma_stride + (x << 1),
-              cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << ((1 - chroma_subsamp_x))),
-              cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
-                  (x << ((1 - chroma_subsamp_x))),
-              luma_stride, chroma_stride, y_line_buf + (x << 1),
-              cb_line_buf + (x << (1 - chroma_subsamp_x)),
-              cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
-              chroma_stride, 1,
-              AOMMIN(luma_subblock_size_x >> 1, width / 2 - x), bit_depth,
-              chroma_subsamp_y, chroma_subsamp_x, mc_identity);
-        }
+      if (use_high_bit_depth) {
+        add_noise_to_block_hbd(
+            params, (uint16_t *)luma + (y << 1) * luma_stride + (x << 1),
+            (uint16_t *)cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
+                (x << ((1 - chroma_subsamp_x))),
+            (uint16_t *)cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
+                (x << ((1 - chroma_subsamp_x))),
+            luma_stride, chroma_stride, y_line_buf + (x << 1),
+            cb_line_buf + (x << (1 - chroma_subsamp_x)),
+            cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
+            chroma_stride, 1,
+            AOMMIN(luma_subblock_size_x >> 1, width / 2 - x), bit_depth,
+            chroma_subsamp_y, chroma_subsamp_x, mc_identity);
+      } else {
+        add_noise_to_block(
+            params, luma + (y << 1) * luma_stride + (x << 1),
+            cb + (y << (1 - chroma_subsamp_y)) * chroma_stride +
+                (x << ((1 - chroma_subsamp_x))),
+            cr + (y << (1 - chroma_subsamp_y)) * chroma_stride +
+                (x << ((1 - chroma_subsamp_x))),
+            luma_stride, chroma_stride, y_line_buf + (x << 1),
+            cb_line_buf + (x << (1 - chroma_subsamp_x)),
+            cr_line_buf + (x << (1 - chroma_subsamp_x)), luma_stride,
+            chroma_stride, 1,
+            AOMMIN(luma_subblock_size_x >> 1, width / 2 - x), bit_depth,
+            chroma_subsamp_y, chroma_subsamp_x, mc_identity);
       }
+    }
 
+    if (apply_noise) {
       int i = overlap && y ? 1 : 0;
       int j = overlap && x ? 1 : 0;
 
@@ -1286,91 +1250,289 @@ static int add_film_grain_run(const aom_film_grain_t *params, uint8_t *luma,
             AOMMIN(luma_subblock_size_x >> 1, width / 2 - x) - j, bit_depth,
             chroma_subsamp_y, chroma_subsamp_x, mc_identity);
       }
+    }
 
-      if (overlap) {
-        if (x) {
-          // Copy overlapped column bufer to line buffer
-          copy_area(y_col_buf + (luma_subblock_size_y << 1), 2,
-                    y_line_buf + (x << 1), luma_stride, 2, 2);
-
-          copy_area(
-              cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-              2 >> chroma_subsamp_x,
-              cb_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
-              2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
-
-          copy_area(
-              cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
-              2 >> chroma_subsamp_x,
-              cr_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
-              2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
-        }
+    if (overlap) {
+      if (x) {
+        // Copy overlapped column bufer to line buffer
+        copy_area(y_col_buf + (luma_subblock_size_y << 1), 2,
+                  y_line_buf + (x << 1), luma_stride, 2, 2);
+
+        copy_area(
+            cb_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
+            2 >> chroma_subsamp_x,
+            cb_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
+            2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
 
-        // Copy grain to the line buffer for overlap with a bottom block
         copy_area(
-            luma_grain_block +
-                (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
-                luma_offset_x + ((x ? 2 : 0)),
-            luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
-            AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0), 2);
-
-        copy_area(cb_grain_block +
-                      (chroma_offset_y + chroma_subblock_size_y) *
-                          chroma_grain_stride +
-                      chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                  chroma_grain_stride,
-                  cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                  chroma_stride,
-                  AOMMIN(chroma_subblock_size_x,
-                         ((width - (x << 1)) >> chroma_subsamp_x)) -
-                      (x ? 2 >> chroma_subsamp_x : 0),
-                  2 >> chroma_subsamp_y);
-
-        copy_area(cr_grain_block +
-                      (chroma_offset_y + chroma_subblock_size_y) *
-                          chroma_grain_stride +
-                      chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
-                  chroma_grain_stride,
-                  cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
-                  chroma_stride,
-                  AOMMIN(chroma_subblock_size_x,
-                         ((width - (x << 1)) >> chroma_subsamp_x)) -
-                      (x ? 2 >> chroma_subsamp_x : 0),
-                  2 >> chroma_subsamp_y);
-
-        // Copy grain to the column buffer for overlap with the next block to
-        // the right
-
-        copy_area(luma_grain_block + luma_offset_y * luma_grain_stride +
-                      luma_offset_x + luma_subblock_size_x,
-                  luma_grain_stride, y_col_buf, 2, 2,
-                  AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
-
-        copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride +
-                      chroma_offset_x + chroma_subblock_size_x,
-                  chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
-                  2 >> chroma_subsamp_x,
-                  AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                         (height - (y << 1)) >> chroma_subsamp_y));
-
-        copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride +
-                      chroma_offset_x + chroma_subblock_size_x,
-                  chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
-                  2 >> chroma_subsamp_x,
-                  AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
-                         (height - (y << 1)) >> chroma_subsamp_y));
+            cr_col_buf + (chroma_subblock_size_y << (1 - chroma_subsamp_x)),
+            2 >> chroma_subsamp_x,
+            cr_line_buf + (x << (1 - chroma_subsamp_x)), chroma_stride,
+            2 >> chroma_subsamp_x, 2 >> chroma_subsamp_y);
+      }
+
+      // Copy grain to the line buffer for overlap with a bottom block
+      copy_area(
+          luma_grain_block +
+              (luma_offset_y + luma_subblock_size_y) * luma_grain_stride +
+              luma_offset_x + ((x ? 2 : 0)),
+          luma_grain_stride, y_line_buf + ((x ? x + 1 : 0) << 1), luma_stride,
+          AOMMIN(luma_subblock_size_x, width - (x << 1)) - (x ? 2 : 0), 2);
+
+      copy_area(cb_grain_block +
+                    (chroma_offset_y + chroma_subblock_size_y) *
+                        chroma_grain_stride +
+                    chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                chroma_grain_stride,
+                cb_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x,
+                       ((width - (x << 1)) >> chroma_subsamp_x)) -
+                    (x ? 2 >> chroma_subsamp_x : 0),
+                2 >> chroma_subsamp_y);
+
+      copy_area(cr_grain_block +
+                    (chroma_offset_y + chroma_subblock_size_y) *
+                        chroma_grain_stride +
+                    chroma_offset_x + (x ? 2 >> chroma_subsamp_x : 0),
+                chroma_grain_stride,
+                cr_line_buf + ((x ? x + 1 : 0) << (1 - chroma_subsamp_x)),
+                chroma_stride,
+                AOMMIN(chroma_subblock_size_x,
+                       ((width - (x << 1)) >> chroma_subsamp_x)) -
+                    (x ? 2 >> chroma_subsamp_x : 0),
+                2 >> chroma_subsamp_y);
+
+      // Copy grain to the column buffer for overlap with the next block to
+      // the right
+
+      copy_area(luma_grain_block + luma_offset_y * luma_grain_stride +
+                    luma_offset_x + luma_subblock_size_x,
+                luma_grain_stride, y_col_buf, 2, 2,
+                AOMMIN(luma_subblock_size_y + 2, height - (y << 1)));
+
+      copy_area(cb_grain_block + chroma_offset_y * chroma_grain_stride +
+                    chroma_offset_x + chroma_subblock_size_x,
+                chroma_grain_stride, cb_col_buf, 2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                       (height - (y << 1)) >> chroma_subsamp_y));
+
+      copy_area(cr_grain_block + chroma_offset_y * chroma_grain_stride +
+                    chroma_offset_x + chroma_subblock_size_x,
+                chroma_grain_stride, cr_col_buf, 2 >> chroma_subsamp_x,
+                2 >> chroma_subsamp_x,
+                AOMMIN(chroma_subblock_size_y + (2 >> chroma_subsamp_y),
+                       (height - (y << 1)) >> chroma_subsamp_y));
+    }
+  }
+}
+
+typedef struct {
+  const GrainStripeParams *gp;
+  GrainOverlapBuffers bufs;
+  int first_stripe;
+  int stripe_step;
+} GrainWorkerData;
+
+static int add_film_grain_worker(void *arg1, void *unused) {
+  (void)unused;
+  GrainWorkerData *const wd = (GrainWorkerData *)arg1;
+  const GrainStripeParams *const gp = wd->gp;
+  const int stripe_height = luma_subblock_size_y >> 1;
+  int prev_y = -1;
+
+  for (int y = wd->first_stripe * stripe_height; y < gp->height / 2;
+       y += wd->stripe_step * stripe_height) {
+    // The top overlap rows are blended with the grain the stripe above left
+    // in the line buffers. Rebuild it if that stripe ran on another thread.
+    if (gp->params->overlap_flag && y && prev_y != y - stripe_height)
+      add_film_grain_stripe(gp, &wd->bufs, y - stripe_height, 0);
+    add_film_grain_stripe(gp, &wd->bufs, y, 1);
+    prev_y = y;
+  }
+  return 1;
+}
+
+/*!\brief Add film grain
+ *
+ * Add film grain to an image
+ *
+ * Returns 0 for success, -1 for failure
+ *
+ * \param[in]    grain_params     Grain parameters
+ * \param[in]    luma             luma plane
+ * \param[in]    cb               cb plane
+ * \param[in]    cr               cr plane
+ * \param[in]    height           luma plane height
+ * \param[in]    width            luma plane width
+ * \param[in]    luma_stride      luma plane stride
+ * \param[in]    chroma_stride    chroma plane stride
+ * \param[in]    workers          Workers to split the stripes over, or NULL
+ * \param[in]    num_workers      Number of workers
+ */
+static int add_film_grain_run(const aom_film_grain_t *params, uint8_t *luma,
+                              uint8_t *cb, uint8_t *cr, int height, int width,
+                              int luma_stride, int chroma_stride,
+                              int use_high_bit_depth, int chroma_subsamp_y,
+                              int chroma_subsamp_x, int mc_identity,
+                              AVxWorker *workers, int num_workers) {
+  int **pred_pos_luma;
+  int **pred_pos_chroma;
+  int *luma_grain_block;
+  int *cb_grain_block;
+  int *cr_grain_block;
+
+  int left_pad = 3;
+  int right_pad = 3;  // padding to offset for AR coefficients
+  int top_pad = 3;
+  int bottom_pad = 0;
+
+  int ar_padding = 3;  // maximum lag used for stabilization of AR coefficients
+
+  luma_subblock_size_y = 32;
+  luma_subblock_size_x = 32;
+
+  chroma_subblock_size_y = luma_subblock_size_y >> chroma_subsamp_y;
+  chroma_subblock_size_x = luma_subblock_size_x >> chroma_subsamp_x;
+
+  // Initial padding is only needed for generation of
+  // film grain templates (to stabilize the AR process)
+  // Only a 64x64 luma and 32x32 chroma part of a template
+  // is used later for adding grain, padding can be discarded
+
+  int luma_block_size_y =
+      top_pad + 2 * ar_padding + luma_subblock_size_y * 2 + bottom_pad;
+  int luma_block_size_x = left_pad + 2 * ar_padding + luma_subblock_size_x * 2 +
+                          2 * ar_padding + right_pad;
+
+  int chroma_block_size_y = top_pad + (2 >> chroma_subsamp_y) * ar_padding +
+                            chroma_subblock_size_y * 2 + bottom_pad;
+  int chroma_block_size_x = left_pad + (2 >> chroma_subsamp_x) * ar_padding +
+                            chroma_subblock_size_x * 2 +
+                            (2 >> chroma_subsamp_x) * ar_padding + right_pad;
+
+  int luma_grain_stride = luma_block_size_x;
+  int chroma_grain_stride = chroma_block_size_x;
+
+  int bit_depth = params->bit_depth;
+
+  const int grain_center = 128 << (bit_depth - 8);
+  grain_min = 0 - grain_center;
+  grain_max = grain_center - 1;
+
+  if (!init_arrays(params, &pred_pos_luma, &pred_pos_chroma, &luma_grain_block,
+                   &cb_grain_block, &cr_grain_block,
+                   luma_block_size_y * luma_block_size_x,
+                   chroma_block_size_y * chroma_block_size_x))
+    return -1;
+
+  generate_luma_grain_block(params, pred_pos_luma, luma_grain_block,
+                            luma_block_size_y, luma_block_size_x,
+                            luma_grain_stride, left_pad, top_pad, right_pad,
+                            bottom_pad);
+
+  if (!generate_chroma_grain_blocks(
+          params, pred_pos_chroma, luma_grain_block, cb_grain_block,
+          cr_grain_block, luma_grain_stride, chroma_block_size_y,
+          chroma_block_size_x, chroma_grain_stride, left_pad, top_pad,
+          right_pad, bottom_pad, chroma_subsamp_y, chroma_subsamp_x)) {
+    dealloc_arrays(params, &pred_pos_luma, &pred_pos_chroma, &luma_grain_block,
+                   &cb_grain_block, &cr_grain_block);
+    return -1;
+  }
+
+  init_scaling_function(params->scaling_points_y, params->num_y_points,
+                        scaling_lut_y);
+
+  if (params->chroma_scaling_from_luma) {
+    memcpy(scaling_lut_cb, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
+    memcpy(scaling_lut_cr, scaling_lut_y, sizeof(*scaling_lut_y) * 256);
+  } else {
+    init_scaling_function(params->scaling_points_cb, params->num_cb_points,
+                          scaling_lut_cb);
+    init_scaling_function(params->scaling_points_cr, params->num_cr_points,
+                          scaling_lut_cr);
+  }
+
+  GrainStripeParams gp;
+  gp.params = params;
+  gp.luma = luma;
+  gp.cb = cb;
+  gp.cr = cr;
+  gp.height = height;
+  gp.width = width;
+  gp.luma_stride = luma_stride;
+  gp.chroma_stride = chroma_stride;
+  gp.use_high_bit_depth = use_high_bit_depth;
+  gp.chroma_subsamp_y = chroma_subsamp_y;
+  gp.chroma_subsamp_x = chroma_subsamp_x;
+  gp.mc_identity = mc_identity;
+  gp.luma_grain_block = luma_grain_block;
+  gp.cb_grain_block = cb_grain_block;
+  gp.cr_grain_block = cr_grain_block;
+  gp.luma_grain_stride = luma_grain_stride;
+  gp.chroma_grain_stride = chroma_grain_stride;
+  gp.left_pad = left_pad;
+  gp.top_pad = top_pad;
+  gp.ar_padding = ar_padding;
+
+  // Stripes are dealt out round-robin. A single worker walks all of them in
+  // order on the calling thread, which is the serial path.
+  const int stripe_height = luma_subblock_size_y >> 1;
+  const int num_stripes = (height / 2 + stripe_height - 1) / stripe_height;
+  num_workers = workers ? AOMMIN(num_workers, num_stripes) : 1;
+  num_workers = AOMMAX(num_workers, 1);
+
+  GrainWorkerData *worker_data =
+      (GrainWorkerData *)aom_calloc(num_workers, sizeof(*worker_data));
+  bool ok = worker_data != NULL;
+  for (int i = 0; ok && i < num_workers; ++i) {
+    worker_data[i].gp = &gp;
+    worker_data[i].first_stripe = i;
+    worker_data[i].stripe_step = num_workers;
+    ok = alloc_overlap_buffers(&worker_data[i].bufs, luma_stride, chroma_stride,
+                               chroma_subsamp_y, chroma_subsamp_x);
+  }
+
+  if (ok && num_workers == 1) {
+    add_film_grain_worker(&worker_data[0], NULL);
+  } else if (ok) {
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = num_workers - 1; i >= 0; --i) {
+      AVxWorker *const worker = &workers[i];
+      worker->hook = add_film_grain_worker;
+      worker->data1 = &worker_data[i];
+      worker->data2 = NULL;
+      worker->had_error = 0;
+      if (i == 0) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
       }
     }
+    for (int i = num_workers - 1; i > 0; --i) winterface->sync(&workers[i]);
   }
 
+  if (worker_data) {
+    for (int i = 0; i < num_workers; ++i) {
+      free_overlap_buffers(&worker_data[i].bufs);
+    }
+    aom_free(worker_data);
+  }
   dealloc_arrays(params, &pred_pos_luma, &pred_pos_chroma, &luma_grain_block,
-                 &cb_grain_block, &cr_grain_block, &y_line_buf, &cb_line_buf,
-                 &cr_line_buf, &y_col_buf, &cb_col_buf, &cr_col_buf);
-  return 0;
+                 &cb_grain_block, &cr_grain_block);
+  return ok ? 0 : -1;
 }
 
 int av1_add_film_grain(const aom_film_grain_t *params, const aom_image_t *src,
                        aom_image_t *dst) {
+  return av1_add_film_grain_mt(params, src, dst, NULL, 0);
+}
+
+int av1_add_film_grain_mt(const aom_film_grain_t *params,
+                          const aom_image_t *src, aom_image_t *dst,
+                          AVxWorker *workers, int num_workers) {
   uint8_t *luma, *cb, *cr;
   int height, width, luma_stride, chroma_stride;
   int use_high_bit_depth = 0;
@@ -1378,6 +1540,10 @@ int av1_add_film_grain(const aom_film_grain_t *params, const aom_image_t *src,
   int chroma_subsamp_y = 0;
   int mc_identity = src->mc == AOM_CICP_MC_IDENTITY ? 1 : 0;
 
+  // Callers outside the decoder (e.g. examples/noise_model.c) may not have
+  // initialized the function pointers yet.
+  av1_rtcd();
+
   switch (src->fmt) {
     case AOM_IMG_FMT_AOMI420:
     case AOM_IMG_FMT_I420:
@@ -1472,5 +1638,6 @@ int av1_add_film_grain(const aom_film_grain_t *params, const aom_image_t *src,
 
   return add_film_grain_run(params, luma, cb, cr, height, width, luma_stride,
                             chroma_stride, use_high_bit_depth, chroma_subsamp_y,
-                            chroma_subsamp_x, mc_identity);
+                            chroma_subsamp_x, mc_identity, workers,
+                            num_workers);
 }
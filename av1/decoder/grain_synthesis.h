@@ -24,6 +24,7 @@ extern "C" {
 
 #include "aom_dsp/grain_params.h"
 #include "aom/aom_image.h"
+#include "aom_util/aom_thread.h"
 
 /*!\brief Add film grain
  *
@@ -38,6 +39,25 @@ extern "C" {
 int av1_add_film_grain(const aom_film_grain_t *grain_params,
                        const aom_image_t *src, aom_image_t *dst);
 
+/*!\brief Add film grain using worker threads
+ *
+ * Same as av1_add_film_grain(), but splits the image into 32-row stripes that
+ * are processed in parallel on the given workers. The output is identical to
+ * that of av1_add_film_grain().
+ *
+ * Returns 0 for success, -1 for failure
+ *
+ * \param[in]    grain_params     Grain parameters
+ * \param[in]    src              Source image
+ * \param[out]   dst              Resulting image with grain
+ * \param[in]    workers          Idle workers, or NULL to run on the calling
+ *                                thread only
+ * \param[in]    num_workers      Number of workers
+ */
+int av1_add_film_grain_mt(const aom_film_grain_t *grain_params,
+                          const aom_image_t *src, aom_image_t *dst,
+                          AVxWorker *workers, int num_workers);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
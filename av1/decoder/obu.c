@@ -283,8 +283,10 @@ static uint32_t read_frame_header_obu(AV1Decoder *pbi,
                                       const uint8_t *data,
                                       const uint8_t **p_data_end,
                                       int trailing_bits_present) {
+  dec_start_stage_timing(pbi, kDecStageFrameHeader);
   const uint32_t hdr_size =
       av1_decode_frame_headers_and_setup(pbi, rb, trailing_bits_present);
+  dec_end_stage_timing(pbi, kDecStageFrameHeader);
   const AV1_COMMON *cm = &pbi->common;
   if (cm->show_existing_frame) {
     *p_data_end = data + hdr_size;
@@ -346,13 +348,71 @@ static int32_t read_tile_group_header(AV1Decoder *pbi,
   return ((rb->bit_offset - saved_bit_offset + 7) >> 3);
 }
 
+// Locates the tiles of the tile group OBUs from 'data' on, the first of which
+// starts at 'start_tile', up to the last tile of the frame. Returns the end of
+// the last of these OBUs, or NULL if the rest of the frame cannot be located
+// ahead of decoding. The OBUs are parsed again, with all the checks, when
+// aom_decode_frame_from_obus() reaches them.
+static const uint8_t *locate_remaining_tile_groups(AV1Decoder *pbi,
+                                                   const uint8_t *data,
+                                                   const uint8_t *data_end,
+                                                   int start_tile) {
+  const CommonTileParams *const tiles = &pbi->common.tiles;
+  const int num_tiles = tiles->rows * tiles->cols;
+  const int tile_bits = tiles->log2_rows + tiles->log2_cols;
+
+  assert(!tiles->large_scale && num_tiles > 1);
+  while (start_tile < num_tiles) {
+    ObuHeader obu_header;
+    size_t payload_size = 0;
+    size_t bytes_read = 0;
+    if (aom_read_obu_header_and_size(data, data_end - data, pbi->is_annexb,
+                                     &obu_header, &payload_size,
+                                     &bytes_read) != AOM_CODEC_OK)
+      return NULL;
+    data += bytes_read;
+    if ((size_t)(data_end - data) < payload_size) return NULL;
+    const uint8_t *const obu_end = data + payload_size;
+
+    if (obu_header.type == OBU_TEMPORAL_DELIMITER ||
+        obu_header.type == OBU_SEQUENCE_HEADER)
+      return NULL;
+    if (!is_obu_in_current_operating_point(pbi, &obu_header) ||
+        obu_header.type == OBU_METADATA || obu_header.type == OBU_PADDING) {
+      data = obu_end;
+      continue;
+    }
+    if (obu_header.type != OBU_TILE_GROUP || payload_size == 0) return NULL;
+
+    // The tile group header, see read_tile_group_header().
+    struct aom_read_bit_buffer rb = { data, obu_end, 0, NULL, NULL };
+    int tg_start = 0;
+    int tg_end = num_tiles - 1;
+    if (aom_rb_read_bit(&rb)) {
+      if (payload_size * 8 < (size_t)(1 + 2 * tile_bits)) return NULL;
+      tg_start = aom_rb_read_literal(&rb, tile_bits);
+      tg_end = aom_rb_read_literal(&rb, tile_bits);
+    }
+    if (tg_start != start_tile || tg_end < tg_start || tg_end >= num_tiles)
+      return NULL;
+    const uint8_t *const tile_data = data + ((rb.bit_offset + 7) >> 3);
+    if (!av1_get_tile_group_buffers(pbi, tile_data, obu_end, tg_start, tg_end))
+      return NULL;
+    start_tile = tg_end + 1;
+    data = obu_end;
+  }
+  return data;
+}
+
 // On success, returns the tile group OBU size. On failure, sets
 // pbi->common.error.error_code and returns 0.
 static uint32_t read_one_tile_group_obu(
     AV1Decoder *pbi, struct aom_read_bit_buffer *rb, int is_first_tg,
-    const uint8_t *data, const uint8_t *data_end, const uint8_t **p_data_end,
+    const uint8_t *data, const uint8_t *data_end,
+    const uint8_t *frame_data_end, const uint8_t **p_data_end,
     int *is_last_tg, int tile_start_implicit) {
   AV1_COMMON *const cm = &pbi->common;
+  const int num_tiles = cm->tiles.rows * cm->tiles.cols;
   int start_tile, end_tile;
   int32_t header_size, tg_payload_size;
 
@@ -363,8 +423,30 @@ static uint32_t read_one_tile_group_obu(
                                        tile_start_implicit);
   if (header_size == -1 || byte_alignment(cm, rb)) return 0;
   data += header_size;
-  av1_decode_tg_tiles_and_wrapup(pbi, data, data_end, p_data_end, start_tile,
-                                 end_tile, is_first_tg);
+  if (pbi->tiles_decoded_ahead) {
+    *p_data_end = av1_get_tile_group_end(pbi, end_tile);
+  } else {
+    // When the frame has more tile groups, locate all their tiles first so
+    // that the tile workers decode the tiles of the whole frame together
+    // instead of one tile group at a time.
+    const uint8_t *frame_tiles_end = NULL;
+    if (is_first_tg && pbi->max_threads > 1 && !cm->tiles.large_scale &&
+        end_tile != num_tiles - 1 &&
+        av1_get_tile_group_buffers(pbi, data, data_end, start_tile,
+                                   end_tile)) {
+      frame_tiles_end = locate_remaining_tile_groups(pbi, data_end,
+                                                     frame_data_end,
+                                                     end_tile + 1);
+    }
+    if (frame_tiles_end != NULL) {
+      av1_decode_located_tiles_and_wrapup(pbi, frame_tiles_end, p_data_end,
+                                          start_tile, end_tile, is_first_tg);
+      pbi->tiles_decoded_ahead = 1;
+    } else {
+      av1_decode_tg_tiles_and_wrapup(pbi, data, data_end, p_data_end,
+                                     start_tile, end_tile, is_first_tg);
+    }
+  }
 
   tg_payload_size = (uint32_t)(*p_data_end - data);
 
@@ -426,7 +508,8 @@ static void yv12_tile_copy(const YV12_BUFFER_CONFIG *src, int hstart1,
   return;
 }
 
-static void copy_decoded_tile_to_tile_list_buffer(AV1Decoder *pbi, int tile_idx,
+static void copy_decoded_tile_to_tile_list_buffer(AV1Decoder *pbi, int tile_row,
+                                                  int tile_col, int tile_idx,
                                                   int tile_width_in_pixels,
                                                   int tile_height_in_pixels) {
   AV1_COMMON *const cm = &pbi->common;
@@ -447,9 +530,9 @@ static void copy_decoded_tile_to_tile_list_buffer(AV1Decoder *pbi, int tile_idx,
     const int w = tile_width_in_pixels >> shift_x;
 
     // src offset
-    int vstart1 = pbi->dec_tile_row * h;
+    int vstart1 = tile_row * h;
     int vend1 = vstart1 + h;
-    int hstart1 = pbi->dec_tile_col * w;
+    int hstart1 = tile_col * w;
     int hend1 = hstart1 + w;
     // dst offset
     int vstart2 = tr * h;
@@ -479,6 +562,112 @@ static void copy_decoded_tile_to_tile_list_buffer(AV1Decoder *pbi, int tile_idx,
   }
 }
 
+// Largest number of tiles of a tile list decoded together on the tile workers.
+#define MAX_TILE_LIST_WAVE 64
+
+// Stores the decoded tile in slot 'tile_idx' of the tile list output buffer
+// in the tile cache.
+static void cache_tile_list_tile(AV1Decoder *pbi, const TileListTileDec *tile,
+                                 uint32_t payload_size,
+                                 int tile_width_in_pixels,
+                                 int tile_height_in_pixels) {
+  if (pbi->tile_cache.budget == 0) return;
+  const int tr =
+      tile->tile_idx / (pbi->output_frame_width_in_tiles_minus_1 + 1);
+  const int tc =
+      tile->tile_idx % (pbi->output_frame_width_in_tiles_minus_1 + 1);
+  av1_tile_cache_insert(&pbi->tile_cache, tile->ref_idx, tile->tile_row,
+                        tile->tile_col, tile->data, tile->size, payload_size,
+                        &pbi->tile_list_outbuf, tc * tile_width_in_pixels,
+                        tr * tile_height_in_pixels);
+}
+
+// Copies the tile from the tile cache to the tile list output buffer if it is
+// there. Returns the cached tile, or NULL.
+static const TileCacheEntry *read_cached_tile_list_tile(
+    AV1Decoder *pbi, const TileListTileDec *tile, int tile_width_in_pixels,
+    int tile_height_in_pixels) {
+  TileCache *const tile_cache = &pbi->tile_cache;
+  if (tile_cache->budget == 0) return NULL;
+  const TileCacheEntry *const entry =
+      av1_tile_cache_lookup(tile_cache, tile->ref_idx, tile->tile_row,
+                            tile->tile_col, tile->data, tile->size);
+  if (entry == NULL) return NULL;
+  const int tr =
+      tile->tile_idx / (pbi->output_frame_width_in_tiles_minus_1 + 1);
+  const int tc =
+      tile->tile_idx % (pbi->output_frame_width_in_tiles_minus_1 + 1);
+  ++tile_cache->hits;
+  av1_tile_cache_read(tile_cache, entry, &pbi->tile_list_outbuf,
+                      tc * tile_width_in_pixels, tr * tile_height_in_pixels);
+  return entry;
+}
+
+static int tile_list_wave_has_position(const TileListTileDec *wave,
+                                       int num_wave, int tile_row,
+                                       int tile_col) {
+  for (int i = 0; i < num_wave; ++i) {
+    if (wave[i].tile_row == tile_row && wave[i].tile_col == tile_col) return 1;
+  }
+  return 0;
+}
+
+// Decodes the 'num_tiles' tiles of pbi->tile_list_tiles on the tile workers.
+// The reference frame is swapped for the whole frame, and a tile position of
+// the frame is decoded by one worker at a time, so each wave takes tiles at
+// distinct positions that use the same anchor frame.
+static void decode_tile_list_in_waves(AV1Decoder *pbi, int num_tiles,
+                                      const uint8_t *data_end,
+                                      int tile_width_in_pixels,
+                                      int tile_height_in_pixels) {
+  AV1_COMMON *const cm = &pbi->common;
+  TileListTileDec *const tiles = pbi->tile_list_tiles;
+  TileListTileDec wave[MAX_TILE_LIST_WAVE];
+  int tile_ids[MAX_TILE_LIST_WAVE];
+
+  while (num_tiles > 0) {
+    const int ref_idx = tiles[0].ref_idx;
+    int num_wave = 0;
+    int num_left = 0;
+    for (int i = 0; i < num_tiles; ++i) {
+      const TileListTileDec *const tile = &tiles[i];
+      if (tile->ref_idx != ref_idx || num_wave == MAX_TILE_LIST_WAVE ||
+          tile_list_wave_has_position(wave, num_wave, tile->tile_row,
+                                      tile->tile_col)) {
+        tiles[num_left++] = *tile;
+        continue;
+      }
+      // An earlier wave may have decoded the same tile.
+      if (read_cached_tile_list_tile(pbi, tile, tile_width_in_pixels,
+                                     tile_height_in_pixels) != NULL)
+        continue;
+      if (pbi->tile_cache.budget > 0) ++pbi->tile_cache.misses;
+      wave[num_wave++] = *tile;
+    }
+    num_tiles = num_left;
+    if (num_wave == 0) continue;
+
+    av1_set_reference_dec(cm, cm->remapped_ref_idx[0], 1,
+                          &pbi->ext_refs.refs[ref_idx]);
+    for (int i = 0; i < num_wave; ++i) {
+      TileBufferDec *const buf =
+          &pbi->tile_buffers[wave[i].tile_row][wave[i].tile_col];
+      buf->data = wave[i].data;
+      buf->size = wave[i].size;
+      tile_ids[i] = wave[i].tile_row * cm->tiles.cols + wave[i].tile_col;
+    }
+    av1_decode_tile_list_tiles_mt(pbi, data_end, tile_ids, num_wave);
+
+    for (int i = 0; i < num_wave; ++i) {
+      copy_decoded_tile_to_tile_list_buffer(
+          pbi, wave[i].tile_row, wave[i].tile_col, wave[i].tile_idx,
+          tile_width_in_pixels, tile_height_in_pixels);
+      cache_tile_list_tile(pbi, &wave[i], wave[i].size, tile_width_in_pixels,
+                           tile_height_in_pixels);
+    }
+  }
+}
+
 // Only called while large_scale_tile = 1.
 //
 // On success, returns the tile list OBU size. On failure, sets
@@ -490,10 +679,19 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
                                               const uint8_t **p_data_end,
                                               int *frame_decoding_finished) {
   AV1_COMMON *const cm = &pbi->common;
+  TileCache *const tile_cache = &pbi->tile_cache;
   uint32_t tile_list_payload_size = 0;
   const int num_tiles = cm->tiles.cols * cm->tiles.rows;
   const int start_tile = 0;
   const int end_tile = num_tiles - 1;
+  const int use_cache = tile_cache->budget > 0;
+  // The tiles are decoded in waves on the tile workers, after the whole tile
+  // list is read, when they do not need to be filtered. A single tile takes
+  // up to the end of its coded data, so its payload size is only known once
+  // it is decoded.
+  const int use_waves =
+      pbi->max_threads > 1 && num_tiles > 1 && cm->tiles.single_tile_decoding;
+  int num_wave_tiles = 0;
   int i = 0;
 
   // Process the tile list info.
@@ -525,6 +723,11 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
 
   // Allocate output frame buffer for the tile list.
   alloc_tile_list_buffer(pbi, tile_width_in_pixels, tile_height_in_pixels);
+  if (use_cache) {
+    av1_tile_cache_set_layout(tile_cache, &pbi->tile_list_outbuf,
+                              tile_width_in_pixels, tile_height_in_pixels,
+                              av1_num_planes(cm));
+  }
 
   uint32_t tile_list_info_bytes = 4;
   tile_list_payload_size += tile_list_info_bytes;
@@ -539,14 +742,11 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
 
     // Read out the tile info.
     uint32_t tile_info_bytes = 5;
-    // Set reference for each tile.
     int ref_idx = aom_rb_read_literal(rb, 8);
     if (ref_idx >= MAX_EXTERNAL_REFERENCES) {
       pbi->error.error_code = AOM_CODEC_CORRUPT_FRAME;
       return 0;
     }
-    av1_set_reference_dec(cm, cm->remapped_ref_idx[0], 1,
-                          &pbi->ext_refs.refs[ref_idx]);
 
     pbi->dec_tile_row = aom_rb_read_literal(rb, 8);
     pbi->dec_tile_col = aom_rb_read_literal(rb, 8);
@@ -564,21 +764,49 @@ static uint32_t read_and_decode_one_tile_list(AV1Decoder *pbi,
       return 0;
     }
 
-    av1_decode_tg_tiles_and_wrapup(pbi, data, data + pbi->coded_tile_data_size,
-                                   p_data_end, start_tile, end_tile, 0);
-    uint32_t tile_payload_size = (uint32_t)(*p_data_end - data);
+    TileListTileDec tile;
+    tile.ref_idx = ref_idx;
+    tile.tile_row = pbi->dec_tile_row;
+    tile.tile_col = pbi->dec_tile_col;
+    tile.tile_idx = tile_idx;
+    tile.data = data;
+    tile.size = pbi->coded_tile_data_size;
+
+    uint32_t tile_payload_size;
+    const TileCacheEntry *const entry = read_cached_tile_list_tile(
+        pbi, &tile, tile_width_in_pixels, tile_height_in_pixels);
+    if (entry != NULL) {
+      tile_payload_size = entry->payload_size;
+    } else if (use_waves) {
+      pbi->tile_list_tiles[num_wave_tiles++] = tile;
+      tile_payload_size = tile.size;
+    } else {
+      if (use_cache) ++tile_cache->misses;
+      // Set reference for the tile.
+      av1_set_reference_dec(cm, cm->remapped_ref_idx[0], 1,
+                            &pbi->ext_refs.refs[ref_idx]);
+      av1_decode_tg_tiles_and_wrapup(pbi, data, data + tile.size, p_data_end,
+                                     start_tile, end_tile, 0);
+      tile_payload_size = (uint32_t)(*p_data_end - data);
+
+      // Copy the decoded tile to the tile list output buffer.
+      copy_decoded_tile_to_tile_list_buffer(pbi, tile.tile_row, tile.tile_col,
+                                            tile_idx, tile_width_in_pixels,
+                                            tile_height_in_pixels);
+      cache_tile_list_tile(pbi, &tile, tile_payload_size,
+                           tile_width_in_pixels, tile_height_in_pixels);
+    }
 
     tile_list_payload_size += tile_info_bytes + tile_payload_size;
 
     // Update data ptr for next tile decoding.
-    data = *p_data_end;
+    data += tile_payload_size;
     assert(data <= data_end);
-
-    // Copy the decoded tile to the tile list output buffer.
-    copy_decoded_tile_to_tile_list_buffer(pbi, tile_idx, tile_width_in_pixels,
-                                          tile_height_in_pixels);
     tile_idx++;
   }
+  decode_tile_list_in_waves(pbi, num_wave_tiles, data_end,
+                            tile_width_in_pixels, tile_height_in_pixels);
+  *p_data_end = data;
 
   *frame_decoding_finished = 1;
   return tile_list_payload_size;
@@ -883,6 +1111,7 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
   memset(&obu_header, 0, sizeof(obu_header));
   pbi->seen_frame_header = 0;
   pbi->next_start_tile = 0;
+  pbi->tiles_decoded_ahead = 0;
   pbi->num_tile_groups = 0;
 
   if (data_end < data) {
@@ -985,8 +1214,11 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
               pbi, &rb, data, p_data_end, obu_header.type != OBU_FRAME);
           frame_header = data;
           pbi->seen_frame_header = 1;
-          if (!pbi->ext_tile_debug && cm->tiles.large_scale)
+          if (!pbi->ext_tile_debug && cm->tiles.large_scale) {
             pbi->camera_frame_header_ready = 1;
+            // The cached tiles were decoded with the previous header.
+            av1_tile_cache_reset(&pbi->tile_cache);
+          }
         } else {
           // Verify that the frame_header_obu is identical to the original
           // frame_header_obu.
@@ -1047,13 +1279,14 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
         }
         decoded_payload_size += read_one_tile_group_obu(
             pbi, &rb, is_first_tg_obu_received, data + obu_payload_offset,
-            data + payload_size, p_data_end, &frame_decoding_finished,
-            obu_header.type == OBU_FRAME);
+            data + payload_size, data_end, p_data_end,
+            &frame_decoding_finished, obu_header.type == OBU_FRAME);
         if (pbi->error.error_code != AOM_CODEC_OK) return -1;
         is_first_tg_obu_received = 0;
         if (frame_decoding_finished) {
           pbi->seen_frame_header = 0;
           pbi->next_start_tile = 0;
+          pbi->tiles_decoded_ahead = 0;
         }
         pbi->num_tile_groups++;
         break;
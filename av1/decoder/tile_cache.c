@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/mem.h"
+#include "av1/decoder/tile_cache.h"
+
+static void free_entry(TileCache *cache, int idx) {
+  TileCacheEntry *const entry = &cache->entries[idx];
+  cache->bytes -= entry->coded_size + entry->pixels_size;
+  aom_free(entry->coded_data);
+  aom_free(entry->pixels);
+  cache->entries[idx] = cache->entries[--cache->num_entries];
+}
+
+static void evict_lru_entry(TileCache *cache) {
+  assert(cache->num_entries > 0);
+  int lru = 0;
+  for (int i = 1; i < cache->num_entries; ++i) {
+    if (cache->entries[i].last_use < cache->entries[lru].last_use) lru = i;
+  }
+  free_entry(cache, lru);
+}
+
+void av1_tile_cache_set_budget(TileCache *cache, size_t budget) {
+  cache->budget = budget;
+  while (cache->bytes > cache->budget) evict_lru_entry(cache);
+  if (cache->budget == 0) av1_tile_cache_free(cache);
+}
+
+void av1_tile_cache_reset(TileCache *cache) {
+  while (cache->num_entries > 0) free_entry(cache, cache->num_entries - 1);
+  assert(cache->bytes == 0);
+}
+
+void av1_tile_cache_free(TileCache *cache) {
+  av1_tile_cache_reset(cache);
+  aom_free(cache->entries);
+  cache->entries = NULL;
+  cache->alloc_entries = 0;
+}
+
+void av1_tile_cache_set_layout(TileCache *cache, const YV12_BUFFER_CONFIG *buf,
+                               int tile_width, int tile_height,
+                               int num_planes) {
+  const int highbd = (buf->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+  if (cache->tile_width == tile_width && cache->tile_height == tile_height &&
+      cache->num_planes == num_planes &&
+      cache->subsampling_x == buf->subsampling_x &&
+      cache->subsampling_y == buf->subsampling_y && cache->highbd == highbd)
+    return;
+  av1_tile_cache_reset(cache);
+  cache->tile_width = tile_width;
+  cache->tile_height = tile_height;
+  cache->num_planes = num_planes;
+  cache->subsampling_x = buf->subsampling_x;
+  cache->subsampling_y = buf->subsampling_y;
+  cache->highbd = highbd;
+}
+
+const TileCacheEntry *av1_tile_cache_lookup(TileCache *cache, int ref_idx,
+                                            int tile_row, int tile_col,
+                                            const uint8_t *data, size_t size) {
+  for (int i = 0; i < cache->num_entries; ++i) {
+    TileCacheEntry *const entry = &cache->entries[i];
+    if (entry->ref_idx == ref_idx && entry->tile_row == tile_row &&
+        entry->tile_col == tile_col && entry->coded_size == size &&
+        !memcmp(entry->coded_data, data, size)) {
+      entry->last_use = ++cache->clock;
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+// Returns the address of the pixel at ('x', 'y') of 'plane' of 'buf', where
+// 'x' and 'y' are in luma pixels.
+static uint8_t *tile_plane_start(const YV12_BUFFER_CONFIG *buf, int plane,
+                                 int x, int y, int highbd) {
+  const int ssx = plane > 0 ? buf->subsampling_x : 0;
+  const int ssy = plane > 0 ? buf->subsampling_y : 0;
+  const int stride = buf->strides[plane > 0];
+  uint8_t *const base = highbd ? (uint8_t *)CONVERT_TO_SHORTPTR(
+                                     buf->buffers[plane])
+                               : buf->buffers[plane];
+  return base + (((size_t)(y >> ssy) * stride + (x >> ssx)) << highbd);
+}
+
+// Copies the tile at ('x', 'y') of 'buf' to or from the packed 'pixels'.
+static void copy_tile(const TileCache *cache, YV12_BUFFER_CONFIG *buf, int x,
+                      int y, uint8_t *pixels, int to_buf) {
+  const int highbd = cache->highbd;
+  for (int plane = 0; plane < cache->num_planes; ++plane) {
+    const int ssx = plane > 0 ? cache->subsampling_x : 0;
+    const int ssy = plane > 0 ? cache->subsampling_y : 0;
+    const size_t row_bytes = (size_t)(cache->tile_width >> ssx) << highbd;
+    const size_t stride_bytes = (size_t)buf->strides[plane > 0] << highbd;
+    uint8_t *p = tile_plane_start(buf, plane, x, y, highbd);
+    for (int row = 0; row < cache->tile_height >> ssy; ++row) {
+      if (to_buf)
+        memcpy(p, pixels, row_bytes);
+      else
+        memcpy(pixels, p, row_bytes);
+      p += stride_bytes;
+      pixels += row_bytes;
+    }
+  }
+}
+
+static size_t tile_pixels_size(const TileCache *cache) {
+  size_t size = 0;
+  for (int plane = 0; plane < cache->num_planes; ++plane) {
+    const int ssx = plane > 0 ? cache->subsampling_x : 0;
+    const int ssy = plane > 0 ? cache->subsampling_y : 0;
+    size += (size_t)(cache->tile_width >> ssx) * (cache->tile_height >> ssy);
+  }
+  return size << cache->highbd;
+}
+
+void av1_tile_cache_insert(TileCache *cache, int ref_idx, int tile_row,
+                           int tile_col, const uint8_t *data, size_t size,
+                           uint32_t payload_size,
+                           const YV12_BUFFER_CONFIG *buf, int x, int y) {
+  const size_t pixels_size = tile_pixels_size(cache);
+  if (size + pixels_size > cache->budget) return;
+  while (cache->bytes + size + pixels_size > cache->budget)
+    evict_lru_entry(cache);
+
+  if (cache->num_entries == cache->alloc_entries) {
+    const int alloc_entries = AOMMAX(2 * cache->alloc_entries, 16);
+    TileCacheEntry *const entries =
+        (TileCacheEntry *)aom_malloc(alloc_entries * sizeof(*entries));
+    if (entries == NULL) return;
+    if (cache->num_entries > 0)
+      memcpy(entries, cache->entries, cache->num_entries * sizeof(*entries));
+    aom_free(cache->entries);
+    cache->entries = entries;
+    cache->alloc_entries = alloc_entries;
+  }
+
+  uint8_t *const coded_data = (uint8_t *)aom_malloc(size);
+  uint8_t *const pixels = (uint8_t *)aom_malloc(pixels_size);
+  if (coded_data == NULL || pixels == NULL) {
+    aom_free(coded_data);
+    aom_free(pixels);
+    return;
+  }
+  memcpy(coded_data, data, size);
+  copy_tile(cache, (YV12_BUFFER_CONFIG *)buf, x, y, pixels, 0);
+
+  TileCacheEntry *const entry = &cache->entries[cache->num_entries++];
+  entry->ref_idx = ref_idx;
+  entry->tile_row = tile_row;
+  entry->tile_col = tile_col;
+  entry->coded_data = coded_data;
+  entry->coded_size = size;
+  entry->payload_size = payload_size;
+  entry->pixels = pixels;
+  entry->pixels_size = pixels_size;
+  entry->last_use = ++cache->clock;
+  cache->bytes += size + pixels_size;
+}
+
+void av1_tile_cache_read(const TileCache *cache, const TileCacheEntry *entry,
+                         YV12_BUFFER_CONFIG *buf, int x, int y) {
+  assert(entry->pixels_size == tile_pixels_size(cache));
+  copy_tile(cache, buf, x, y, entry->pixels, 1);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_DECODER_TILE_CACHE_H_
+#define AOM_AV1_DECODER_TILE_CACHE_H_
+
+#include <stddef.h>
+
+#include "aom/aom_integer.h"
+#include "aom_scale/yv12config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A tile decoded from a tile list OBU in large scale tile mode. The key is
+// the anchor frame, the position of the tile in the camera frame and the
+// coded tile data, since tile lists take the tiles at one position from many
+// camera frames.
+typedef struct TileCacheEntry {
+  int ref_idx;
+  int tile_row;
+  int tile_col;
+  uint8_t *coded_data;
+  size_t coded_size;
+  // Number of bytes of the tile list that the tile took.
+  uint32_t payload_size;
+  // The planes of the tile one after the other, in the format of the tile
+  // list output buffer.
+  uint8_t *pixels;
+  size_t pixels_size;
+  uint64_t last_use;
+} TileCacheEntry;
+
+// Least recently used cache of the decoded tiles of tile lists.
+typedef struct TileCache {
+  TileCacheEntry *entries;
+  int num_entries;
+  int alloc_entries;
+  // Memory budget of the cache in bytes. 0 disables the cache.
+  size_t budget;
+  size_t bytes;
+  uint64_t clock;
+  unsigned int hits;
+  unsigned int misses;
+  // Layout of the cached tiles. The cache is emptied when it changes.
+  int tile_width;
+  int tile_height;
+  int num_planes;
+  int subsampling_x;
+  int subsampling_y;
+  int highbd;
+} TileCache;
+
+// Sets the memory budget of the cache, dropping the least recently used
+// tiles that no longer fit.
+void av1_tile_cache_set_budget(TileCache *cache, size_t budget);
+
+// Drops all the tiles of the cache. The counters are kept.
+void av1_tile_cache_reset(TileCache *cache);
+
+void av1_tile_cache_free(TileCache *cache);
+
+// Empties the cache if the tiles of the tile list in 'buf' are not laid out
+// like the cached tiles.
+void av1_tile_cache_set_layout(TileCache *cache, const YV12_BUFFER_CONFIG *buf,
+                               int tile_width, int tile_height,
+                               int num_planes);
+
+// Returns the cached tile that matches the tile list entry, or NULL.
+const TileCacheEntry *av1_tile_cache_lookup(TileCache *cache, int ref_idx,
+                                            int tile_row, int tile_col,
+                                            const uint8_t *data, size_t size);
+
+// Copies the tile at ('x', 'y') of 'buf' to the cache. The tile is not cached
+// if it does not fit in the budget or if the memory cannot be allocated.
+void av1_tile_cache_insert(TileCache *cache, int ref_idx, int tile_row,
+                           int tile_col, const uint8_t *data, size_t size,
+                           uint32_t payload_size,
+                           const YV12_BUFFER_CONFIG *buf, int x, int y);
+
+// Copies a cached tile to ('x', 'y') of 'buf'.
+void av1_tile_cache_read(const TileCache *cache, const TileCacheEntry *entry,
+                         YV12_BUFFER_CONFIG *buf, int x, int y);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_DECODER_TILE_CACHE_H_
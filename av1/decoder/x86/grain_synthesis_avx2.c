@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/x86/synonyms.h"
+#include "aom_dsp/x86/synonyms_avx2.h"
+
+// Returns the (rounded) average of each horizontal pair of luma samples, or
+// the luma samples themselves, for 8 output positions.
+static inline __m256i load_luma_8(const uint8_t *luma, int luma_subsamp_x) {
+  if (luma_subsamp_x) {
+    const __m256i l = _mm256_cvtepu8_epi16(xx_loadu_128(luma));
+    const __m256i sum = _mm256_madd_epi16(l, _mm256_set1_epi16(1));
+    return _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(1)), 1);
+  }
+  return _mm256_cvtepu8_epi32(xx_loadl_64(luma));
+}
+
+static inline __m256i blend_8(__m256i pix, __m256i avg_luma,
+                              const int *grain, const int *scaling_lut,
+                              __m256i mult, __m256i luma_mult, __m256i offset,
+                              __m256i rounding, __m128i shift,
+                              __m256i min_val, __m256i max_val) {
+  __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(avg_luma, luma_mult),
+                                   _mm256_mullo_epi32(pix, mult));
+  index = _mm256_add_epi32(_mm256_srai_epi32(index, 6), offset);
+  index = _mm256_min_epi32(_mm256_max_epi32(index, _mm256_setzero_si256()),
+                           _mm256_set1_epi32(255));
+
+  const __m256i scale = _mm256_i32gather_epi32(scaling_lut, index, 4);
+  __m256i noise = _mm256_mullo_epi32(scale, yy_loadu_256(grain));
+  noise = _mm256_sra_epi32(_mm256_add_epi32(noise, rounding), shift);
+
+  const __m256i out = _mm256_add_epi32(pix, noise);
+  return _mm256_min_epi32(_mm256_max_epi32(out, min_val), max_val);
+}
+
+void av1_add_film_grain_row_avx2(uint8_t *pix, const uint8_t *luma,
+                                 const int *grain, int width,
+                                 int luma_subsamp_x, const int *scaling_lut,
+                                 int mult, int luma_mult, int offset,
+                                 int scaling_shift, int min_val, int max_val) {
+  const __m256i mult_v = _mm256_set1_epi32(mult);
+  const __m256i luma_mult_v = _mm256_set1_epi32(luma_mult);
+  const __m256i offset_v = _mm256_set1_epi32(offset);
+  const __m256i rounding = _mm256_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m256i min_v = _mm256_set1_epi32(min_val);
+  const __m256i max_v = _mm256_set1_epi32(max_val);
+
+  int j = 0;
+  for (; j + 16 <= width; j += 16) {
+    const __m128i p = xx_loadu_128(pix + j);
+    const __m256i p_lo = _mm256_cvtepu8_epi32(p);
+    const __m256i p_hi = _mm256_cvtepu8_epi32(_mm_srli_si128(p, 8));
+    const __m256i l_lo =
+        load_luma_8(luma + (j << luma_subsamp_x), luma_subsamp_x);
+    const __m256i l_hi =
+        load_luma_8(luma + ((j + 8) << luma_subsamp_x), luma_subsamp_x);
+
+    const __m256i out_lo =
+        blend_8(p_lo, l_lo, grain + j, scaling_lut, mult_v, luma_mult_v,
+                offset_v, rounding, shift, min_v, max_v);
+    const __m256i out_hi =
+        blend_8(p_hi, l_hi, grain + j + 8, scaling_lut, mult_v, luma_mult_v,
+                offset_v, rounding, shift, min_v, max_v);
+
+    // Values are already clamped to [0, 255] so the saturating packs are
+    // exact; the permute undoes the per-lane interleave of the packs.
+    const __m256i out16 = _mm256_packs_epi32(out_lo, out_hi);
+    const __m256i out8 = _mm256_packus_epi16(out16, out16);
+    const __m256i ordered =
+        _mm256_permutevar8x32_epi32(out8, _mm256_setr_epi32(0, 4, 1, 5, 0, 0,
+                                                            0, 0));
+    xx_storeu_128(pix + j, _mm256_castsi256_si128(ordered));
+  }
+
+  if (j < width) {
+    av1_add_film_grain_row_sse4_1(pix + j, luma + (j << luma_subsamp_x),
+                                  grain + j, width - j, luma_subsamp_x,
+                                  scaling_lut, mult, luma_mult, offset,
+                                  scaling_shift, min_val, max_val);
+  }
+}
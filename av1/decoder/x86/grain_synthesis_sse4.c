@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <smmintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/x86/synonyms.h"
+
+// Returns the (rounded) average of each horizontal pair of luma samples, or
+// the luma samples themselves, for 4 output positions.
+static inline __m128i load_luma_4(const uint8_t *luma, int luma_subsamp_x) {
+  if (luma_subsamp_x) {
+    const __m128i l = _mm_cvtepu8_epi16(xx_loadl_64(luma));
+    const __m128i sum = _mm_madd_epi16(l, _mm_set1_epi16(1));
+    return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(1)), 1);
+  }
+  return _mm_cvtepu8_epi32(xx_loadl_32(luma));
+}
+
+static inline __m128i blend_4(__m128i pix, __m128i avg_luma,
+                              const int *grain, const int *scaling_lut,
+                              __m128i mult, __m128i luma_mult, __m128i offset,
+                              __m128i rounding, __m128i shift,
+                              __m128i min_val, __m128i max_val) {
+  __m128i index = _mm_add_epi32(_mm_mullo_epi32(avg_luma, luma_mult),
+                                _mm_mullo_epi32(pix, mult));
+  index = _mm_add_epi32(_mm_srai_epi32(index, 6), offset);
+  index = _mm_min_epi32(_mm_max_epi32(index, _mm_setzero_si128()),
+                        _mm_set1_epi32(255));
+
+  const __m128i scale = _mm_setr_epi32(
+      scaling_lut[_mm_extract_epi32(index, 0)],
+      scaling_lut[_mm_extract_epi32(index, 1)],
+      scaling_lut[_mm_extract_epi32(index, 2)],
+      scaling_lut[_mm_extract_epi32(index, 3)]);
+  __m128i noise =
+      _mm_mullo_epi32(scale, xx_loadu_128(grain));
+  noise = _mm_sra_epi32(_mm_add_epi32(noise, rounding), shift);
+
+  const __m128i out = _mm_add_epi32(pix, noise);
+  return _mm_min_epi32(_mm_max_epi32(out, min_val), max_val);
+}
+
+void av1_add_film_grain_row_sse4_1(uint8_t *pix, const uint8_t *luma,
+                                   const int *grain, int width,
+                                   int luma_subsamp_x, const int *scaling_lut,
+                                   int mult, int luma_mult, int offset,
+                                   int scaling_shift, int min_val,
+                                   int max_val) {
+  const __m128i mult_v = _mm_set1_epi32(mult);
+  const __m128i luma_mult_v = _mm_set1_epi32(luma_mult);
+  const __m128i offset_v = _mm_set1_epi32(offset);
+  const __m128i rounding = _mm_set1_epi32(1 << (scaling_shift - 1));
+  const __m128i shift = _mm_cvtsi32_si128(scaling_shift);
+  const __m128i min_v = _mm_set1_epi32(min_val);
+  const __m128i max_v = _mm_set1_epi32(max_val);
+
+  int j = 0;
+  for (; j + 8 <= width; j += 8) {
+    const __m128i p = xx_loadl_64(pix + j);
+    const __m128i p_lo = _mm_cvtepu8_epi32(p);
+    const __m128i p_hi = _mm_cvtepu8_epi32(_mm_srli_si128(p, 4));
+    const __m128i l_lo = load_luma_4(luma + (j << luma_subsamp_x),
+                                     luma_subsamp_x);
+    const __m128i l_hi = load_luma_4(luma + ((j + 4) << luma_subsamp_x),
+                                     luma_subsamp_x);
+
+    const __m128i out_lo =
+        blend_4(p_lo, l_lo, grain + j, scaling_lut, mult_v, luma_mult_v,
+                offset_v, rounding, shift, min_v, max_v);
+    const __m128i out_hi =
+        blend_4(p_hi, l_hi, grain + j + 4, scaling_lut, mult_v, luma_mult_v,
+                offset_v, rounding, shift, min_v, max_v);
+
+    const __m128i out16 = _mm_packs_epi32(out_lo, out_hi);
+    xx_storel_64(pix + j, _mm_packus_epi16(out16, out16));
+  }
+
+  if (j < width) {
+    av1_add_film_grain_row_c(pix + j, luma + (j << luma_subsamp_x), grain + j,
+                             width - j, luma_subsamp_x, scaling_lut, mult,
+                             luma_mult, offset, scaling_shift, min_val,
+                             max_val);
+  }
+}
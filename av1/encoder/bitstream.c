@@ -43,6 +43,7 @@
 #include "av1/encoder/bitstream.h"
 #include "av1/encoder/cost.h"
 #include "av1/encoder/encodemv.h"
+#include "av1/encoder/encoder_utils.h"
 #include "av1/encoder/encodetxb.h"
 #include "av1/encoder/ethread.h"
 #include "av1/encoder/mcomp.h"
@@ -3857,14 +3858,30 @@ void av1_pack_tile_info(AV1_COMP *const cpi, ThreadData *const td,
   // The last tile of the tile group does not have a header.
   if (!pack_bs_params->is_last_tile_in_tg) *total_size += 4;
 
-  // Pack tile data
-  aom_start_encode(&mode_bc, pack_bs_params->dst + *total_size);
-  write_modes(cpi, td, &tile_info, &mode_bc, tile_row, tile_col);
-  if (aom_stop_encode(&mode_bc) < 0) {
-    aom_internal_error(td->mb.e_mbd.error_info, AOM_CODEC_ERROR,
-                       "Error writing modes");
+  const AV1EncTilePrepack *const tile_prepack = &cpi->mt_info.tile_prepack;
+  if (tile_prepack->valid) {
+    // The tile has already been packed, copy its payload and statistics.
+    const TilePrepackInfo *const prepack_info =
+        &tile_prepack->tile_info[tile_row * cm->tiles.cols + tile_col];
+    memcpy(pack_bs_params->dst + *total_size,
+           tile_prepack->buf + prepack_info->offset, prepack_info->size);
+    tile_size = prepack_info->size;
+    td->coefficient_size += prepack_info->coefficient_size;
+    td->max_mv_magnitude =
+        AOMMAX(td->max_mv_magnitude, prepack_info->max_mv_magnitude);
+    for (InterpFilter filter = EIGHTTAP_REGULAR; filter < SWITCHABLE; filter++)
+      td->interp_filter_selected[filter] +=
+          prepack_info->interp_filter_selected[filter];
+  } else {
+    // Pack tile data
+    aom_start_encode(&mode_bc, pack_bs_params->dst + *total_size);
+    write_modes(cpi, td, &tile_info, &mode_bc, tile_row, tile_col);
+    if (aom_stop_encode(&mode_bc) < 0) {
+      aom_internal_error(td->mb.e_mbd.error_info, AOM_CODEC_ERROR,
+                         "Error writing modes");
+    }
+    tile_size = mode_bc.pos;
   }
-  tile_size = mode_bc.pos;
   assert(tile_size >= AV1_MIN_TILE_SIZE_BYTES);
 
   pack_bs_params->buf.size = tile_size;
@@ -3928,6 +3945,102 @@ void av1_write_last_tile_info(
   *is_first_tg = 0;
 }
 
+// Selects the segment map coding strategy (temporal or spatial).
+static inline void select_seg_coding_strategy(AV1_COMP *const cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  if (cm->seg.enabled && cm->seg.update_map) {
+    if (cm->features.primary_ref_frame == PRIMARY_REF_NONE) {
+      cm->seg.temporal_update = 0;
+    } else {
+      cm->seg.temporal_update = 1;
+      if (cpi->td.rd_counts.seg_tmp_pred_cost[0] <
+          cpi->td.rd_counts.seg_tmp_pred_cost[1])
+        cm->seg.temporal_update = 0;
+    }
+  }
+}
+
+bool av1_use_tile_prepack(const AV1_COMP *const cpi) {
+#if CONFIG_BITSTREAM_DEBUG || CONFIG_ENTROPY_STATS
+  (void)cpi;
+  return false;
+#else
+  const AV1_COMMON *const cm = &cpi->common;
+  // The last worker packs the tiles, so at least one other worker must be
+  // left for the post-processing filters. The frame header is written ahead
+  // of the segmentation coding strategy selection when there are several
+  // tile groups, so only a single tile group is supported.
+  return cpi->mt_info.num_workers > 1 && cpi->num_tg == 1 &&
+         !cm->tiles.large_scale && !cm->features.allow_intrabc &&
+         cpi->available_bs_size > 0;
+#endif
+}
+
+void av1_setup_tile_prepack(AV1_COMP *const cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  AV1EncTilePrepack *const tile_prepack = &cpi->mt_info.tile_prepack;
+  const int num_tiles = cm->tiles.rows * cm->tiles.cols;
+
+  // Apply the frame level decisions that av1_pack_bitstream() and
+  // av1_finalize_encoded_frame() would make later on. All of them are
+  // idempotent.
+  if (cm->delta_q_info.delta_q_present_flag && cpi->deltaq_used == 0)
+    cm->delta_q_info.delta_q_present_flag = 0;
+  select_seg_coding_strategy(cpi);
+  if (!frame_is_intra_only(cm))
+    av1_fix_interp_filter(&cm->features.interp_filter, cpi->td.counts);
+
+  for (int tile_idx = 0; tile_idx < num_tiles; tile_idx++)
+    cpi->tile_data[tile_idx].tctx = *cm->fc;
+
+  if (tile_prepack->buf_size < cpi->available_bs_size) {
+    aom_free(tile_prepack->buf);
+    tile_prepack->buf_size = 0;
+    CHECK_MEM_ERROR(cm, tile_prepack->buf,
+                    aom_malloc(cpi->available_bs_size));
+    tile_prepack->buf_size = cpi->available_bs_size;
+  }
+  tile_prepack->valid = false;
+}
+
+void av1_prepack_tiles(AV1_COMP *const cpi, ThreadData *const td) {
+  AV1_COMMON *const cm = &cpi->common;
+  AV1EncTilePrepack *const tile_prepack = &cpi->mt_info.tile_prepack;
+  MACROBLOCKD *const xd = &td->mb.e_mbd;
+  const int num_planes = av1_num_planes(cm);
+  size_t offset = 0;
+
+  for (int tile_row = 0; tile_row < cm->tiles.rows; tile_row++) {
+    for (int tile_col = 0; tile_col < cm->tiles.cols; tile_col++) {
+      const int tile_idx = tile_row * cm->tiles.cols + tile_col;
+      TilePrepackInfo *const prepack_info = &tile_prepack->tile_info[tile_idx];
+      TileInfo tile_info;
+      aom_writer mode_bc;
+      av1_tile_set_col(&tile_info, cm, tile_col);
+      av1_tile_set_row(&tile_info, cm, tile_row);
+      mode_bc.allow_update_cdf = !cm->features.disable_cdf_update;
+      xd->tile_ctx = &cpi->tile_data[tile_idx].tctx;
+      av1_reset_loop_restoration(xd, num_planes);
+      av1_reset_pack_bs_thread_data(td);
+
+      aom_start_encode(&mode_bc, tile_prepack->buf + offset);
+      write_modes(cpi, td, &tile_info, &mode_bc, tile_row, tile_col);
+      if (aom_stop_encode(&mode_bc) < 0) {
+        aom_internal_error(xd->error_info, AOM_CODEC_ERROR,
+                           "Error writing modes");
+      }
+
+      prepack_info->offset = offset;
+      prepack_info->size = mode_bc.pos;
+      prepack_info->coefficient_size = td->coefficient_size;
+      prepack_info->max_mv_magnitude = td->max_mv_magnitude;
+      memcpy(prepack_info->interp_filter_selected, td->interp_filter_selected,
+             sizeof(prepack_info->interp_filter_selected));
+      offset += mode_bc.pos;
+    }
+  }
+}
+
 void av1_reset_pack_bs_thread_data(ThreadData *const td) {
   td->coefficient_size = 0;
   td->max_mv_magnitude = 0;
@@ -4139,9 +4252,14 @@ static inline uint32_t pack_tiles_in_tg_obus(
   const int tile_rows = tiles->rows;
   const int num_tiles = tile_rows * tile_cols;
 
-  const int num_workers = calc_pack_bs_mt_workers(
-      cpi->tile_data, num_tiles, cpi->mt_info.num_mod_workers[MOD_PACK_BS],
-      cpi->mt_info.pack_bs_mt_enabled);
+  AV1EncTilePrepack *const tile_prepack = &cpi->mt_info.tile_prepack;
+  // Prepacked tiles are only copied, which is not worth multi-threading.
+  const int num_workers =
+      tile_prepack->valid
+          ? 1
+          : calc_pack_bs_mt_workers(cpi->tile_data, num_tiles,
+                                    cpi->mt_info.num_mod_workers[MOD_PACK_BS],
+                                    cpi->mt_info.pack_bs_mt_enabled);
 
   if (num_workers > 1) {
     av1_write_tile_obu_mt(cpi, dst, &total_size, saved_wb, obu_extension_header,
@@ -4152,6 +4270,7 @@ static inline uint32_t pack_tiles_in_tg_obus(
                    fh_info, largest_tile_id, &max_tile_size, &obu_header_size,
                    &tile_data_start);
   }
+  tile_prepack->valid = false;
 
   if (num_tiles > 1)
     write_tile_obu_size(cpi, dst, saved_wb, *largest_tile_id, &total_size,
@@ -4171,17 +4290,7 @@ static uint32_t write_tiles_in_tg_obus(AV1_COMP *const cpi, uint8_t *const dst,
   const CommonTileParams *const tiles = &cm->tiles;
   *largest_tile_id = 0;
 
-  // Select the coding strategy (temporal or spatial)
-  if (cm->seg.enabled && cm->seg.update_map) {
-    if (cm->features.primary_ref_frame == PRIMARY_REF_NONE) {
-      cm->seg.temporal_update = 0;
-    } else {
-      cm->seg.temporal_update = 1;
-      if (cpi->td.rd_counts.seg_tmp_pred_cost[0] <
-          cpi->td.rd_counts.seg_tmp_pred_cost[1])
-        cm->seg.temporal_update = 0;
-    }
-  }
+  select_seg_coding_strategy(cpi);
 
   if (tiles->large_scale)
     return pack_large_scale_tiles_in_tg_obus(
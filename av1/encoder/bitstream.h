@@ -84,6 +84,32 @@ typedef struct {
   bool pack_bs_mt_exit;
 } AV1EncPackBSSync;
 
+// Tile payload produced ahead of av1_pack_bitstream() along with the pack
+// statistics gathered while writing it.
+typedef struct {
+  size_t offset;  // Offset of the tile payload in the prepack buffer
+  uint32_t size;  // Size of the tile payload in bytes
+  int coefficient_size;
+  int max_mv_magnitude;
+  int interp_filter_selected[SWITCHABLE];
+} TilePrepackInfo;
+
+// Tile payloads packed by a worker thread once the syntax of all tiles is
+// final, overlapping entropy coding with the application of the CDEF and loop
+// restoration filters.
+typedef struct {
+  // Buffer holding the payloads of all tiles, back to back.
+  uint8_t *buf;
+  // Allocated size of buf in bytes.
+  size_t buf_size;
+  // Per-tile payload location and pack statistics.
+  TilePrepackInfo tile_info[MAX_TILES];
+  // Set while the prepack worker is running.
+  bool in_progress;
+  // Set once the payloads in buf may be used by av1_pack_tile_info().
+  bool valid;
+} AV1EncTilePrepack;
+
 /*!\endcond */
 
 // Writes only the OBU Sequence Header payload, and returns the size of the
@@ -136,6 +162,18 @@ void av1_reset_pack_bs_thread_data(struct ThreadData *const td);
 void av1_accumulate_pack_bs_thread_data(struct AV1_COMP *const cpi,
                                         struct ThreadData const *td);
 
+// Returns true if the tile payloads of the current frame may be packed before
+// av1_pack_bitstream() is called.
+bool av1_use_tile_prepack(const struct AV1_COMP *const cpi);
+
+// Finalizes the frame level state that the tile syntax depends on and
+// prepares the prepack buffer. Must be called from the main thread before
+// av1_prepack_tiles().
+void av1_setup_tile_prepack(struct AV1_COMP *const cpi);
+
+// Packs the payloads of all tiles into the prepack buffer.
+void av1_prepack_tiles(struct AV1_COMP *const cpi, struct ThreadData *const td);
+
 void av1_write_obu_tg_tile_headers(struct AV1_COMP *const cpi,
                                    MACROBLOCKD *const xd,
                                    PackBSParams *const pack_bs_params,
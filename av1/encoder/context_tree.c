@@ -64,13 +64,124 @@ void av1_free_shared_coeff_buffer(PC_TREE_SHARED_BUFFERS *shared_bufs) {
   }
 }
 
+// Size of the chunks the arena carves nodes and contexts out of.
+#define PC_TREE_ARENA_CHUNK_SIZE (256 * 1024)
+
+static void *arena_alloc(PC_TREE_ARENA *arena, size_t size) {
+  size = ALIGN_POWER_OF_TWO(size, 5);
+  PC_TREE_ARENA_CHUNK *chunk = arena->cur;
+  while (chunk != NULL && chunk->used + size > chunk->size) chunk = chunk->next;
+  if (chunk == NULL) {
+    chunk = aom_calloc(1, sizeof(*chunk));
+    if (chunk == NULL) return NULL;
+    chunk->size = AOMMAX(size, PC_TREE_ARENA_CHUNK_SIZE);
+    chunk->data = aom_memalign(32, chunk->size);
+    if (chunk->data == NULL) {
+      aom_free(chunk);
+      return NULL;
+    }
+    // Keep the chunks in allocation order, so that rewinding the arena reuses
+    // them all.
+    PC_TREE_ARENA_CHUNK **tail = &arena->chunks;
+    while (*tail != NULL) tail = &(*tail)->next;
+    *tail = chunk;
+  }
+  arena->cur = chunk;
+  void *const mem = chunk->data + chunk->used;
+  chunk->used += size;
+  return mem;
+}
+
+void av1_pc_tree_arena_reset(PC_TREE_ARENA *arena) {
+  if (arena->num_live != 0) return;
+  for (PC_TREE_ARENA_CHUNK *chunk = arena->chunks; chunk != NULL;
+       chunk = chunk->next) {
+    chunk->used = 0;
+  }
+  arena->cur = arena->chunks;
+  arena->free_nodes = NULL;
+  av1_zero(arena->free_ctxs);
+}
+
+void av1_pc_tree_arena_free(PC_TREE_ARENA *arena) {
+  PC_TREE_ARENA_CHUNK *chunk = arena->chunks;
+  while (chunk != NULL) {
+    PC_TREE_ARENA_CHUNK *const next = chunk->next;
+    aom_free(chunk->data);
+    aom_free(chunk);
+    chunk = next;
+  }
+  memset(arena, 0, sizeof(*arena));
+}
+
+// Lays out a context of block size 'bsize' and all its buffers in one block of
+// arena memory. The layout only depends on the number of pixels, so a freed
+// context is reused by the next allocation of any block size of that area.
+static PICK_MODE_CONTEXT *alloc_pmc_from_arena(const AV1_COMMON *const cm,
+                                               BLOCK_SIZE bsize,
+                                               PC_TREE_ARENA *arena) {
+  const int pels_log2 = num_pels_log2_lookup[bsize];
+  const int num_pix = 1 << pels_log2;
+  const int num_blk = num_pix / 16;
+  const size_t ctx_size = ALIGN_POWER_OF_TWO(sizeof(PICK_MODE_CONTEXT), 5);
+  const size_t blk_size = ALIGN_POWER_OF_TWO(2 * num_blk, 5);
+  const size_t eobs_size = ALIGN_POWER_OF_TWO(num_blk * sizeof(uint16_t), 5);
+  const size_t txb_size = ALIGN_POWER_OF_TWO(num_blk, 5);
+  const size_t color_size = num_pix <= MAX_PALETTE_SQUARE ? num_pix : 0;
+
+  PICK_MODE_CONTEXT *ctx = arena->free_ctxs[pels_log2];
+  if (ctx != NULL) {
+    arena->free_ctxs[pels_log2] = ctx->next_free;
+  } else {
+    ctx = arena_alloc(arena, ctx_size + blk_size +
+                                 MAX_MB_PLANE * (eobs_size + txb_size) +
+                                 2 * color_size);
+    if (ctx == NULL) return NULL;
+  }
+  // Like the heap allocation, clear the context and the block skip and
+  // transform type maps but not the other buffers.
+  memset(ctx, 0, ctx_size + blk_size);
+
+  uint8_t *buf = (uint8_t *)ctx + ctx_size;
+  ctx->blk_skip = buf;
+  ctx->tx_type_map = buf + num_blk;
+  buf += blk_size;
+  for (int i = 0; i < av1_num_planes(cm); ++i) {
+    ctx->eobs[i] = (uint16_t *)(buf + i * eobs_size);
+    ctx->txb_entropy_ctx[i] = buf + MAX_MB_PLANE * eobs_size + i * txb_size;
+  }
+  buf += MAX_MB_PLANE * (eobs_size + txb_size);
+  if (color_size && cm->features.allow_screen_content_tools) {
+    ctx->color_index_map[0] = buf;
+    ctx->color_index_map[1] = buf + color_size;
+  }
+  ctx->num_4x4_blk = num_blk;
+  ctx->arena = arena;
+  ctx->arena_pels_log2 = pels_log2;
+  ++arena->num_live;
+  return ctx;
+}
+
 PICK_MODE_CONTEXT *av1_alloc_pmc(const struct AV1_COMP *const cpi,
                                  BLOCK_SIZE bsize,
-                                 PC_TREE_SHARED_BUFFERS *shared_bufs) {
+                                 PC_TREE_SHARED_BUFFERS *shared_bufs,
+                                 PC_TREE_ARENA *arena) {
   PICK_MODE_CONTEXT *volatile ctx = NULL;
   const AV1_COMMON *const cm = &cpi->common;
   struct aom_internal_error_info error;
 
+  if (arena != NULL) {
+    ctx = alloc_pmc_from_arena(cm, bsize, arena);
+    if (ctx == NULL) return NULL;
+    for (int i = 0; i < av1_num_planes(cm); ++i) {
+      ctx->coeff[i] = shared_bufs->coeff_buf[i];
+      ctx->qcoeff[i] = shared_bufs->qcoeff_buf[i];
+      ctx->dqcoeff[i] = shared_bufs->dqcoeff_buf[i];
+    }
+    av1_invalid_rd_stats(&ctx->rd_stats);
+    return ctx;
+  }
+
   if (setjmp(error.jmp)) {
     av1_free_pmc(ctx, av1_num_planes(cm));
     return NULL;
@@ -127,6 +238,14 @@ void av1_reset_pmc(PICK_MODE_CONTEXT *ctx) {
 void av1_free_pmc(PICK_MODE_CONTEXT *ctx, int num_planes) {
   if (ctx == NULL) return;
 
+  if (ctx->arena != NULL) {
+    PC_TREE_ARENA *const arena = ctx->arena;
+    ctx->next_free = arena->free_ctxs[ctx->arena_pels_log2];
+    arena->free_ctxs[ctx->arena_pels_log2] = ctx;
+    --arena->num_live;
+    return;
+  }
+
   aom_free(ctx->blk_skip);
   ctx->blk_skip = NULL;
   aom_free(ctx->tx_type_map);
@@ -150,9 +269,23 @@ void av1_free_pmc(PICK_MODE_CONTEXT *ctx, int num_planes) {
   aom_free(ctx);
 }
 
-PC_TREE *av1_alloc_pc_tree_node(BLOCK_SIZE bsize) {
-  PC_TREE *pc_tree = aom_calloc(1, sizeof(*pc_tree));
-  if (pc_tree == NULL) return NULL;
+PC_TREE *av1_alloc_pc_tree_node(BLOCK_SIZE bsize, PC_TREE_ARENA *arena) {
+  PC_TREE *pc_tree;
+  if (arena != NULL) {
+    pc_tree = arena->free_nodes;
+    if (pc_tree != NULL) {
+      arena->free_nodes = pc_tree->next_free;
+    } else {
+      pc_tree = arena_alloc(arena, sizeof(*pc_tree));
+      if (pc_tree == NULL) return NULL;
+    }
+    memset(pc_tree, 0, sizeof(*pc_tree));
+    pc_tree->arena = arena;
+    ++arena->num_live;
+  } else {
+    pc_tree = aom_calloc(1, sizeof(*pc_tree));
+    if (pc_tree == NULL) return NULL;
+  }
 
   pc_tree->partitioning = PARTITION_NONE;
   pc_tree->block_size = bsize;
@@ -160,6 +293,17 @@ PC_TREE *av1_alloc_pc_tree_node(BLOCK_SIZE bsize) {
   return pc_tree;
 }
 
+static void free_pc_tree_node(PC_TREE *pc_tree) {
+  PC_TREE_ARENA *const arena = pc_tree->arena;
+  if (arena == NULL) {
+    aom_free(pc_tree);
+    return;
+  }
+  pc_tree->next_free = arena->free_nodes;
+  arena->free_nodes = pc_tree;
+  --arena->num_live;
+}
+
 #define FREE_PMC_NODE(CTX)         \
   do {                             \
     av1_free_pmc(CTX, num_planes); \
@@ -202,7 +346,7 @@ void av1_free_pc_tree_recursive(PC_TREE *pc_tree, int num_planes, int keep_best,
         pc_tree->split[i] = NULL;
       }
     }
-    aom_free(pc_tree);
+    free_pc_tree_node(pc_tree);
     return;
   }
 
@@ -245,7 +389,7 @@ void av1_free_pc_tree_recursive(PC_TREE *pc_tree, int num_planes, int keep_best,
     }
   }
 
-  if (!keep_best && !keep_none) aom_free(pc_tree);
+  if (!keep_best && !keep_none) free_pc_tree_node(pc_tree);
 }
 
 int av1_setup_sms_tree(AV1_COMP *const cpi, ThreadData *td) {
@@ -26,6 +26,7 @@ struct AV1_PRIMARY;
 struct AV1_COMP;
 struct AV1Common;
 struct ThreadData;
+struct PC_TREE_ARENA;
 
 typedef struct {
   tran_low_t *coeff_buf[MAX_MB_PLANE];
@@ -68,6 +69,12 @@ typedef struct PICK_MODE_CONTEXT {
   MV_REFERENCE_FRAME best_zeromv_reference_frame;
   int sb_skip_denoising;
 #endif
+  // Arena the context was allocated from, NULL if it is on the heap.
+  struct PC_TREE_ARENA *arena;
+  // log2 of the number of pixels of the blocks an arena context can hold.
+  int arena_pels_log2;
+  // Next context of the same size in the free list of the arena.
+  struct PICK_MODE_CONTEXT *next_free;
 } PICK_MODE_CONTEXT;
 
 typedef struct PC_TREE {
@@ -86,8 +93,35 @@ typedef struct PC_TREE {
 #endif
   struct PC_TREE *split[4];
   int index;
+  // Arena the node was allocated from, NULL if it is on the heap.
+  struct PC_TREE_ARENA *arena;
+  // Next node in the free list of the arena.
+  struct PC_TREE *next_free;
 } PC_TREE;
 
+typedef struct PC_TREE_ARENA_CHUNK {
+  struct PC_TREE_ARENA_CHUNK *next;
+  uint8_t *data;
+  size_t size;
+  size_t used;
+} PC_TREE_ARENA_CHUNK;
+
+// Per-thread allocator of the PC_TREE nodes and PICK_MODE_CONTEXTs created
+// during the partition search. Memory is carved out of large chunks, freed
+// nodes and contexts are kept in free lists for reuse, and the chunks are
+// rewound once per superblock, so the search does not go through the heap
+// allocator for each candidate partition.
+typedef struct PC_TREE_ARENA {
+  PC_TREE_ARENA_CHUNK *chunks;
+  // Chunk the next allocation is carved from.
+  PC_TREE_ARENA_CHUNK *cur;
+  PC_TREE *free_nodes;
+  // Free contexts indexed by the log2 of their number of pixels.
+  PICK_MODE_CONTEXT *free_ctxs[2 * MAX_SB_SIZE_LOG2 + 1];
+  // Number of nodes and contexts allocated and not freed yet.
+  int num_live;
+} PC_TREE_ARENA;
+
 typedef struct SIMPLE_MOTION_DATA_TREE {
   BLOCK_SIZE block_size;
   PARTITION_TYPE partitioning;
@@ -106,14 +140,22 @@ void av1_setup_shared_coeff_buffer(const SequenceHeader *const seq_params,
                                    struct aom_internal_error_info *error);
 void av1_free_shared_coeff_buffer(PC_TREE_SHARED_BUFFERS *shared_bufs);
 
-PC_TREE *av1_alloc_pc_tree_node(BLOCK_SIZE bsize);
+// Rewinds the arena if none of its nodes and contexts is in use, which is the
+// case between two superblocks unless the tree is kept across superblocks.
+void av1_pc_tree_arena_reset(PC_TREE_ARENA *arena);
+void av1_pc_tree_arena_free(PC_TREE_ARENA *arena);
+
+// Allocates the node from 'arena', or from the heap if 'arena' is NULL.
+PC_TREE *av1_alloc_pc_tree_node(BLOCK_SIZE bsize, PC_TREE_ARENA *arena);
 void av1_free_pc_tree_recursive(PC_TREE *tree, int num_planes, int keep_best,
                                 int keep_none,
                                 PARTITION_SEARCH_TYPE partition_search_type);
 
+// Allocates the context from 'arena', or from the heap if 'arena' is NULL.
 PICK_MODE_CONTEXT *av1_alloc_pmc(const struct AV1_COMP *const cpi,
                                  BLOCK_SIZE bsize,
-                                 PC_TREE_SHARED_BUFFERS *shared_bufs);
+                                 PC_TREE_SHARED_BUFFERS *shared_bufs,
+                                 PC_TREE_ARENA *arena);
 void av1_reset_pmc(PICK_MODE_CONTEXT *ctx);
 void av1_free_pmc(PICK_MODE_CONTEXT *ctx, int num_planes);
 void av1_copy_tree_context(PICK_MODE_CONTEXT *dst_ctx,
@@ -748,7 +748,7 @@ static int sb_qp_sweep(AV1_COMP *const cpi, ThreadData *td,
     av1_restore_sb_state(sb_org_stats, cpi, td, tile_data, mi_row, mi_col);
     cm->mi_params.mi_alloc[alloc_mi_idx].current_qindex = backup_current_qindex;
 
-    td->pc_root = av1_alloc_pc_tree_node(bsize);
+    td->pc_root = av1_alloc_pc_tree_node(bsize, &td->pc_arena);
     if (!td->pc_root)
       aom_internal_error(x->e_mbd.error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -808,7 +808,7 @@ static inline void encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
 #if CONFIG_COLLECT_COMPONENT_TIMING
     start_timing(cpi, rd_use_partition_time);
 #endif
-    td->pc_root = av1_alloc_pc_tree_node(sb_size);
+    td->pc_root = av1_alloc_pc_tree_node(sb_size, &td->pc_arena);
     if (!td->pc_root)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -828,7 +828,7 @@ static inline void encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
     const BLOCK_SIZE bsize =
         seg_skip ? sb_size : sf->part_sf.fixed_partition_size;
     av1_set_fixed_partitioning(cpi, tile_info, mi, mi_row, mi_col, bsize);
-    td->pc_root = av1_alloc_pc_tree_node(sb_size);
+    td->pc_root = av1_alloc_pc_tree_node(sb_size, &td->pc_arena);
     if (!td->pc_root)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -901,7 +901,7 @@ static inline void encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
         av1_rd_partition_search(cpi, td, tile_data, tp, sms_root, mi_row,
                                 mi_col, sb_size, &this_rdc);
       } else {
-        td->pc_root = av1_alloc_pc_tree_node(sb_size);
+        td->pc_root = av1_alloc_pc_tree_node(sb_size, &td->pc_arena);
         if (!td->pc_root)
           aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PC_TREE");
@@ -910,7 +910,7 @@ static inline void encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
                               NULL, SB_SINGLE_PASS, NULL);
       }
 #else
-      td->pc_root = av1_alloc_pc_tree_node(sb_size);
+      td->pc_root = av1_alloc_pc_tree_node(sb_size, &td->pc_arena);
       if (!td->pc_root)
         aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate PC_TREE");
@@ -925,7 +925,7 @@ static inline void encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
           (SB_FIRST_PASS_STATS *)aom_malloc(sizeof(*td->mb.sb_fp_stats)));
       av1_backup_sb_state(td->mb.sb_fp_stats, cpi, td, tile_data, mi_row,
                           mi_col);
-      td->pc_root = av1_alloc_pc_tree_node(sb_size);
+      td->pc_root = av1_alloc_pc_tree_node(sb_size, &td->pc_arena);
       if (!td->pc_root)
         aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate PC_TREE");
@@ -942,7 +942,7 @@ static inline void encode_rd_sb(AV1_COMP *cpi, ThreadData *td,
       av1_restore_sb_state(td->mb.sb_fp_stats, cpi, td, tile_data, mi_row,
                            mi_col);
 
-      td->pc_root = av1_alloc_pc_tree_node(sb_size);
+      td->pc_root = av1_alloc_pc_tree_node(sb_size, &td->pc_arena);
       if (!td->pc_root)
         aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate PC_TREE");
@@ -1257,6 +1257,10 @@ static inline void encode_sb_row(AV1_COMP *cpi, ThreadData *td,
     // fast mode search strategy for coding blocks
     if (!seg_skip) grade_source_content_sb(cpi, x, tile_data, mi_row, mi_col);
 
+    // The search tree of the previous superblock is freed by now, unless it
+    // is kept for the whole tile, so its memory can be handed out again.
+    av1_pc_tree_arena_reset(&td->pc_arena);
+
     // encode the superblock
     if (use_nonrd_mode) {
       encode_nonrd_sb(cpi, td, tile_data, tp, mi_row, mi_col, seg_skip);
@@ -2091,7 +2095,8 @@ static inline void encode_frame_internal(AV1_COMP *cpi) {
       // memory allocation.
       const int use_nonrd_mode = cpi->sf.rt_sf.use_nonrd_pick_mode;
       if (use_nonrd_mode) {
-        td->pc_root = av1_alloc_pc_tree_node(cm->seq_params->sb_size);
+        td->pc_root =
+            av1_alloc_pc_tree_node(cm->seq_params->sb_size, &td->pc_arena);
         if (!td->pc_root)
           aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PC_TREE");
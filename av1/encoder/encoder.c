@@ -1724,6 +1724,8 @@ void av1_remove_compressor(AV1_COMP *cpi) {
   }
 #endif
   av1_row_mt_mem_dealloc(cpi);
+  av1_tile_prepack_dealloc(&mt_info->tile_prepack);
+  aom_scheduler_dealloc(&mt_info->scheduler);
 
   if (mt_info->num_workers > 1) {
     av1_row_mt_sync_mem_dealloc(&cpi->ppi->intra_row_mt_sync);
@@ -1731,6 +1733,7 @@ void av1_remove_compressor(AV1_COMP *cpi) {
     av1_cdef_mt_dealloc(&mt_info->cdef_sync);
 #if !CONFIG_REALTIME_ONLY
     av1_loop_restoration_dealloc(&mt_info->lr_row_sync);
+    av1_lr_search_mt_dealloc(&mt_info->lr_search_sync);
     av1_tf_mt_dealloc(&mt_info->tf_sync);
 #endif
   }
@@ -2285,6 +2288,15 @@ static inline int extend_borders_mt(const AV1_COMP *cpi,
  *
  * \ingroup high_level_algo
  */
+// Returns the number of workers the post-processing filters may use while the
+// last worker may be busy packing tiles.
+static inline int get_num_postproc_workers(const AV1_COMP *cpi,
+                                           int num_workers) {
+  const MultiThreadInfo *const mt_info = &cpi->mt_info;
+  if (!mt_info->tile_prepack.in_progress) return num_workers;
+  return AOMMIN(num_workers, mt_info->num_workers - 1);
+}
+
 static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
                                    MACROBLOCKD *xd, int use_restoration,
                                    int use_cdef,
@@ -2296,35 +2308,47 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
   (void)use_restoration;
 #endif
 
+  // The tile syntax is final once the CDEF strengths and the loop restoration
+  // coefficients have been chosen. From then on, the tiles are packed on a
+  // worker thread while the remaining workers apply the filters.
+  const int use_superres = av1_superres_scaled(cm);
+  const int use_tile_prepack = av1_use_tile_prepack(cpi);
+
   if (use_cdef) {
 #if CONFIG_COLLECT_COMPONENT_TIMING
     start_timing(cpi, cdef_time);
 #endif
     const int num_workers = cpi->mt_info.num_mod_workers[MOD_CDEF];
     // Find CDEF parameters
+    start_stage_timing(cpi, kStageCdefPick);
     av1_cdef_search(cpi);
+    end_stage_timing(cpi, kStageCdefPick);
+    if (use_tile_prepack && !use_restoration && !use_superres)
+      av1_tile_prepack_launch(cpi);
 
     // Apply the filter
     if ((skip_apply_postproc_filters & SKIP_APPLY_CDEF) == 0) {
       assert(!cpi->ppi->rtc_ref.non_reference_frame);
+      start_stage_timing(cpi, kStageCdefApply);
       if (num_workers > 1) {
         // Extension of frame borders is multi-threaded along with cdef.
         const int do_extend_border =
             extend_borders_mt(cpi, MOD_CDEF, /* plane */ 0);
+        av1_enc_scheduler_stop(&cpi->mt_info);
         av1_cdef_frame_mt(cm, xd, cpi->mt_info.cdef_worker,
                           cpi->mt_info.workers, &cpi->mt_info.cdef_sync,
-                          num_workers, av1_cdef_init_fb_row_mt,
-                          do_extend_border);
+                          get_num_postproc_workers(cpi, num_workers),
+                          av1_cdef_init_fb_row_mt, do_extend_border);
       } else {
         av1_cdef_frame(&cm->cur_frame->buf, cm, xd, av1_cdef_init_fb_row);
       }
+      end_stage_timing(cpi, kStageCdefApply);
     }
 #if CONFIG_COLLECT_COMPONENT_TIMING
     end_timing(cpi, cdef_time);
 #endif
   }
 
-  const int use_superres = av1_superres_scaled(cm);
   if (use_superres) {
     if ((skip_apply_postproc_filters & SKIP_APPLY_SUPERRES) == 0) {
       av1_superres_post_encode(cpi);
@@ -2338,29 +2362,38 @@ static void cdef_restoration_frame(AV1_COMP *cpi, AV1_COMMON *cm,
   if (use_restoration) {
     MultiThreadInfo *const mt_info = &cpi->mt_info;
     const int num_workers = mt_info->num_mod_workers[MOD_LR];
+    start_stage_timing(cpi, kStageRestorationPick);
     av1_loop_restoration_save_boundary_lines(&cm->cur_frame->buf, cm, 1);
     av1_pick_filter_restoration(cpi->source, cpi);
+    end_stage_timing(cpi, kStageRestorationPick);
+    if (use_tile_prepack) av1_tile_prepack_launch(cpi);
     if ((skip_apply_postproc_filters & SKIP_APPLY_RESTORATION) == 0 &&
         (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
          cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
          cm->rst_info[2].frame_restoration_type != RESTORE_NONE)) {
+      start_stage_timing(cpi, kStageRestorationApply);
       if (num_workers > 1) {
         // Extension of frame borders is multi-threaded along with loop
         // restoration filter.
         const int do_extend_border = 1;
+        av1_enc_scheduler_stop(mt_info);
         av1_loop_restoration_filter_frame_mt(
-            &cm->cur_frame->buf, cm, 0, mt_info->workers, num_workers,
-            &mt_info->lr_row_sync, &cpi->lr_ctxt, do_extend_border);
+            &cm->cur_frame->buf, cm, mt_info->workers,
+            get_num_postproc_workers(cpi, num_workers), &mt_info->lr_row_sync,
+            &cpi->lr_ctxt, do_extend_border);
       } else {
-        av1_loop_restoration_filter_frame(&cm->cur_frame->buf, cm, 0,
+        av1_loop_restoration_filter_frame(&cm->cur_frame->buf, cm,
                                           &cpi->lr_ctxt);
       }
+      end_stage_timing(cpi, kStageRestorationApply);
     }
   }
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, loop_restoration_time);
 #endif
 #endif  // !CONFIG_REALTIME_ONLY
+
+  av1_tile_prepack_sync(cpi);
 }
 
 static void extend_frame_borders(AV1_COMP *cpi) {
@@ -2406,7 +2439,9 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
   start_timing(cpi, loop_filter_time);
 #endif
   if (use_loopfilter) {
+    start_stage_timing(cpi, kStageLoopFilterPick);
     av1_pick_filter_level(cpi->source, cpi, cpi->sf.lpf_sf.lpf_pick);
+    end_stage_timing(cpi, kStageLoopFilterPick);
     struct loopfilter *lf = &cm->lf;
     if ((lf->filter_level[0] || lf->filter_level[1]) &&
         (skip_apply_postproc_filters & SKIP_APPLY_LOOPFILTER) == 0) {
@@ -2420,9 +2455,12 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
       // pick method is LPF_PICK_FROM_Q as u and v plane filter levels are
       // equal.
       int lpf_opt_level = get_lpf_opt_level(&cpi->sf);
+      start_stage_timing(cpi, kStageLoopFilterApply);
+      av1_enc_scheduler_stop(mt_info);
       av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, xd, 0, num_planes, 0,
                                mt_info->workers, num_workers,
                                &mt_info->lf_row_sync, lpf_opt_level);
+      end_stage_timing(cpi, kStageLoopFilterApply);
     }
   }
 
@@ -2705,7 +2743,9 @@ static int encode_without_recode(AV1_COMP *cpi) {
   if (!frame_is_intra_only(cm)) av1_pick_and_set_high_precision_mv(cpi, q);
 
   // transform / motion compensation build reconstruction frame
+  start_stage_timing(cpi, kStageEncodeFrame);
   av1_encode_frame(cpi);
+  end_stage_timing(cpi, kStageEncodeFrame);
 
   if (!cpi->rc.rtc_external_ratectrl && !frame_is_intra_only(cm))
     update_motion_stat(cpi);
@@ -3010,7 +3050,9 @@ static int encode_with_recode_loop(AV1_COMP *cpi, size_t *size, uint8_t *dest,
     }
 
     // transform / motion compensation build reconstruction frame
+    start_stage_timing(cpi, kStageEncodeFrame);
     av1_encode_frame(cpi);
+    end_stage_timing(cpi, kStageEncodeFrame);
 
     // Disable mv_stats collection for parallel frames based on update flag.
     if (!cpi->do_frame_data_update) do_mv_stats_collection = 0;
@@ -3044,10 +3086,11 @@ static int encode_with_recode_loop(AV1_COMP *cpi, size_t *size, uint8_t *dest,
       av1_finalize_encoded_frame(cpi);
       int largest_tile_id = 0;  // Output from bitstream: unused here
       rc->coefficient_size = 0;
-      if (av1_pack_bitstream(cpi, dest, dest_size, size, &largest_tile_id) !=
-          AOM_CODEC_OK) {
-        return AOM_CODEC_ERROR;
-      }
+      start_stage_timing(cpi, kStagePackBitstream);
+      const int pack_status =
+          av1_pack_bitstream(cpi, dest, dest_size, size, &largest_tile_id);
+      end_stage_timing(cpi, kStagePackBitstream);
+      if (pack_status != AOM_CODEC_OK) return AOM_CODEC_ERROR;
 
       // bits used for this frame
       rc->projected_frame_size = (int)(*size) << 3;
@@ -3275,9 +3318,11 @@ static int encode_with_recode_loop_and_filter(AV1_COMP *cpi, size_t *size,
   start_timing(cpi, av1_pack_bitstream_final_time);
 #endif
   cpi->rc.coefficient_size = 0;
-  if (av1_pack_bitstream(cpi, dest, dest_size, size, largest_tile_id) !=
-      AOM_CODEC_OK)
-    return AOM_CODEC_ERROR;
+  start_stage_timing(cpi, kStagePackBitstream);
+  const int pack_status =
+      av1_pack_bitstream(cpi, dest, dest_size, size, largest_tile_id);
+  end_stage_timing(cpi, kStagePackBitstream);
+  if (pack_status != AOM_CODEC_OK) return AOM_CODEC_ERROR;
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, av1_pack_bitstream_final_time);
 #endif
@@ -4098,7 +4143,9 @@ static int apply_denoise_2d(AV1_COMP *cpi, const YV12_BUFFER_CONFIG *sd,
 
 int av1_receive_raw_frame(AV1_COMP *cpi, aom_enc_frame_flags_t frame_flags,
                           const YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time) {
+                          int64_t end_time,
+                          const aom_source_lending_t *lending,
+                          const aom_image_t *lent_img) {
   AV1_COMMON *const cm = &cpi->common;
   const SequenceHeader *const seq_params = cm->seq_params;
   int res = 0;
@@ -4159,7 +4206,8 @@ int av1_receive_raw_frame(AV1_COMP *cpi, aom_enc_frame_flags_t frame_flags,
 #endif  //  CONFIG_DENOISE
 
   if (av1_lookahead_push(cpi->ppi->lookahead, sd, time_stamp, end_time,
-                         use_highbitdepth, cpi->alloc_pyramid, frame_flags)) {
+                         use_highbitdepth, cpi->alloc_pyramid, frame_flags,
+                         lending, lent_img)) {
     aom_set_error(cm->error, AOM_CODEC_ERROR, "av1_lookahead_push() failed");
     res = -1;
   }
@@ -4715,6 +4763,7 @@ int av1_get_compressed_data(AV1_COMP *cpi, AV1_COMP_DATA *const cpi_data) {
   // before it returns.
   if (setjmp(cm->error->jmp)) {
     cm->error->setjmp = 0;
+    av1_enc_scheduler_stop(&cpi->mt_info);
     return cm->error->error_code;
   }
   cm->error->setjmp = 1;
@@ -4780,6 +4829,8 @@ int av1_get_compressed_data(AV1_COMP *cpi, AV1_COMP_DATA *const cpi_data) {
       cpi, &cpi_data->frame_size, cpi_data->cx_data, cpi_data->cx_data_sz,
       &cpi_data->lib_flags, &cpi_data->ts_frame_start, &cpi_data->ts_frame_end,
       cpi_data->timestamp_ratio, &cpi_data->pop_lookahead, cpi_data->flush);
+  // Return the workers to their idle state between frames.
+  av1_enc_scheduler_stop(&cpi->mt_info);
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
   if (cpi->oxcf.pass == 2 || cpi->oxcf.pass == 0)
@@ -21,7 +21,9 @@
 #include "config/aom_config.h"
 
 #include "aom/aomcx.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_util/aom_pthread.h"
+#include "aom_util/aom_scheduler.h"
 
 #include "av1/common/alloccommon.h"
 #include "av1/common/av1_common_int.h"
@@ -204,6 +206,7 @@ typedef enum {
   MOD_LPF,          // Deblocking loop filter
   MOD_CDEF_SEARCH,  // CDEF search
   MOD_CDEF,         // CDEF frame
+  MOD_LR_SEARCH,    // Loop restoration search
   MOD_LR,           // Loop restoration filtering
   MOD_PACK_BS,      // Pack bitstream
   MOD_FRAME_ENC,    // Frame Parallel encode
@@ -1391,21 +1394,12 @@ typedef struct {
  * \brief Encoder parameters for synchronization of row based multi-threading
  */
 typedef struct {
-#if CONFIG_MULTITHREAD
-  /**
-   * \name Synchronization objects for top-right dependency.
-   */
-  /**@{*/
-  pthread_mutex_t *mutex_; /*!< Mutex lock object */
-  pthread_cond_t *cond_;   /*!< Condition variable */
-  /**@}*/
-#endif  // CONFIG_MULTITHREAD
   /*!
-   * Buffer to store the superblock whose encoding is complete.
-   * num_finished_cols[i] stores the number of superblocks which finished
-   * encoding in the ith superblock row.
+   * Progress of the superblock rows, used for the top-right dependency.
+   * num_finished_cols.progress[i] stores the number of superblocks which
+   * finished encoding in the ith superblock row.
    */
-  int *num_finished_cols;
+  AV1RowMTProgress num_finished_cols;
   /*!
    * Denotes the superblock interval at which conditional signalling should
    * happen. Also denotes the minimum number of extra superblocks of the top row
@@ -1499,6 +1493,8 @@ typedef struct ThreadData {
   Block4x4VarInfo *src_var_info_of_4x4_sub_blocks;
   // Pointer to pc tree root.
   PC_TREE *pc_root;
+  // Allocator of the pc tree nodes and their contexts.
+  PC_TREE_ARENA pc_arena;
 } ThreadData;
 
 struct EncWorkerData;
@@ -1680,6 +1676,20 @@ typedef struct {
    * WIENER, SGRPROJ, SWITCHABLE.
    */
   RestorationType best_rtype[RESTORE_TYPES - 1];
+
+  /*!
+   * Distortion of this unit with each of RESTORE_NONE, RESTORE_WIENER and
+   * RESTORE_SGRPROJ applied, or INT64_MAX if that filter was pruned. These do
+   * not depend on the reference parameters used for delta-coding, so they are
+   * gathered for all units ahead of the coding-order search.
+   */
+  int64_t sse[RESTORE_SWITCHABLE_TYPES];
+
+  /*!
+   * Set once 'sgrproj' and 'sse[RESTORE_SGRPROJ]' hold the self-guided search
+   * result for this unit.
+   */
+  bool sgrproj_searched;
 } RestUnitSearchInfo;
 
 /*!
@@ -1695,11 +1705,47 @@ typedef struct {
   RestUnitSearchInfo *rusi[MAX_MB_PLANE];
 
   /*!
-   * Buffer used to hold dgd-avg data during SIMD call of Wiener filter.
+   * Buffer used to hold dgd-avg data during SIMD call of Wiener filter. One
+   * region per loop restoration search worker.
    */
   int16_t *dgd_avg;
+
+  /*!
+   * Restoration filter scratch buffer, RESTORATION_TMPBUF_SIZE bytes per loop
+   * restoration search worker.
+   */
+  int32_t *tmpbuf;
 } AV1LrPickStruct;
 
+/*!
+ * \brief Loop restoration search multi-threading object.
+ */
+typedef struct {
+#if CONFIG_MULTITHREAD
+  /*!
+   * Mutex lock used while dispatching jobs.
+   */
+  pthread_mutex_t *mutex_;
+#endif  // CONFIG_MULTITHREAD
+  /*!
+   * Search context of the plane being processed.
+   */
+  struct RestSearchCtxt *rsc;
+  /*!
+   * Index of the next restoration unit job to be processed.
+   */
+  int next_job;
+  /*!
+   * Number of restoration unit jobs in the current batch.
+   */
+  int num_jobs;
+  /*!
+   * Initialized to false, set to true by the worker thread that encounters an
+   * error in order to abort the processing of other worker threads.
+   */
+  bool lr_search_mt_exit;
+} AV1LrSearchSync;
+
 /*!
  * \brief Primary Encoder parameters related to multi-threading.
  */
@@ -1719,6 +1765,12 @@ typedef struct PrimaryMultiThreadInfo {
    */
   AVxWorker *workers;
 
+  /*!
+   * Scheduler that keeps the workers running across the multi-threaded stages
+   * of a frame. It is stopped before the workers are launched directly.
+   */
+  AVxScheduler scheduler;
+
   /*!
    * Data specific to each worker in encoder multi-threading.
    * tile_thr_data[i] stores the worker data of the ith thread.
@@ -1766,6 +1818,12 @@ typedef struct MultiThreadInfo {
    */
   AVxWorker *workers;
 
+  /*!
+   * Scheduler that keeps the workers running across the multi-threaded stages
+   * of a frame. It is stopped before the workers are launched directly.
+   */
+  AVxScheduler scheduler;
+
   /*!
    * Data specific to each worker in encoder multi-threading.
    * tile_thr_data[i] stores the worker data of the ith thread.
@@ -1809,11 +1867,21 @@ typedef struct MultiThreadInfo {
    */
   AV1LrSync lr_row_sync;
 
+  /*!
+   * Loop restoration search multi-threading object.
+   */
+  AV1LrSearchSync lr_search_sync;
+
   /*!
    * Pack bitstream multi-threading object.
    */
   AV1EncPackBSSync pack_bs_sync;
 
+  /*!
+   * Tile payloads packed ahead of the final bitstream packing.
+   */
+  AV1EncTilePrepack tile_prepack;
+
   /*!
    * Global Motion multi-threading object.
    */
@@ -1933,8 +2001,23 @@ typedef struct FramePartitionTimingStats {
 } FramePartitionTimingStats;
 #endif  // CONFIG_COLLECT_PARTITION_STATS
 
+// Encoder stages timed for AV1E_GET_FRAME_STAGE_TIMINGS. Unlike the
+// components below, these are timed in every build.
+enum {
+  kStageTemporalFilter,
+  kStageTpl,
+  kStageEncodeFrame,
+  kStageLoopFilterPick,
+  kStageLoopFilterApply,
+  kStageCdefPick,
+  kStageCdefApply,
+  kStageRestorationPick,
+  kStageRestorationApply,
+  kStagePackBitstream,
+  kNumEncStages,
+} UENUM1BYTE(ENC_STAGE);
+
 #if CONFIG_COLLECT_COMPONENT_TIMING
-#include "aom_ports/aom_timer.h"
 // Adjust the following to add new components.
 enum {
   av1_encode_strategy_time,
@@ -3377,6 +3460,17 @@ typedef struct AV1_COMP {
   uint64_t frame_component_time[kTimingComponents];
 #endif
 
+  /*!
+   * Time spent in each stage of the encoder, in microseconds, since the start
+   * of the current aom_codec_encode() call.
+   */
+  int64_t stage_time[kNumEncStages];
+  /*!
+   * Stores the timing of the stages between calls of start_stage_timing() and
+   * end_stage_timing().
+   */
+  struct aom_usec_timer stage_timer[kNumEncStages];
+
   /*!
    * Count the number of OBU_FRAME and OBU_FRAME_HEADER for level calculation.
    */
@@ -3803,15 +3897,21 @@ int av1_init_parallel_frame_context(const AV1_COMP_DATA *const first_cpi_data,
  * \param[in,out] sd             Contain raw frame data
  * \param[in]     time_stamp     Time stamp of the frame
  * \param[in]     end_time_stamp End time stamp
+ * \param[in]     lending        Release callback of lent_img, or NULL if the
+ *                               frame is not lent by the application
+ * \param[in]     lent_img       Application image backing sd
  *
  * \return Returns a value to indicate if the frame data is received
  * successfully.
- * \note The caller can assume that a copy of this frame is made and not just a
- * copy of the pointer.
+ * \note Unless lending is set, the caller can assume that a copy of this frame
+ * is made and not just a copy of the pointer. A lent frame may be used in
+ * place until lending->release_cb is called for lent_img.
  */
 int av1_receive_raw_frame(AV1_COMP *cpi, aom_enc_frame_flags_t frame_flags,
                           const YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time_stamp);
+                          int64_t end_time_stamp,
+                          const aom_source_lending_t *lending,
+                          const aom_image_t *lent_img);
 
 /*!\brief Encode a frame
  *
@@ -4496,6 +4596,14 @@ static inline int av1_get_bsize_idx_for_part_stats(BLOCK_SIZE bsize) {
 }
 #endif  // CONFIG_COLLECT_PARTITION_STATS
 
+static inline void start_stage_timing(AV1_COMP *cpi, ENC_STAGE stage) {
+  aom_usec_timer_start(&cpi->stage_timer[stage]);
+}
+static inline void end_stage_timing(AV1_COMP *cpi, ENC_STAGE stage) {
+  aom_usec_timer_mark(&cpi->stage_timer[stage]);
+  cpi->stage_time[stage] += aom_usec_timer_elapsed(&cpi->stage_timer[stage]);
+}
+
 #if CONFIG_COLLECT_COMPONENT_TIMING
 static inline void start_timing(AV1_COMP *cpi, int component) {
   aom_usec_timer_start(&cpi->component_timer[component]);
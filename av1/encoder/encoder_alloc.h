@@ -82,7 +82,7 @@ static inline void alloc_compressor_data(AV1_COMP *cpi) {
                        "Failed to allocate SMS tree");
   }
   cpi->td.firstpass_ctx =
-      av1_alloc_pmc(cpi, BLOCK_16X16, &cpi->td.shared_coeff_buf);
+      av1_alloc_pmc(cpi, BLOCK_16X16, &cpi->td.shared_coeff_buf, NULL);
   if (!cpi->td.firstpass_ctx)
     aom_internal_error(cm->error, AOM_CODEC_MEM_ERROR,
                        "Failed to allocate PICK_MODE_CONTEXT");
@@ -250,6 +250,7 @@ static inline void dealloc_compressor_data(AV1_COMP *cpi) {
   av1_free_pc_tree_recursive(cpi->td.pc_root, num_planes, 0, 0,
                              cpi->sf.part_sf.partition_search_type);
   cpi->td.pc_root = NULL;
+  av1_pc_tree_arena_free(&cpi->td.pc_arena);
 
   for (int i = 0; i < 2; i++)
     for (int j = 0; j < 2; j++) {
@@ -319,6 +320,8 @@ static inline void dealloc_compressor_data(AV1_COMP *cpi) {
   }
   aom_free(cpi->pick_lr_ctxt.dgd_avg);
   cpi->pick_lr_ctxt.dgd_avg = NULL;
+  aom_free(cpi->pick_lr_ctxt.tmpbuf);
+  cpi->pick_lr_ctxt.tmpbuf = NULL;
 
   aom_free_frame_buffer(&cpi->trial_frame_rst);
   aom_free_frame_buffer(&cpi->scaled_source);
@@ -519,6 +522,7 @@ static inline void free_thread_data(AV1_PRIMARY *ppi) {
 #endif
     av1_free_pc_tree_recursive(td->pc_root, num_planes, 0, 0, SEARCH_PARTITION);
     td->pc_root = NULL;
+    av1_pc_tree_arena_free(&td->pc_arena);
     av1_dealloc_mb_wiener_var_pred_buf(td);
     aom_free(td);
     thread_data->td = NULL;
@@ -1158,8 +1158,8 @@ void av1_determine_sc_tools_with_encoding(AV1_COMP *cpi, const int q_orig) {
 }
 #endif  // CONFIG_REALTIME_ONLY
 
-static void fix_interp_filter(InterpFilter *const interp_filter,
-                              const FRAME_COUNTS *const counts) {
+void av1_fix_interp_filter(InterpFilter *const interp_filter,
+                           const FRAME_COUNTS *const counts) {
   if (*interp_filter == SWITCHABLE) {
     // Check to see if only one of the filters is actually used
     int count[SWITCHABLE_FILTERS] = { 0 };
@@ -1215,16 +1215,19 @@ void av1_finalize_encoded_frame(AV1_COMP *const cpi) {
       cm->film_grain_params.random_seed = 7391;
   }
 
-  // Initialise all tiles' contexts from the global frame context
-  for (int tile_col = 0; tile_col < cm->tiles.cols; tile_col++) {
-    for (int tile_row = 0; tile_row < cm->tiles.rows; tile_row++) {
-      const int tile_idx = tile_row * cm->tiles.cols + tile_col;
-      cpi->tile_data[tile_idx].tctx = *cm->fc;
+  // Initialise all tiles' contexts from the global frame context. Tiles that
+  // have been prepacked already hold their adapted contexts.
+  if (!cpi->mt_info.tile_prepack.valid) {
+    for (int tile_col = 0; tile_col < cm->tiles.cols; tile_col++) {
+      for (int tile_row = 0; tile_row < cm->tiles.rows; tile_row++) {
+        const int tile_idx = tile_row * cm->tiles.cols + tile_col;
+        cpi->tile_data[tile_idx].tctx = *cm->fc;
+      }
     }
   }
 
   if (!frame_is_intra_only(cm))
-    fix_interp_filter(&cm->features.interp_filter, cpi->td.counts);
+    av1_fix_interp_filter(&cm->features.interp_filter, cpi->td.counts);
 }
 
 int av1_is_integer_mv(const YV12_BUFFER_CONFIG *cur_picture,
@@ -1030,6 +1030,11 @@ void av1_determine_sc_tools_with_encoding(AV1_COMP *cpi, const int q_orig);
 void av1_set_size_dependent_vars(AV1_COMP *cpi, int *q, int *bottom_index,
                                  int *top_index);
 
+// Sets the frame level interpolation filter when only one of the switchable
+// filters has been used.
+void av1_fix_interp_filter(InterpFilter *const interp_filter,
+                           const FRAME_COUNTS *const counts);
+
 void av1_finalize_encoded_frame(AV1_COMP *const cpi);
 
 int av1_is_integer_mv(const YV12_BUFFER_CONFIG *cur_picture,
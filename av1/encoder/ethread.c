@@ -32,6 +32,7 @@
 #include "av1/encoder/global_motion_facade.h"
 #include "av1/encoder/intra_mode_search_utils.h"
 #include "av1/encoder/picklpf.h"
+#include "av1/encoder/pickrst.h"
 #include "av1/encoder/rdopt.h"
 #include "aom_dsp/aom_dsp_common.h"
 #include "av1/encoder/temporal_filter.h"
@@ -121,14 +122,9 @@ void av1_row_mt_sync_read(AV1EncRowMultiThreadSync *row_mt_sync, int r, int c) {
   const int nsync = row_mt_sync->sync_range;
 
   if (r) {
-    pthread_mutex_t *const mutex = &row_mt_sync->mutex_[r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > row_mt_sync->num_finished_cols[r - 1] - nsync -
-                   row_mt_sync->intrabc_extra_top_right_sb_delay) {
-      pthread_cond_wait(&row_mt_sync->cond_[r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
+    av1_row_mt_progress_wait(
+        &row_mt_sync->num_finished_cols, r - 1,
+        c + nsync + row_mt_sync->intrabc_extra_top_right_sb_delay);
   }
 #else
   (void)row_mt_sync;
@@ -152,20 +148,11 @@ void av1_row_mt_sync_write(AV1EncRowMultiThreadSync *row_mt_sync, int r, int c,
     cur = cols + nsync + row_mt_sync->intrabc_extra_top_right_sb_delay;
   }
 
-  if (sig) {
-    pthread_mutex_lock(&row_mt_sync->mutex_[r]);
-
-    // When a thread encounters an error, num_finished_cols[r] is set to maximum
-    // column number. In this case, the AOMMAX operation here ensures that
-    // num_finished_cols[r] is not overwritten with a smaller value thus
-    // preventing the infinite waiting of threads in the relevant sync_read()
-    // function.
-    row_mt_sync->num_finished_cols[r] =
-        AOMMAX(row_mt_sync->num_finished_cols[r], cur);
-
-    pthread_cond_signal(&row_mt_sync->cond_[r]);
-    pthread_mutex_unlock(&row_mt_sync->mutex_[r]);
-  }
+  // When a thread encounters an error, num_finished_cols[r] is set to maximum
+  // column number. av1_row_mt_progress_set() never lowers the progress, thus
+  // preventing the infinite waiting of threads in the relevant sync_read()
+  // function.
+  if (sig) av1_row_mt_progress_set(&row_mt_sync->num_finished_cols, r, cur);
 #else
   (void)row_mt_sync;
   (void)r;
@@ -177,28 +164,7 @@ void av1_row_mt_sync_write(AV1EncRowMultiThreadSync *row_mt_sync, int r, int c,
 // Allocate memory for row synchronization
 static void row_mt_sync_mem_alloc(AV1EncRowMultiThreadSync *row_mt_sync,
                                   AV1_COMMON *cm, int rows) {
-#if CONFIG_MULTITHREAD
-  int i;
-
-  CHECK_MEM_ERROR(cm, row_mt_sync->mutex_,
-                  aom_malloc(sizeof(*row_mt_sync->mutex_) * rows));
-  if (row_mt_sync->mutex_) {
-    for (i = 0; i < rows; ++i) {
-      pthread_mutex_init(&row_mt_sync->mutex_[i], NULL);
-    }
-  }
-
-  CHECK_MEM_ERROR(cm, row_mt_sync->cond_,
-                  aom_malloc(sizeof(*row_mt_sync->cond_) * rows));
-  if (row_mt_sync->cond_) {
-    for (i = 0; i < rows; ++i) {
-      pthread_cond_init(&row_mt_sync->cond_[i], NULL);
-    }
-  }
-#endif  // CONFIG_MULTITHREAD
-
-  CHECK_MEM_ERROR(cm, row_mt_sync->num_finished_cols,
-                  aom_malloc(sizeof(*row_mt_sync->num_finished_cols) * rows));
+  av1_row_mt_progress_alloc(&row_mt_sync->num_finished_cols, cm, rows);
 
   row_mt_sync->rows = rows;
   // Set up nsync.
@@ -208,23 +174,7 @@ static void row_mt_sync_mem_alloc(AV1EncRowMultiThreadSync *row_mt_sync,
 // Deallocate row based multi-threading synchronization related mutex and data
 void av1_row_mt_sync_mem_dealloc(AV1EncRowMultiThreadSync *row_mt_sync) {
   if (row_mt_sync != NULL) {
-#if CONFIG_MULTITHREAD
-    int i;
-
-    if (row_mt_sync->mutex_ != NULL) {
-      for (i = 0; i < row_mt_sync->rows; ++i) {
-        pthread_mutex_destroy(&row_mt_sync->mutex_[i]);
-      }
-      aom_free(row_mt_sync->mutex_);
-    }
-    if (row_mt_sync->cond_ != NULL) {
-      for (i = 0; i < row_mt_sync->rows; ++i) {
-        pthread_cond_destroy(&row_mt_sync->cond_[i]);
-      }
-      aom_free(row_mt_sync->cond_);
-    }
-#endif  // CONFIG_MULTITHREAD
-    aom_free(row_mt_sync->num_finished_cols);
+    av1_row_mt_progress_dealloc(&row_mt_sync->num_finished_cols);
 
     // clear the structure as the source of this call may be dynamic change
     // in tiles in which case this call will be followed by an _alloc()
@@ -637,7 +587,8 @@ static int enc_row_mt_worker_hook(void *arg1, void *unused) {
   // Preallocate the pc_tree for realtime coding to reduce the cost of memory
   // allocation.
   if (cpi->sf.rt_sf.use_nonrd_pick_mode) {
-    thread_data->td->pc_root = av1_alloc_pc_tree_node(cm->seq_params->sb_size);
+    thread_data->td->pc_root = av1_alloc_pc_tree_node(
+        cm->seq_params->sb_size, &thread_data->td->pc_arena);
     if (!thread_data->td->pc_root)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -771,7 +722,8 @@ static int enc_worker_hook(void *arg1, void *unused) {
   // Preallocate the pc_tree for realtime coding to reduce the cost of memory
   // allocation.
   if (cpi->sf.rt_sf.use_nonrd_pick_mode) {
-    thread_data->td->pc_root = av1_alloc_pc_tree_node(cm->seq_params->sb_size);
+    thread_data->td->pc_root = av1_alloc_pc_tree_node(
+        cm->seq_params->sb_size, &thread_data->td->pc_arena);
     if (!thread_data->td->pc_root)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -829,11 +781,15 @@ void av1_init_lr_mt_buffers(AV1_COMP *cpi) {
   if (lr_sync->sync_range) {
     if (cpi->ppi->gf_group.frame_parallel_level[cpi->gf_frame_index] > 0)
       return;
-    int num_lr_workers =
-        av1_get_num_mod_workers_for_alloc(&cpi->ppi->p_mt_info, MOD_LR);
-    assert(num_lr_workers <= lr_sync->num_workers);
-    lr_sync->lrworkerdata[num_lr_workers - 1].rst_tmpbuf = cm->rst_tmpbuf;
-    lr_sync->lrworkerdata[num_lr_workers - 1].rlbs = cm->rlbs;
+    // The last worker data always borrows the frame-level buffers; the others
+    // own theirs (see av1_loop_restoration_alloc()). The per-frame MOD_LR
+    // worker count can drop below the allocated count (e.g. when superres
+    // narrows the coded frame), so index by the allocation, not by it.
+    const int last = lr_sync->num_workers - 1;
+    assert(av1_get_num_mod_workers_for_alloc(&cpi->ppi->p_mt_info, MOD_LR) <=
+           lr_sync->num_workers);
+    lr_sync->lrworkerdata[last].rst_tmpbuf = cm->rst_tmpbuf;
+    lr_sync->lrworkerdata[last].rlbs = cm->rlbs;
   }
 }
 #endif
@@ -879,6 +835,15 @@ void av1_init_mt_sync(AV1_COMP *cpi, int is_first_pass) {
                       aom_malloc(sizeof(*tf_sync->mutex_)));
       if (tf_sync->mutex_) pthread_mutex_init(tf_sync->mutex_, NULL);
     }
+
+    // Initialize loop restoration search MT object.
+    AV1LrSearchSync *lr_search_sync = &mt_info->lr_search_sync;
+    if (lr_search_sync->mutex_ == NULL) {
+      CHECK_MEM_ERROR(cm, lr_search_sync->mutex_,
+                      aom_malloc(sizeof(*lr_search_sync->mutex_)));
+      if (lr_search_sync->mutex_)
+        pthread_mutex_init(lr_search_sync->mutex_, NULL);
+    }
 #endif  // !CONFIG_REALTIME_ONLY
         // Initialize CDEF MT object.
     AV1CdefSync *cdef_sync = &mt_info->cdef_sync;
@@ -983,7 +948,7 @@ void av1_init_tile_thread_data(AV1_PRIMARY *ppi, int is_first_pass) {
       if (i < p_mt_info->num_mod_workers[MOD_FP]) {
         // Set up firstpass PICK_MODE_CONTEXT.
         td->firstpass_ctx =
-            av1_alloc_pmc(ppi->cpi, BLOCK_16X16, &td->shared_coeff_buf);
+            av1_alloc_pmc(ppi->cpi, BLOCK_16X16, &td->shared_coeff_buf, NULL);
         if (!td->firstpass_ctx)
           aom_internal_error(&ppi->error, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PICK_MODE_CONTEXT");
@@ -1471,8 +1436,42 @@ void av1_compress_parallel_frames(AV1_PRIMARY *const ppi,
                                 ref_buffers_used_map);
 }
 
+// Runs the hooks of the workers as tasks of the scheduler, which is started if
+// needed. Returns 0 if the scheduler could not be used, in which case no hook
+// has been run.
+static int run_workers_on_scheduler(MultiThreadInfo *const mt_info,
+                                    int num_workers) {
+  AVxScheduler *const scheduler = &mt_info->scheduler;
+  if (num_workers < 2 ||
+      !aom_scheduler_start(scheduler, mt_info->workers, mt_info->num_workers))
+    return 0;
+  assert(num_workers <= mt_info->num_workers);
+
+  AVxTaskGroup group;
+  aom_scheduler_group_init(&group);
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *const worker = &mt_info->workers[i];
+    EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
+    thread_data->had_error = 0;
+    if (!aom_scheduler_submit(scheduler, i, &group, worker->hook,
+                              worker->data1, worker->data2,
+                              &thread_data->had_error)) {
+      // Run the hook on the calling thread instead.
+      thread_data->had_error = !worker->hook(worker->data1, worker->data2);
+    }
+  }
+  aom_scheduler_wait(scheduler, &group);
+  return 1;
+}
+
+void av1_enc_scheduler_stop(MultiThreadInfo *mt_info) {
+  aom_scheduler_stop(&mt_info->scheduler);
+}
+
 static inline void launch_workers(MultiThreadInfo *const mt_info,
                                   int num_workers) {
+  if (run_workers_on_scheduler(mt_info, num_workers)) return;
+
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
   for (int i = num_workers - 1; i >= 0; i--) {
     AVxWorker *const worker = &mt_info->workers[i];
@@ -1488,7 +1487,12 @@ static inline void sync_enc_workers(MultiThreadInfo *const mt_info,
                                     AV1_COMMON *const cm, int num_workers) {
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
   const AVxWorker *const worker_main = &mt_info->workers[0];
-  int had_error = worker_main->had_error;
+  // The hooks have already finished if they ran on the scheduler. Keep this
+  // condition in sync with run_workers_on_scheduler().
+  const int use_scheduler = mt_info->scheduler.running && num_workers > 1;
+  int had_error = use_scheduler
+                      ? ((EncWorkerData *)worker_main->data1)->had_error
+                      : worker_main->had_error;
   struct aom_internal_error_info error_info;
 
   // Read the error_info of main thread.
@@ -1499,9 +1503,10 @@ static inline void sync_enc_workers(MultiThreadInfo *const mt_info,
   // Encoding ends.
   for (int i = num_workers - 1; i > 0; i--) {
     AVxWorker *const worker = &mt_info->workers[i];
-    if (!winterface->sync(worker)) {
+    EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
+    if (use_scheduler ? thread_data->had_error : !winterface->sync(worker)) {
       had_error = 1;
-      error_info = ((EncWorkerData *)worker->data1)->error_info;
+      error_info = thread_data->error_info;
     }
   }
 
@@ -1961,8 +1966,7 @@ void av1_encode_tiles_row_mt(AV1_COMP *cpi) {
       AV1EncRowMultiThreadSync *const row_mt_sync = &this_tile->row_mt_sync;
 
       // Initialize num_finished_cols to -1 for all rows.
-      memset(row_mt_sync->num_finished_cols, -1,
-             sizeof(*row_mt_sync->num_finished_cols) * max_sb_rows_in_tile);
+      av1_row_mt_progress_reset(&row_mt_sync->num_finished_cols);
       row_mt_sync->next_mi_row = this_tile->tile_info.mi_row_start;
       row_mt_sync->num_threads_working = 0;
       row_mt_sync->intrabc_extra_top_right_sb_delay =
@@ -2040,8 +2044,7 @@ void av1_fp_encode_tiles_row_mt(AV1_COMP *cpi) {
       AV1EncRowMultiThreadSync *const row_mt_sync = &this_tile->row_mt_sync;
 
       // Initialize num_finished_cols to -1 for all rows.
-      memset(row_mt_sync->num_finished_cols, -1,
-             sizeof(*row_mt_sync->num_finished_cols) * max_mb_rows);
+      av1_row_mt_progress_reset(&row_mt_sync->num_finished_cols);
       row_mt_sync->next_mi_row = this_tile->tile_info.mi_row_start;
       row_mt_sync->num_threads_working = 0;
 
@@ -2081,12 +2084,8 @@ void av1_tpl_row_mt_sync_read(AV1TplRowMultiThreadSync *tpl_row_mt_sync, int r,
   int nsync = tpl_row_mt_sync->sync_range;
 
   if (r) {
-    pthread_mutex_t *const mutex = &tpl_row_mt_sync->mutex_[r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > tpl_row_mt_sync->num_finished_cols[r - 1] - nsync)
-      pthread_cond_wait(&tpl_row_mt_sync->cond_[r - 1], mutex);
-    pthread_mutex_unlock(mutex);
+    av1_row_mt_progress_wait(&tpl_row_mt_sync->num_finished_cols, r - 1,
+                             c + nsync);
   }
 #else
   (void)tpl_row_mt_sync;
@@ -2110,20 +2109,11 @@ void av1_tpl_row_mt_sync_write(AV1TplRowMultiThreadSync *tpl_row_mt_sync, int r,
     cur = cols + nsync;
   }
 
-  if (sig) {
-    pthread_mutex_lock(&tpl_row_mt_sync->mutex_[r]);
-
-    // When a thread encounters an error, num_finished_cols[r] is set to maximum
-    // column number. In this case, the AOMMAX operation here ensures that
-    // num_finished_cols[r] is not overwritten with a smaller value thus
-    // preventing the infinite waiting of threads in the relevant sync_read()
-    // function.
-    tpl_row_mt_sync->num_finished_cols[r] =
-        AOMMAX(tpl_row_mt_sync->num_finished_cols[r], cur);
-
-    pthread_cond_signal(&tpl_row_mt_sync->cond_[r]);
-    pthread_mutex_unlock(&tpl_row_mt_sync->mutex_[r]);
-  }
+  // When a thread encounters an error, num_finished_cols[r] is set to maximum
+  // column number. av1_row_mt_progress_set() never lowers the progress, thus
+  // preventing the infinite waiting of threads in the relevant sync_read()
+  // function.
+  if (sig) av1_row_mt_progress_set(&tpl_row_mt_sync->num_finished_cols, r, cur);
 #else
   (void)tpl_row_mt_sync;
   (void)r;
@@ -2214,20 +2204,7 @@ static int tpl_worker_hook(void *arg1, void *unused) {
 void av1_tpl_dealloc(AV1TplRowMultiThreadSync *tpl_sync) {
   assert(tpl_sync != NULL);
 
-#if CONFIG_MULTITHREAD
-  if (tpl_sync->mutex_ != NULL) {
-    for (int i = 0; i < tpl_sync->rows; ++i)
-      pthread_mutex_destroy(&tpl_sync->mutex_[i]);
-    aom_free(tpl_sync->mutex_);
-  }
-  if (tpl_sync->cond_ != NULL) {
-    for (int i = 0; i < tpl_sync->rows; ++i)
-      pthread_cond_destroy(&tpl_sync->cond_[i]);
-    aom_free(tpl_sync->cond_);
-  }
-#endif  // CONFIG_MULTITHREAD
-
-  aom_free(tpl_sync->num_finished_cols);
+  av1_row_mt_progress_dealloc(&tpl_sync->num_finished_cols);
   // clear the structure as the source of this call may be a resize in which
   // case this call will be followed by an _alloc() which may fail.
   av1_zero(*tpl_sync);
@@ -2237,25 +2214,7 @@ void av1_tpl_dealloc(AV1TplRowMultiThreadSync *tpl_sync) {
 static void av1_tpl_alloc(AV1TplRowMultiThreadSync *tpl_sync, AV1_COMMON *cm,
                           int mb_rows) {
   tpl_sync->rows = mb_rows;
-#if CONFIG_MULTITHREAD
-  {
-    CHECK_MEM_ERROR(cm, tpl_sync->mutex_,
-                    aom_malloc(sizeof(*tpl_sync->mutex_) * mb_rows));
-    if (tpl_sync->mutex_) {
-      for (int i = 0; i < mb_rows; ++i)
-        pthread_mutex_init(&tpl_sync->mutex_[i], NULL);
-    }
-
-    CHECK_MEM_ERROR(cm, tpl_sync->cond_,
-                    aom_malloc(sizeof(*tpl_sync->cond_) * mb_rows));
-    if (tpl_sync->cond_) {
-      for (int i = 0; i < mb_rows; ++i)
-        pthread_cond_init(&tpl_sync->cond_[i], NULL);
-    }
-  }
-#endif  // CONFIG_MULTITHREAD
-  CHECK_MEM_ERROR(cm, tpl_sync->num_finished_cols,
-                  aom_malloc(sizeof(*tpl_sync->num_finished_cols) * mb_rows));
+  av1_row_mt_progress_alloc(&tpl_sync->num_finished_cols, cm, mb_rows);
 
   // Set up nsync.
   tpl_sync->sync_range = 1;
@@ -2339,8 +2298,7 @@ void av1_mc_flow_dispenser_mt(AV1_COMP *cpi) {
   mt_info->tpl_row_mt.tpl_mt_exit = false;
 
   // Initialize cur_mb_col to -1 for all MB rows.
-  memset(tpl_sync->num_finished_cols, -1,
-         sizeof(*tpl_sync->num_finished_cols) * mb_rows);
+  av1_row_mt_progress_reset(&tpl_sync->num_finished_cols);
 
   prepare_tpl_workers(cpi, tpl_worker_hook, num_workers);
   launch_workers(&cpi->mt_info, num_workers);
@@ -2876,8 +2834,7 @@ void av1_calc_mb_wiener_var_mt(AV1_COMP *cpi, int num_workers,
   intra_row_mt_sync->intrabc_extra_top_right_sb_delay = 0;
   intra_row_mt_sync->num_threads_working = num_workers;
   intra_row_mt_sync->next_mi_row = 0;
-  memset(intra_row_mt_sync->num_finished_cols, -1,
-         sizeof(*intra_row_mt_sync->num_finished_cols) * mi_rows);
+  av1_row_mt_progress_reset(&intra_row_mt_sync->num_finished_cols);
   mt_info->enc_row_mt.mb_wiener_mt_exit = false;
 
   prepare_wiener_var_workers(cpi, cal_mb_wiener_var_hook, num_workers);
@@ -3234,6 +3191,80 @@ void av1_write_tile_obu_mt(
                           tile_data_start, num_workers);
 }
 
+// Worker hook function of tile prepacking.
+static int tile_prepack_worker_hook(void *arg1, void *unused) {
+  (void)unused;
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  AV1_COMP *const cpi = thread_data->cpi;
+  MACROBLOCKD *const xd = &thread_data->td->mb.e_mbd;
+  struct aom_internal_error_info *const error_info = &thread_data->error_info;
+  xd->error_info = error_info;
+
+  // The jmp_buf is valid only for the duration of the function that calls
+  // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
+  // before it returns.
+  if (setjmp(error_info->jmp)) {
+    error_info->setjmp = 0;
+    return 0;
+  }
+  error_info->setjmp = 1;
+
+  av1_prepack_tiles(cpi, thread_data->td);
+
+  error_info->setjmp = 0;
+  return 1;
+}
+
+// Packs the tile payloads of the current frame on the last worker, leaving the
+// remaining workers to the post-processing filters. The tile syntax must be
+// final when this is called.
+void av1_tile_prepack_launch(AV1_COMP *cpi) {
+  MultiThreadInfo *const mt_info = &cpi->mt_info;
+  AV1EncTilePrepack *const tile_prepack = &mt_info->tile_prepack;
+  const int worker_idx = mt_info->num_workers - 1;
+  assert(worker_idx > 0);
+  AVxWorker *const worker = &mt_info->workers[worker_idx];
+  EncWorkerData *const thread_data = &mt_info->tile_thr_data[worker_idx];
+
+  av1_enc_scheduler_stop(mt_info);
+  av1_setup_tile_prepack(cpi);
+
+  thread_data->td = thread_data->original_td;
+  thread_data->td->mb = cpi->td.mb;
+  thread_data->cpi = cpi;
+  thread_data->start = worker_idx;
+  thread_data->thread_id = worker_idx;
+
+  worker->hook = tile_prepack_worker_hook;
+  worker->data1 = thread_data;
+  worker->data2 = NULL;
+  worker->had_error = 0;
+  tile_prepack->in_progress = true;
+  aom_get_worker_interface()->launch(worker);
+}
+
+// Waits for the tile prepack worker launched by av1_tile_prepack_launch().
+void av1_tile_prepack_sync(AV1_COMP *cpi) {
+  MultiThreadInfo *const mt_info = &cpi->mt_info;
+  AV1EncTilePrepack *const tile_prepack = &mt_info->tile_prepack;
+  if (!tile_prepack->in_progress) return;
+  const int worker_idx = mt_info->num_workers - 1;
+  AVxWorker *const worker = &mt_info->workers[worker_idx];
+  const int ok = aom_get_worker_interface()->sync(worker);
+  tile_prepack->in_progress = false;
+  if (!ok) {
+    aom_internal_error_copy(cpi->common.error,
+                            &mt_info->tile_thr_data[worker_idx].error_info);
+  }
+  tile_prepack->valid = true;
+}
+
+void av1_tile_prepack_dealloc(AV1EncTilePrepack *tile_prepack) {
+  aom_free(tile_prepack->buf);
+  tile_prepack->buf = NULL;
+  tile_prepack->buf_size = 0;
+}
+
 // Deallocate memory for CDEF search multi-thread synchronization.
 void av1_cdef_mt_dealloc(AV1CdefSync *cdef_sync) {
   (void)cdef_sync;
@@ -3371,6 +3402,101 @@ void av1_cdef_mse_calc_frame_mt(AV1_COMP *cpi) {
   sync_enc_workers(mt_info, &cpi->common, num_workers);
 }
 
+#if !CONFIG_REALTIME_ONLY
+// Deallocate memory for loop restoration search multi-thread synchronization.
+void av1_lr_search_mt_dealloc(AV1LrSearchSync *lr_search_sync) {
+  (void)lr_search_sync;
+  assert(lr_search_sync != NULL);
+#if CONFIG_MULTITHREAD
+  if (lr_search_sync->mutex_ != NULL) {
+    pthread_mutex_destroy(lr_search_sync->mutex_);
+    aom_free(lr_search_sync->mutex_);
+  }
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Checks if a job is available. If job is available, populates the index of
+// the next restoration unit job and returns 1, else returns 0.
+static inline int lr_search_get_next_job(AV1LrSearchSync *lr_search_sync,
+                                         int *job_idx) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(lr_search_sync->mutex_);
+#endif  // CONFIG_MULTITHREAD
+  int do_next_job = 0;
+  if (!lr_search_sync->lr_search_mt_exit &&
+      lr_search_sync->next_job < lr_search_sync->num_jobs) {
+    *job_idx = lr_search_sync->next_job++;
+    do_next_job = 1;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(lr_search_sync->mutex_);
+#endif  // CONFIG_MULTITHREAD
+  return do_next_job;
+}
+
+// Hook function for each thread in loop restoration search multi-threading.
+static int lr_search_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *thread_data = (EncWorkerData *)arg1;
+  AV1LrSearchSync *const lr_search_sync = (AV1LrSearchSync *)arg2;
+  struct aom_internal_error_info *const error_info = &thread_data->error_info;
+
+  // The jmp_buf is valid only for the duration of the function that calls
+  // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
+  // before it returns.
+  if (setjmp(error_info->jmp)) {
+    error_info->setjmp = 0;
+#if CONFIG_MULTITHREAD
+    pthread_mutex_lock(lr_search_sync->mutex_);
+    lr_search_sync->lr_search_mt_exit = true;
+    pthread_mutex_unlock(lr_search_sync->mutex_);
+#endif
+    return 0;
+  }
+  error_info->setjmp = 1;
+
+  int job_idx;
+  while (lr_search_get_next_job(lr_search_sync, &job_idx)) {
+    av1_lr_gather_unit_stats(lr_search_sync->rsc, job_idx,
+                             thread_data->thread_id, error_info);
+  }
+  error_info->setjmp = 0;
+  return 1;
+}
+
+// Assigns loop restoration search hook function and thread data to each
+// worker.
+static void prepare_lr_search_workers(AV1_COMP *cpi, AVxWorkerHook hook,
+                                      int num_workers) {
+  MultiThreadInfo *mt_info = &cpi->mt_info;
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *worker = &mt_info->workers[i];
+    EncWorkerData *thread_data = &mt_info->tile_thr_data[i];
+
+    thread_data->cpi = cpi;
+    thread_data->thread_id = i;
+    worker->hook = hook;
+    worker->data1 = thread_data;
+    worker->data2 = &mt_info->lr_search_sync;
+  }
+}
+
+// Implements multi-threading for gathering the restoration unit statistics
+// in loop restoration search.
+void av1_lr_gather_stats_mt(AV1_COMP *cpi, struct RestSearchCtxt *rsc,
+                            int num_jobs, int num_workers) {
+  MultiThreadInfo *mt_info = &cpi->mt_info;
+  AV1LrSearchSync *lr_search_sync = &mt_info->lr_search_sync;
+
+  lr_search_sync->rsc = rsc;
+  lr_search_sync->next_job = 0;
+  lr_search_sync->num_jobs = num_jobs;
+  lr_search_sync->lr_search_mt_exit = false;
+  prepare_lr_search_workers(cpi, lr_search_worker_hook, num_workers);
+  launch_workers(mt_info, num_workers);
+  sync_enc_workers(mt_info, &cpi->common, num_workers);
+}
+#endif  // !CONFIG_REALTIME_ONLY
+
 // Computes num_workers for temporal filter multi-threading.
 static inline int compute_num_tf_workers(const AV1_COMP *cpi) {
   // For single-pass encode, using no. of workers as per tf block size was not
@@ -3403,6 +3529,11 @@ static inline int compute_num_cdef_workers(AV1_COMP *cpi) {
   return compute_num_enc_workers(cpi, cpi->oxcf.max_threads);
 }
 
+// Computes num_workers for loop-restoration search multi-threading.
+static inline int compute_num_lr_search_workers(AV1_COMP *cpi) {
+  return compute_num_enc_workers(cpi, cpi->oxcf.max_threads);
+}
+
 // Computes num_workers for loop-restoration multi-threading.
 static inline int compute_num_lr_workers(AV1_COMP *cpi) {
   return compute_num_enc_workers(cpi, cpi->oxcf.max_threads);
@@ -3448,6 +3579,9 @@ static int compute_num_mod_workers(AV1_COMP *cpi,
       num_mod_workers = compute_num_cdef_workers(cpi);
       break;
     case MOD_CDEF: num_mod_workers = compute_num_cdef_workers(cpi); break;
+    case MOD_LR_SEARCH:
+      num_mod_workers = compute_num_lr_search_workers(cpi);
+      break;
     case MOD_LR: num_mod_workers = compute_num_lr_workers(cpi); break;
     case MOD_PACK_BS: num_mod_workers = compute_num_pack_bs_workers(cpi); break;
     case MOD_FRAME_ENC:
@@ -28,6 +28,9 @@ typedef struct EncWorkerData {
   LFWorkerData *lf_data;
   int start;
   int thread_id;
+  // Set when the hook of this worker fails while it runs as a task of the
+  // encoder's scheduler.
+  int had_error;
 } EncWorkerData;
 
 void av1_row_mt_sync_read(AV1EncRowMultiThreadSync *row_mt_sync, int r, int c);
@@ -90,6 +93,8 @@ void av1_create_workers(AV1_PRIMARY *ppi, int num_workers);
 
 void av1_terminate_workers(AV1_PRIMARY *ppi);
 
+void av1_enc_scheduler_stop(MultiThreadInfo *mt_info);
+
 void av1_init_frame_mt(AV1_PRIMARY *ppi, AV1_COMP *cpi);
 
 void av1_init_cdef_worker(AV1_COMP *cpi);
@@ -111,6 +116,15 @@ void av1_cdef_mse_calc_frame_mt(AV1_COMP *cpi);
 
 void av1_cdef_mt_dealloc(AV1CdefSync *cdef_sync);
 
+#if !CONFIG_REALTIME_ONLY
+struct RestSearchCtxt;
+
+void av1_lr_gather_stats_mt(AV1_COMP *cpi, struct RestSearchCtxt *rsc,
+                            int num_jobs, int num_workers);
+
+void av1_lr_search_mt_dealloc(AV1LrSearchSync *lr_search_sync);
+#endif  // !CONFIG_REALTIME_ONLY
+
 void av1_write_tile_obu_mt(
     AV1_COMP *const cpi, uint8_t *const dst, uint32_t *total_size,
     struct aom_write_bit_buffer *saved_wb, uint8_t obu_extn_header,
@@ -118,6 +132,12 @@ void av1_write_tile_obu_mt(
     unsigned int *max_tile_size, uint32_t *const obu_header_size,
     uint8_t **tile_data_start, const int num_workers);
 
+void av1_tile_prepack_launch(AV1_COMP *cpi);
+
+void av1_tile_prepack_sync(AV1_COMP *cpi);
+
+void av1_tile_prepack_dealloc(AV1EncTilePrepack *tile_prepack);
+
 int av1_compute_num_fp_contexts(AV1_PRIMARY *ppi, AV1EncoderConfig *oxcf);
 
 int av1_check_fpmt_config(AV1_PRIMARY *const ppi,
@@ -32,7 +32,10 @@ static void copy_and_extend_plane(const uint8_t *src, int src_pitch,
 
   for (i = 0; i < h; i++) {
     memset(dst_ptr1, src_ptr1[0], extend_left);
-    if (chroma_step == 1) {
+    if (src == dst) {
+      // Extending in place, the row is already there.
+      assert(chroma_step == 1 && src_pitch == dst_pitch);
+    } else if (chroma_step == 1) {
       memcpy(dst_ptr1 + extend_left, src_ptr1, w);
     } else {
       for (int j = 0; j < w; j++) {
@@ -82,7 +85,8 @@ static void highbd_copy_and_extend_plane(const uint8_t *src8, int src_pitch,
 
   for (i = 0; i < h; i++) {
     aom_memset16(dst_ptr1, src_ptr1[0], extend_left);
-    memcpy(dst_ptr1 + extend_left, src_ptr1, w * sizeof(src_ptr1[0]));
+    if (src != dst)
+      memcpy(dst_ptr1 + extend_left, src_ptr1, w * sizeof(src_ptr1[0]));
     aom_memset16(dst_ptr2, src_ptr2[0], extend_right);
     src_ptr1 += src_pitch;
     src_ptr2 += src_pitch;
@@ -161,3 +165,36 @@ void av1_copy_and_extend_frame(const YV12_BUFFER_CONFIG *src,
                           chroma_step);
   }
 }
+
+bool av1_extend_frame_in_place(YV12_BUFFER_CONFIG *frame, int border) {
+  // Nothing to extend into for the chroma of monochrome or NV12 frames, whose
+  // chroma planes are respectively absent and interleaved.
+  if (frame->monochrome || frame->u_buffer == NULL || frame->v_buffer == NULL)
+    return false;
+
+  // Extension applied by av1_copy_and_extend_frame() into a buffer with the
+  // given border.
+  const int ss_x = frame->subsampling_x;
+  const int ss_y = frame->subsampling_y;
+  const int er_y = AOMMAX(frame->y_width + border,
+                          ALIGN_POWER_OF_TWO(frame->y_width, 6)) -
+                   frame->y_crop_width;
+  const int eb_y = AOMMAX(frame->y_height + border,
+                          ALIGN_POWER_OF_TWO(frame->y_height, 6)) -
+                   frame->y_crop_height;
+
+  // Space available around the planes of the frame.
+  const int uv_border_x = frame->border >> ss_x;
+  const int uv_border_y = frame->border >> ss_y;
+  if (frame->border < border ||
+      frame->y_stride - frame->border - frame->y_crop_width < er_y ||
+      frame->border + frame->y_height - frame->y_crop_height < eb_y ||
+      frame->uv_stride - uv_border_x - frame->uv_crop_width < (er_y >> ss_x) ||
+      uv_border_y + frame->uv_height - frame->uv_crop_height < (eb_y >> ss_y))
+    return false;
+
+  YV12_BUFFER_CONFIG dst = *frame;
+  dst.border = border;
+  av1_copy_and_extend_frame(frame, &dst);
+  return true;
+}
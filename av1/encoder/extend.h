@@ -12,6 +12,8 @@
 #ifndef AOM_AV1_ENCODER_EXTEND_H_
 #define AOM_AV1_ENCODER_EXTEND_H_
 
+#include <stdbool.h>
+
 #include "aom_scale/yv12config.h"
 #include "aom/aom_integer.h"
 
@@ -22,6 +24,12 @@ extern "C" {
 void av1_copy_and_extend_frame(const YV12_BUFFER_CONFIG *src,
                                YV12_BUFFER_CONFIG *dst);
 
+// Extends the borders of 'frame' in place, by the same amounts as
+// av1_copy_and_extend_frame() extends a copy of 'frame' into a buffer with a
+// border of 'border' pixels. Returns false, leaving 'frame' untouched, if the
+// frame does not have enough room around its planes.
+bool av1_extend_frame_in_place(YV12_BUFFER_CONFIG *frame, int border);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
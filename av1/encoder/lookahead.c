@@ -30,12 +30,56 @@ static struct lookahead_entry *pop(struct lookahead_ctx *ctx, int *idx) {
   return buf;
 }
 
+/* Hand a lent image back to the application and restore the own buffer */
+static void release_lent_img(struct lookahead_entry *buf) {
+  if (buf->lent_img == NULL) return;
+  for (int plane = 0; plane < MAX_MB_PLANE; plane++)
+    buf->img.buffers[plane] = buf->own_buffers[plane];
+  buf->img.strides[0] = buf->own_strides[0];
+  buf->img.strides[1] = buf->own_strides[1];
+  buf->lending.release_cb(buf->lending.cb_priv, buf->lent_img);
+  buf->lent_img = NULL;
+}
+
+/* Use the planes of the lent source in place of the own buffer if possible */
+static bool use_lent_img(struct lookahead_entry *buf,
+                         const YV12_BUFFER_CONFIG *src,
+                         const aom_source_lending_t *lending,
+                         const aom_image_t *lent_img) {
+  // Motion search assumes all the source frames share the same strides.
+  if ((src->flags & YV12_FLAG_HIGHBITDEPTH) !=
+          (buf->img.flags & YV12_FLAG_HIGHBITDEPTH) ||
+      src->subsampling_x != buf->img.subsampling_x ||
+      src->subsampling_y != buf->img.subsampling_y ||
+      src->y_stride != buf->img.y_stride ||
+      src->uv_stride != buf->img.uv_stride)
+    return false;
+
+  YV12_BUFFER_CONFIG lent = *src;
+  if (!av1_extend_frame_in_place(&lent, buf->img.border)) return false;
+
+  for (int plane = 0; plane < MAX_MB_PLANE; plane++) {
+    buf->own_buffers[plane] = buf->img.buffers[plane];
+    buf->img.buffers[plane] = lent.buffers[plane];
+  }
+  buf->own_strides[0] = buf->img.strides[0];
+  buf->own_strides[1] = buf->img.strides[1];
+  buf->img.strides[0] = lent.strides[0];
+  buf->img.strides[1] = lent.strides[1];
+  buf->lent_img = lent_img;
+  buf->lending = *lending;
+  return true;
+}
+
 void av1_lookahead_destroy(struct lookahead_ctx *ctx) {
   if (ctx) {
     if (ctx->buf) {
       int i;
 
-      for (i = 0; i < ctx->max_sz; i++) aom_free_frame_buffer(&ctx->buf[i].img);
+      for (i = 0; i < ctx->max_sz; i++) {
+        release_lent_img(&ctx->buf[i]);
+        aom_free_frame_buffer(&ctx->buf[i].img);
+      }
       free(ctx->buf);
     }
     free(ctx);
@@ -100,7 +144,9 @@ int av1_lookahead_full(const struct lookahead_ctx *ctx) {
 
 int av1_lookahead_push(struct lookahead_ctx *ctx, const YV12_BUFFER_CONFIG *src,
                        int64_t ts_start, int64_t ts_end, int use_highbitdepth,
-                       bool alloc_pyramid, aom_enc_frame_flags_t flags) {
+                       bool alloc_pyramid, aom_enc_frame_flags_t flags,
+                       const aom_source_lending_t *lending,
+                       const aom_image_t *lent_img) {
   int width = src->y_crop_width;
   int height = src->y_crop_height;
   int uv_width = src->uv_crop_width;
@@ -110,8 +156,10 @@ int av1_lookahead_push(struct lookahead_ctx *ctx, const YV12_BUFFER_CONFIG *src,
   int larger_dimensions, new_dimensions;
 
   assert(ctx->read_ctxs[ENCODE_STAGE].valid == 1);
-  if (ctx->read_ctxs[ENCODE_STAGE].sz + ctx->max_pre_frames > ctx->max_sz)
+  if (ctx->read_ctxs[ENCODE_STAGE].sz + ctx->max_pre_frames > ctx->max_sz) {
+    if (lending) lending->release_cb(lending->cb_priv, lent_img);
     return 1;
+  }
 
   ctx->read_ctxs[ENCODE_STAGE].sz++;
   if (ctx->read_ctxs[LAP_STAGE].valid) {
@@ -119,6 +167,8 @@ int av1_lookahead_push(struct lookahead_ctx *ctx, const YV12_BUFFER_CONFIG *src,
   }
 
   struct lookahead_entry *buf = pop(ctx, &ctx->write_idx);
+  // The frame previously held in this slot is no longer used by the encoder.
+  release_lent_img(buf);
 
   new_dimensions = width != buf->img.y_crop_width ||
                    height != buf->img.y_crop_height ||
@@ -129,13 +179,19 @@ int av1_lookahead_push(struct lookahead_ctx *ctx, const YV12_BUFFER_CONFIG *src,
       uv_width > buf->img.uv_crop_width || uv_height > buf->img.uv_crop_height;
   assert(!larger_dimensions || new_dimensions);
 
-  if (larger_dimensions) {
+  if (lending && !new_dimensions &&
+      use_lent_img(buf, src, lending, lent_img)) {
+    // The lent source is used in place, it is released once it leaves the
+    // queue.
+  } else if (larger_dimensions) {
     YV12_BUFFER_CONFIG new_img;
     memset(&new_img, 0, sizeof(new_img));
     if (aom_alloc_frame_buffer(&new_img, width, height, subsampling_x,
                                subsampling_y, use_highbitdepth,
-                               AOM_BORDER_IN_PIXELS, 0, alloc_pyramid, 0))
+                               AOM_BORDER_IN_PIXELS, 0, alloc_pyramid, 0)) {
+      if (lending) lending->release_cb(lending->cb_priv, lent_img);
       return 1;
+    }
     aom_free_frame_buffer(&buf->img);
     buf->img = new_img;
   } else if (new_dimensions) {
@@ -150,7 +206,10 @@ int av1_lookahead_push(struct lookahead_ctx *ctx, const YV12_BUFFER_CONFIG *src,
     buf->img.subsampling_x = src->subsampling_x;
     buf->img.subsampling_y = src->subsampling_y;
   }
-  av1_copy_and_extend_frame(src, &buf->img);
+  if (buf->lent_img == NULL) {
+    av1_copy_and_extend_frame(src, &buf->img);
+    if (lending) lending->release_cb(lending->cb_priv, lent_img);
+  }
 
   buf->ts_start = ts_start;
   buf->ts_end = ts_end;
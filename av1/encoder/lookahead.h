@@ -19,6 +19,7 @@
 
 #include "aom_scale/yv12config.h"
 #include "aom/aom_integer.h"
+#include "aom/aomcx.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,6 +37,15 @@ struct lookahead_entry {
   int64_t ts_end;
   int display_idx;
   aom_enc_frame_flags_t flags;
+  // Application image whose planes img refers to, or NULL when img holds its
+  // own copy of the source.
+  const aom_image_t *lent_img;
+  // Release callback of lent_img.
+  aom_source_lending_t lending;
+  // Planes and strides of the buffer owned by img, while img refers to
+  // lent_img.
+  uint8_t *own_buffers[MAX_MB_PLANE];
+  int own_strides[2];
 };
 
 // The max of past frames we want to keep in the queue.
@@ -83,7 +93,10 @@ int av1_lookahead_full(const struct lookahead_ctx *ctx);
 /**\brief Enqueue a source buffer
  *
  * This function will copy the source image into a new framebuffer with
- * the expected stride/border.
+ * the expected stride/border, unless the source is lent by the application
+ * and its layout allows using it in place. A lent image is always released
+ * through its callback, either once it leaves the queue or before returning
+ * if it was copied or could not be enqueued.
  *
  * \param[in] ctx               Pointer to the lookahead context
  * \param[in] src               Pointer to the image to enqueue
@@ -93,10 +106,15 @@ int av1_lookahead_full(const struct lookahead_ctx *ctx);
  * \param[in] alloc_pyramid     Whether to allocate a downsampling pyramid
  *                              for each frame buffer
  * \param[in] flags             Flags set on this frame
+ * \param[in] lending           Release callback of lent_img, or NULL if the
+ *                              source is not lent
+ * \param[in] lent_img          Application image backing src
  */
 int av1_lookahead_push(struct lookahead_ctx *ctx, const YV12_BUFFER_CONFIG *src,
                        int64_t ts_start, int64_t ts_end, int use_highbitdepth,
-                       bool alloc_pyramid, aom_enc_frame_flags_t flags);
+                       bool alloc_pyramid, aom_enc_frame_flags_t flags,
+                       const aom_source_lending_t *lending,
+                       const aom_image_t *lent_img);
 
 /**\brief Get the next source buffer to encode
  *
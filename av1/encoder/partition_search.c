@@ -1778,7 +1778,8 @@ void av1_rd_use_partition(AV1_COMP *cpi, ThreadData *td, TileDataEnc *tile_data,
   x->try_merge_partition = 0;
 
   if (pc_tree->none == NULL) {
-    pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf);
+    pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf,
+                                  &td->pc_arena);
     if (!pc_tree->none)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PICK_MODE_CONTEXT");
@@ -1841,7 +1842,7 @@ void av1_rd_use_partition(AV1_COMP *cpi, ThreadData *td, TileDataEnc *tile_data,
   }
 
   for (int i = 0; i < SUB_PARTITIONS_SPLIT; ++i) {
-    pc_tree->split[i] = av1_alloc_pc_tree_node(subsize);
+    pc_tree->split[i] = av1_alloc_pc_tree_node(subsize, &td->pc_arena);
     if (!pc_tree->split[i])
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -1860,7 +1861,7 @@ void av1_rd_use_partition(AV1_COMP *cpi, ThreadData *td, TileDataEnc *tile_data,
 
       for (int i = 0; i < SUB_PARTITIONS_RECT; ++i) {
         pc_tree->horizontal[i] =
-            av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf);
+            av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf, &td->pc_arena);
         if (!pc_tree->horizontal[i])
           aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PICK_MODE_CONTEXT");
@@ -1896,7 +1897,7 @@ void av1_rd_use_partition(AV1_COMP *cpi, ThreadData *td, TileDataEnc *tile_data,
 
       for (int i = 0; i < SUB_PARTITIONS_RECT; ++i) {
         pc_tree->vertical[i] =
-            av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf);
+            av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf, &td->pc_arena);
         if (!pc_tree->vertical[i])
           aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PICK_MODE_CONTEXT");
@@ -1998,8 +1999,8 @@ void av1_rd_use_partition(AV1_COMP *cpi, ThreadData *td, TileDataEnc *tile_data,
       av1_save_context(x, &x_ctx, mi_row, mi_col, bsize, num_planes);
       pc_tree->split[i]->partitioning = PARTITION_NONE;
       if (pc_tree->split[i]->none == NULL)
-        pc_tree->split[i]->none =
-            av1_alloc_pmc(cpi, split_subsize, &td->shared_coeff_buf);
+        pc_tree->split[i]->none = av1_alloc_pmc(
+            cpi, split_subsize, &td->shared_coeff_buf, &td->pc_arena);
       if (!pc_tree->split[i]->none)
         aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate PICK_MODE_CONTEXT");
@@ -2434,7 +2435,8 @@ static int try_split_partition(AV1_COMP *const cpi, ThreadData *const td,
   pc_tree->partitioning = PARTITION_NONE;
   av1_set_offsets(cpi, tile_info, x, mi_row, mi_col, bsize);
   if (!pc_tree->none) {
-    pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf);
+    pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf,
+                                  &td->pc_arena);
     if (!pc_tree->none)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PICK_MODE_CONTEXT");
@@ -2457,7 +2459,7 @@ static int try_split_partition(AV1_COMP *const cpi, ThreadData *const td,
   }
   for (int i = 0; i < SUB_PARTITIONS_SPLIT; ++i) {
     if (!pc_tree->split[i]) {
-      pc_tree->split[i] = av1_alloc_pc_tree_node(subsize);
+      pc_tree->split[i] = av1_alloc_pc_tree_node(subsize, &td->pc_arena);
       if (!pc_tree->split[i])
         aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate PC_TREE");
@@ -2478,7 +2480,7 @@ static int try_split_partition(AV1_COMP *const cpi, ThreadData *const td,
         xd->left_txfm_context_buffer + ((mi_row + y_idx) & MAX_MIB_MASK);
     if (!pc_tree->split[i]->none) {
       pc_tree->split[i]->none =
-          av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf);
+          av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf, &td->pc_arena);
       if (!pc_tree->split[i]->none)
         aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate PICK_MODE_CONTEXT");
@@ -2615,7 +2617,8 @@ static void try_merge(AV1_COMP *const cpi, ThreadData *td,
       xd->left_txfm_context_buffer + (mi_row & MAX_MIB_MASK);
   pc_tree->partitioning = PARTITION_NONE;
   if (!pc_tree->none) {
-    pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf);
+    pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf,
+                                  &td->pc_arena);
     if (!pc_tree->none)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PICK_MODE_CONTEXT");
@@ -2649,7 +2652,7 @@ static void try_merge(AV1_COMP *const cpi, ThreadData *td,
             xd->left_txfm_context_buffer + ((mi_row + y_idx) & MAX_MIB_MASK);
         if (!pc_tree->split[i]->none) {
           pc_tree->split[i]->none =
-              av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf);
+              av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf, &td->pc_arena);
           if (!pc_tree->split[i]->none)
             aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                                "Failed to allocate PICK_MODE_CONTEXT");
@@ -2712,7 +2715,7 @@ static void try_merge(AV1_COMP *const cpi, ThreadData *td,
       // condition.
       if (!pc_tree->split[i]->none) {
         pc_tree->split[i]->none =
-            av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf);
+            av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf, &td->pc_arena);
         if (!pc_tree->split[i]->none)
           aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PICK_MODE_CONTEXT");
@@ -3002,7 +3005,8 @@ void av1_nonrd_use_partition(AV1_COMP *cpi, ThreadData *td,
   switch (partition) {
     case PARTITION_NONE:
       if (!pc_tree->none) {
-        pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf);
+        pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf,
+                                      &td->pc_arena);
         if (!pc_tree->none)
           aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PICK_MODE_CONTEXT");
@@ -3018,7 +3022,7 @@ void av1_nonrd_use_partition(AV1_COMP *cpi, ThreadData *td,
       for (int i = 0; i < SUB_PARTITIONS_RECT; ++i) {
         if (!pc_tree->vertical[i]) {
           pc_tree->vertical[i] =
-              av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf);
+              av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf, &td->pc_arena);
           if (!pc_tree->vertical[i])
             aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                                "Failed to allocate PICK_MODE_CONTEXT");
@@ -3041,7 +3045,7 @@ void av1_nonrd_use_partition(AV1_COMP *cpi, ThreadData *td,
       for (int i = 0; i < SUB_PARTITIONS_RECT; ++i) {
         if (!pc_tree->horizontal[i]) {
           pc_tree->horizontal[i] =
-              av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf);
+              av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf, &td->pc_arena);
           if (!pc_tree->horizontal[i])
             aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                                "Failed to allocate PICK_MODE_CONTEXT");
@@ -3064,7 +3068,7 @@ void av1_nonrd_use_partition(AV1_COMP *cpi, ThreadData *td,
     case PARTITION_SPLIT:
       for (int i = 0; i < SUB_PARTITIONS_SPLIT; ++i) {
         if (!pc_tree->split[i]) {
-          pc_tree->split[i] = av1_alloc_pc_tree_node(subsize);
+          pc_tree->split[i] = av1_alloc_pc_tree_node(subsize, &td->pc_arena);
           if (!pc_tree->split[i])
             aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                                "Failed to allocate PC_TREE");
@@ -3562,8 +3566,8 @@ static void rectangular_partition_search(
     av1_init_rd_stats(sum_rdc);
     for (int j = 0; j < SUB_PARTITIONS_RECT; j++) {
       if (cur_ctx[i][j][0] == NULL) {
-        cur_ctx[i][j][0] =
-            av1_alloc_pmc(cpi, blk_params.subsize, &td->shared_coeff_buf);
+        cur_ctx[i][j][0] = av1_alloc_pmc(cpi, blk_params.subsize,
+                                         &td->shared_coeff_buf, &td->pc_arena);
         if (!cur_ctx[i][j][0])
           aom_internal_error(x->e_mbd.error_info, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PICK_MODE_CONTEXT");
@@ -3830,8 +3834,9 @@ static void ab_partitions_search(
     blk_params.subsize = get_partition_subsize(bsize, part_type);
     for (int i = 0; i < SUB_PARTITIONS_AB; i++) {
       // Set AB partition context.
-      cur_part_ctxs[ab_part_type][i] = av1_alloc_pmc(
-          cpi, ab_subsize[ab_part_type][i], &td->shared_coeff_buf);
+      cur_part_ctxs[ab_part_type][i] =
+          av1_alloc_pmc(cpi, ab_subsize[ab_part_type][i], &td->shared_coeff_buf,
+                        &td->pc_arena);
       if (!cur_part_ctxs[ab_part_type][i])
         aom_internal_error(x->e_mbd.error_info, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate PICK_MODE_CONTEXT");
@@ -3895,7 +3900,8 @@ static void set_4_part_ctx_and_rdcost(
   part_search_state->sum_rdc.rdcost =
       RDCOST(x->rdmult, part_search_state->sum_rdc.rate, 0);
   for (PART4_TYPES i = 0; i < SUB_PARTITIONS_PART4; ++i) {
-    cur_part_ctx[i] = av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf);
+    cur_part_ctx[i] = av1_alloc_pmc(cpi, subsize, &td->shared_coeff_buf,
+                                    &td->pc_arena);
     if (!cur_part_ctx[i])
       aom_internal_error(x->e_mbd.error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PICK_MODE_CONTEXT");
@@ -4128,7 +4134,8 @@ static void set_none_partition_params(const AV1_COMP *const cpi, ThreadData *td,
   RD_STATS partition_rdcost;
   // Set PARTITION_NONE context.
   if (pc_tree->none == NULL)
-    pc_tree->none = av1_alloc_pmc(cpi, blk_params.bsize, &td->shared_coeff_buf);
+    pc_tree->none = av1_alloc_pmc(cpi, blk_params.bsize, &td->shared_coeff_buf,
+                                  &td->pc_arena);
   if (!pc_tree->none)
     aom_internal_error(x->e_mbd.error_info, AOM_CODEC_MEM_ERROR,
                        "Failed to allocate PICK_MODE_CONTEXT");
@@ -4423,7 +4430,7 @@ static void split_partition_search(
 
   for (int i = 0; i < SUB_PARTITIONS_SPLIT; ++i) {
     if (pc_tree->split[i] == NULL)
-      pc_tree->split[i] = av1_alloc_pc_tree_node(subsize);
+      pc_tree->split[i] = av1_alloc_pc_tree_node(subsize, &td->pc_arena);
     if (!pc_tree->split[i])
       aom_internal_error(x->e_mbd.error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -4702,7 +4709,7 @@ static int read_partition_tree(AV1_COMP *const cpi, PC_TREE *const pc_tree,
       const BLOCK_SIZE subsize = get_partition_subsize(bsize, PARTITION_SPLIT);
       for (int i = 0; i < 4; ++i) {
         if (node != NULL) {  // Suppress warning
-          node->split[i] = av1_alloc_pc_tree_node(subsize);
+          node->split[i] = av1_alloc_pc_tree_node(subsize, node->arena);
           if (!node->split[i])
             aom_internal_error(error_info, AOM_CODEC_MEM_ERROR,
                                "Failed to allocate PC_TREE");
@@ -4890,7 +4897,7 @@ static void build_pc_tree_from_part_decision(
       const BLOCK_SIZE subsize = get_partition_subsize(bsize, PARTITION_SPLIT);
       for (int i = 0; i < 4; ++i) {
         if (node != NULL) {  // Suppress warning
-          node->split[i] = av1_alloc_pc_tree_node(subsize);
+          node->split[i] = av1_alloc_pc_tree_node(subsize, node->arena);
           if (!node->split[i])
             aom_internal_error(error_info, AOM_CODEC_MEM_ERROR,
                                "Failed to allocate PC_TREE");
@@ -4936,7 +4943,7 @@ static bool ml_partition_search_whole_tree(AV1_COMP *const cpi, ThreadData *td,
     // First, let's take the easy approach.
     // We require that the ml model has to provide partition decisions for the
     // whole superblock.
-    td->pc_root = av1_alloc_pc_tree_node(bsize);
+    td->pc_root = av1_alloc_pc_tree_node(bsize, &td->pc_arena);
     if (!td->pc_root)
       aom_internal_error(error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -5191,7 +5198,7 @@ static bool recursive_partition(AV1_COMP *const cpi, ThreadData *td,
       for (int i = 0; i < SUB_PARTITIONS_SPLIT; ++i) {
         av1_init_rd_stats(&split_rdc[i]);
         if (pc_tree->split[i] == NULL)
-          pc_tree->split[i] = av1_alloc_pc_tree_node(subsize);
+          pc_tree->split[i] = av1_alloc_pc_tree_node(subsize, &td->pc_arena);
         if (!pc_tree->split[i])
           aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                              "Failed to allocate PC_TREE");
@@ -5267,7 +5274,7 @@ static bool ml_partition_search_partial(AV1_COMP *const cpi, ThreadData *td,
   features.frame_height = cpi->frame_info.frame_height;
   features.block_size = bsize;
   av1_ext_part_send_features(ext_part_controller, &features);
-  td->pc_root = av1_alloc_pc_tree_node(bsize);
+  td->pc_root = av1_alloc_pc_tree_node(bsize, &td->pc_arena);
   if (!td->pc_root)
     aom_internal_error(x->e_mbd.error_info, AOM_CODEC_MEM_ERROR,
                        "Failed to allocate PC_TREE");
@@ -5326,7 +5333,7 @@ bool av1_rd_partition_search(AV1_COMP *const cpi, ThreadData *td,
   int num_configs;
   int i = 0;
   do {
-    td->pc_root = av1_alloc_pc_tree_node(bsize);
+    td->pc_root = av1_alloc_pc_tree_node(bsize, &td->pc_arena);
     if (!td->pc_root)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PC_TREE");
@@ -5361,7 +5368,7 @@ bool av1_rd_partition_search(AV1_COMP *const cpi, ThreadData *td,
   aom_free(x->rdcost);
   x->rdcost = NULL;
   // Encode with the partition configuration with the smallest rdcost.
-  td->pc_root = av1_alloc_pc_tree_node(bsize);
+  td->pc_root = av1_alloc_pc_tree_node(bsize, &td->pc_arena);
   if (!td->pc_root)
     aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                        "Failed to allocate PC_TREE");
@@ -6170,7 +6177,8 @@ void av1_nonrd_pick_partition(AV1_COMP *cpi, ThreadData *td,
 
   // PARTITION_NONE
   if (partition_none_allowed) {
-    pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf);
+    pc_tree->none = av1_alloc_pmc(cpi, bsize, &td->shared_coeff_buf,
+                                  &td->pc_arena);
     if (!pc_tree->none)
       aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                          "Failed to allocate PICK_MODE_CONTEXT");
@@ -6206,7 +6214,7 @@ void av1_nonrd_pick_partition(AV1_COMP *cpi, ThreadData *td,
     av1_init_rd_stats(&sum_rdc);
 
     for (int i = 0; i < SUB_PARTITIONS_SPLIT; ++i) {
-      pc_tree->split[i] = av1_alloc_pc_tree_node(subsize);
+      pc_tree->split[i] = av1_alloc_pc_tree_node(subsize, &td->pc_arena);
       if (!pc_tree->split[i])
         aom_internal_error(xd->error_info, AOM_CODEC_MEM_ERROR,
                            "Failed to allocate PC_TREE");
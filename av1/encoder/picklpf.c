@@ -25,6 +25,7 @@
 
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/picklpf.h"
 
 // AV1 loop filter applies to the whole frame according to mi_rows and mi_cols,
@@ -86,6 +87,8 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
   // lpf_opt_level = 1 : Enables dual/quad loop-filtering.
   int lpf_opt_level = is_inter_tx_size_search_level_one(&cpi->sf.tx_sf);
 
+  // The loop filter launches the workers directly.
+  av1_enc_scheduler_stop(mt_info);
   av1_loop_filter_frame_mt(&cm->cur_frame->buf, cm, &cpi->td.mb.e_mbd, plane,
                            plane + 1, partial_frame, mt_info->workers,
                            num_workers, &mt_info->lf_row_sync, lpf_opt_level);
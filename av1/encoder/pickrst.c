@@ -29,6 +29,7 @@
 
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/encoder.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/picklpf.h"
 #include "av1/encoder/pickrst.h"
 
@@ -41,6 +42,11 @@
 // Working precision for Wiener filter coefficients
 #define WIENER_TAP_SCALE_FACTOR ((int64_t)1 << 16)
 
+// Size, in int16_t elements, of the dgd-avg plus src-avg buffers used by one
+// thread during the SIMD calls of av1_compute_stats
+#define LR_AVG_BUF_SIZE \
+  (6 * RESTORATION_UNITSIZE_MAX * RESTORATION_UNITSIZE_MAX)
+
 #define SGRPROJ_EP_GRP1_START_IDX 0
 #define SGRPROJ_EP_GRP1_END_IDX 9
 #define SGRPROJ_EP_GRP1_SEARCH_COUNT 4
@@ -104,7 +110,7 @@ static uint64_t var_restoration_unit(const RestorationTileLimits *limits,
       limits->v_end - limits->v_start);
 }
 
-typedef struct {
+typedef struct RestSearchCtxt {
   const YV12_BUFFER_CONFIG *src;
   YV12_BUFFER_CONFIG *dst;
 
@@ -117,6 +123,7 @@ typedef struct {
 
   // Speed features
   const LOOP_FILTER_SPEED_FEATURES *lpf_sf;
+  const bool *disable_lr_filter;
 
   uint8_t *dgd_buffer;
   int dgd_stride;
@@ -150,10 +157,18 @@ typedef struct {
   WienerInfo switchable_ref_wiener;
   SgrprojInfo switchable_ref_sgrproj;
 
-  // Buffers used to hold dgd-avg and src-avg data respectively during SIMD
-  // call of Wiener filter.
+  // Buffers used to hold dgd-avg and src-avg data during SIMD call of Wiener
+  // filter, LR_AVG_BUF_SIZE elements per thread. NULL if not needed.
   int16_t *dgd_avg;
-  int16_t *src_avg;
+
+  // Restoration filter scratch buffers for threads other than the first one,
+  // which uses cm->rst_tmpbuf.
+  int32_t *tmpbuf;
+
+  // Which (row, column) parity class of restoration units is being gathered
+  // by av1_lr_gather_unit_stats(). Bit 1 is the row parity, bit 0 the column
+  // parity.
+  int gather_phase;
 } RestSearchCtxt;
 
 static inline void rsc_on_tile(void *priv) {
@@ -171,7 +186,8 @@ static inline void reset_rsc(RestSearchCtxt *rsc) {
 
 static inline void init_rsc(const YV12_BUFFER_CONFIG *src, const AV1_COMMON *cm,
                             const MACROBLOCK *x,
-                            const LOOP_FILTER_SPEED_FEATURES *lpf_sf, int plane,
+                            const LOOP_FILTER_SPEED_FEATURES *lpf_sf,
+                            const bool *disable_lr_filter, int plane,
                             RestUnitSearchInfo *rusi, YV12_BUFFER_CONFIG *dst,
                             RestSearchCtxt *rsc) {
   rsc->src = src;
@@ -181,6 +197,7 @@ static inline void init_rsc(const YV12_BUFFER_CONFIG *src, const AV1_COMMON *cm,
   rsc->plane = plane;
   rsc->rusi = rusi;
   rsc->lpf_sf = lpf_sf;
+  rsc->disable_lr_filter = disable_lr_filter;
 
   const YV12_BUFFER_CONFIG *dgd = &cm->cur_frame->buf;
   const int is_uv = plane != AOM_PLANE_Y;
@@ -199,9 +216,10 @@ static inline void init_rsc(const YV12_BUFFER_CONFIG *src, const AV1_COMMON *cm,
   rsc->dgd_stride = dgd->strides[is_uv];
 }
 
-static int64_t try_restoration_unit(const RestSearchCtxt *rsc,
-                                    const RestorationTileLimits *limits,
-                                    const RestorationUnitInfo *rui) {
+static int64_t try_restoration_unit(
+    const RestSearchCtxt *rsc, const RestorationTileLimits *limits,
+    const RestorationUnitInfo *rui, int32_t *tmpbuf,
+    struct aom_internal_error_info *error_info) {
   const AV1_COMMON *const cm = rsc->cm;
   const int plane = rsc->plane;
   const int is_uv = plane > 0;
@@ -220,7 +238,7 @@ static int64_t try_restoration_unit(const RestSearchCtxt *rsc,
       is_uv && cm->seq_params->subsampling_x,
       is_uv && cm->seq_params->subsampling_y, highbd, bit_depth,
       fts->buffers[plane], fts->strides[is_uv], rsc->dst->buffers[plane],
-      rsc->dst->strides[is_uv], cm->rst_tmpbuf, optimized_lr, cm->error);
+      rsc->dst->strides[is_uv], tmpbuf, optimized_lr, error_info);
 
   return sse_restoration_unit(limits, rsc->src, rsc->dst, plane, highbd);
 }
@@ -891,29 +909,16 @@ static int count_sgrproj_bits(SgrprojInfo *sgrproj_info,
   return bits;
 }
 
-static inline void search_sgrproj(const RestorationTileLimits *limits,
-                                  int rest_unit_idx, void *priv,
-                                  int32_t *tmpbuf, RestorationLineBuffers *rlbs,
-                                  struct aom_internal_error_info *error_info) {
-  (void)rlbs;
-  RestSearchCtxt *rsc = (RestSearchCtxt *)priv;
-  RestUnitSearchInfo *rusi = &rsc->rusi[rest_unit_idx];
-
-  const MACROBLOCK *const x = rsc->x;
+// Runs the self-guided search for one restoration unit and records the
+// resulting parameters and distortion in 'rusi'.
+static void gather_sgrproj_stats(const RestSearchCtxt *rsc,
+                                 const RestorationTileLimits *limits,
+                                 RestUnitSearchInfo *rusi, int32_t *tmpbuf,
+                                 struct aom_internal_error_info *error_info) {
   const AV1_COMMON *const cm = rsc->cm;
   const int highbd = cm->seq_params->use_highbitdepth;
   const int bit_depth = cm->seq_params->bit_depth;
 
-  const int64_t bits_none = x->mode_costs.sgrproj_restore_cost[0];
-  // Prune evaluation of RESTORE_SGRPROJ if 'skip_sgr_eval' is set
-  if (rsc->skip_sgr_eval) {
-    rsc->total_bits[RESTORE_SGRPROJ] += bits_none;
-    rsc->total_sse[RESTORE_SGRPROJ] += rsc->sse[RESTORE_NONE];
-    rusi->best_rtype[RESTORE_SGRPROJ - 1] = RESTORE_NONE;
-    rsc->sse[RESTORE_SGRPROJ] = INT64_MAX;
-    return;
-  }
-
   uint8_t *dgd_start =
       rsc->dgd_buffer + limits->v_start * rsc->dgd_stride + limits->h_start;
   const uint8_t *src_start =
@@ -935,7 +940,39 @@ static inline void search_sgrproj(const RestorationTileLimits *limits,
   rui.restoration_type = RESTORE_SGRPROJ;
   rui.sgrproj_info = rusi->sgrproj;
 
-  rsc->sse[RESTORE_SGRPROJ] = try_restoration_unit(rsc, limits, &rui);
+  rusi->sse[RESTORE_SGRPROJ] =
+      try_restoration_unit(rsc, limits, &rui, tmpbuf, error_info);
+  rusi->sgrproj_searched = true;
+}
+
+static inline void search_sgrproj(const RestorationTileLimits *limits,
+                                  int rest_unit_idx, void *priv,
+                                  int32_t *tmpbuf, RestorationLineBuffers *rlbs,
+                                  struct aom_internal_error_info *error_info) {
+  (void)rlbs;
+  RestSearchCtxt *rsc = (RestSearchCtxt *)priv;
+  RestUnitSearchInfo *rusi = &rsc->rusi[rest_unit_idx];
+
+  const MACROBLOCK *const x = rsc->x;
+  const AV1_COMMON *const cm = rsc->cm;
+  const int bit_depth = cm->seq_params->bit_depth;
+
+  const int64_t bits_none = x->mode_costs.sgrproj_restore_cost[0];
+  // Prune evaluation of RESTORE_SGRPROJ if 'skip_sgr_eval' is set
+  if (rsc->skip_sgr_eval) {
+    rsc->total_bits[RESTORE_SGRPROJ] += bits_none;
+    rsc->total_sse[RESTORE_SGRPROJ] += rsc->sse[RESTORE_NONE];
+    rusi->best_rtype[RESTORE_SGRPROJ - 1] = RESTORE_NONE;
+    rsc->sse[RESTORE_SGRPROJ] = INT64_MAX;
+    return;
+  }
+
+  // The search is normally done by av1_lr_gather_unit_stats(), unless whether
+  // to run it depended on the coding-order Wiener decision.
+  if (!rusi->sgrproj_searched)
+    gather_sgrproj_stats(rsc, limits, rusi, tmpbuf, error_info);
+
+  rsc->sse[RESTORE_SGRPROJ] = rusi->sse[RESTORE_SGRPROJ];
 
   const int64_t bits_sgr =
       x->mode_costs.sgrproj_restore_cost[1] +
@@ -1492,9 +1529,11 @@ static int count_wiener_bits(int wiener_win, WienerInfo *wiener_info,
 
 static int64_t finer_search_wiener(const RestSearchCtxt *rsc,
                                    const RestorationTileLimits *limits,
-                                   RestorationUnitInfo *rui, int wiener_win) {
+                                   RestorationUnitInfo *rui, int wiener_win,
+                                   int32_t *tmpbuf,
+                                   struct aom_internal_error_info *error_info) {
   const int plane_off = (WIENER_WIN - wiener_win) >> 1;
-  int64_t err = try_restoration_unit(rsc, limits, rui);
+  int64_t err = try_restoration_unit(rsc, limits, rui, tmpbuf, error_info);
 
   if (rsc->lpf_sf->disable_wiener_coeff_refine_search) return err;
 
@@ -1517,7 +1556,7 @@ static int64_t finer_search_wiener(const RestSearchCtxt *rsc,
           plane_wiener->hfilter[p] -= s;
           plane_wiener->hfilter[WIENER_WIN - p - 1] -= s;
           plane_wiener->hfilter[WIENER_HALFWIN] += 2 * s;
-          err2 = try_restoration_unit(rsc, limits, rui);
+          err2 = try_restoration_unit(rsc, limits, rui, tmpbuf, error_info);
           if (err2 > err) {
             plane_wiener->hfilter[p] += s;
             plane_wiener->hfilter[WIENER_WIN - p - 1] += s;
@@ -1537,7 +1576,7 @@ static int64_t finer_search_wiener(const RestSearchCtxt *rsc,
           plane_wiener->hfilter[p] += s;
           plane_wiener->hfilter[WIENER_WIN - p - 1] += s;
           plane_wiener->hfilter[WIENER_HALFWIN] -= 2 * s;
-          err2 = try_restoration_unit(rsc, limits, rui);
+          err2 = try_restoration_unit(rsc, limits, rui, tmpbuf, error_info);
           if (err2 > err) {
             plane_wiener->hfilter[p] -= s;
             plane_wiener->hfilter[WIENER_WIN - p - 1] -= s;
@@ -1558,7 +1597,7 @@ static int64_t finer_search_wiener(const RestSearchCtxt *rsc,
           plane_wiener->vfilter[p] -= s;
           plane_wiener->vfilter[WIENER_WIN - p - 1] -= s;
           plane_wiener->vfilter[WIENER_HALFWIN] += 2 * s;
-          err2 = try_restoration_unit(rsc, limits, rui);
+          err2 = try_restoration_unit(rsc, limits, rui, tmpbuf, error_info);
           if (err2 > err) {
             plane_wiener->vfilter[p] += s;
             plane_wiener->vfilter[WIENER_WIN - p - 1] += s;
@@ -1578,7 +1617,7 @@ static int64_t finer_search_wiener(const RestSearchCtxt *rsc,
           plane_wiener->vfilter[p] += s;
           plane_wiener->vfilter[WIENER_WIN - p - 1] += s;
           plane_wiener->vfilter[WIENER_HALFWIN] -= 2 * s;
-          err2 = try_restoration_unit(rsc, limits, rui);
+          err2 = try_restoration_unit(rsc, limits, rui, tmpbuf, error_info);
           if (err2 > err) {
             plane_wiener->vfilter[p] -= s;
             plane_wiener->vfilter[WIENER_WIN - p - 1] -= s;
@@ -1597,19 +1636,14 @@ static int64_t finer_search_wiener(const RestSearchCtxt *rsc,
   return err;
 }
 
-static inline void search_wiener(const RestorationTileLimits *limits,
-                                 int rest_unit_idx, void *priv, int32_t *tmpbuf,
-                                 RestorationLineBuffers *rlbs,
-                                 struct aom_internal_error_info *error_info) {
-  (void)tmpbuf;
-  (void)rlbs;
-  (void)error_info;
-  RestSearchCtxt *rsc = (RestSearchCtxt *)priv;
-  RestUnitSearchInfo *rusi = &rsc->rusi[rest_unit_idx];
-
-  const MACROBLOCK *const x = rsc->x;
-  const int64_t bits_none = x->mode_costs.wiener_restore_cost[0];
-
+// Runs the Wiener search for one restoration unit and records the resulting
+// filter and distortion in 'rusi'. rusi->sse[RESTORE_WIENER] is left at
+// INT64_MAX if the search is pruned or finds no gain over RESTORE_NONE.
+static void gather_wiener_stats(const RestSearchCtxt *rsc,
+                                const RestorationTileLimits *limits,
+                                RestUnitSearchInfo *rusi, int32_t *tmpbuf,
+                                int16_t *dgd_avg, int16_t *src_avg,
+                                struct aom_internal_error_info *error_info) {
   // Skip Wiener search for low variance contents
   if (rsc->lpf_sf->prune_wiener_based_on_src_var) {
     const int scale[3] = { 0, 1, 2 };
@@ -1625,15 +1659,8 @@ static inline void search_wiener(const RestorationTileLimits *limits,
         var_restoration_unit(limits, rsc->src, rsc->plane, highbd);
     // Do not perform Wiener search if source variance is lower than threshold
     // or if the reconstruction error is zero
-    int prune_wiener = (src_var < thresh) || (rsc->sse[RESTORE_NONE] == 0);
-    if (prune_wiener) {
-      rsc->total_bits[RESTORE_WIENER] += bits_none;
-      rsc->total_sse[RESTORE_WIENER] += rsc->sse[RESTORE_NONE];
-      rusi->best_rtype[RESTORE_WIENER - 1] = RESTORE_NONE;
-      rsc->sse[RESTORE_WIENER] = INT64_MAX;
-      if (rsc->lpf_sf->prune_sgr_based_on_wiener == 2) rsc->skip_sgr_eval = 1;
-      return;
-    }
+    int prune_wiener = (src_var < thresh) || (rusi->sse[RESTORE_NONE] == 0);
+    if (prune_wiener) return;
   }
 
   const int wiener_win =
@@ -1656,20 +1683,20 @@ static inline void search_wiener(const RestorationTileLimits *limits,
     // functions. Optimize intrinsics of HBD design similar to LBD (i.e.,
     // pre-calculate d and s buffers and avoid most of the C operations).
     av1_compute_stats_highbd(reduced_wiener_win, rsc->dgd_buffer,
-                             rsc->src_buffer, rsc->dgd_avg, rsc->src_avg,
+                             rsc->src_buffer, dgd_avg, src_avg,
                              limits->h_start, limits->h_end, limits->v_start,
                              limits->v_end, rsc->dgd_stride, rsc->src_stride, M,
                              H, cm->seq_params->bit_depth);
   } else {
     av1_compute_stats(reduced_wiener_win, rsc->dgd_buffer, rsc->src_buffer,
-                      rsc->dgd_avg, rsc->src_avg, limits->h_start,
-                      limits->h_end, limits->v_start, limits->v_end,
-                      rsc->dgd_stride, rsc->src_stride, M, H,
+                      dgd_avg, src_avg, limits->h_start, limits->h_end,
+                      limits->v_start, limits->v_end, rsc->dgd_stride,
+                      rsc->src_stride, M, H,
                       rsc->lpf_sf->use_downsampled_wiener_stats);
   }
 #else
   av1_compute_stats(reduced_wiener_win, rsc->dgd_buffer, rsc->src_buffer,
-                    rsc->dgd_avg, rsc->src_avg, limits->h_start, limits->h_end,
+                    dgd_avg, src_avg, limits->h_start, limits->h_end,
                     limits->v_start, limits->v_end, rsc->dgd_stride,
                     rsc->src_stride, M, H,
                     rsc->lpf_sf->use_downsampled_wiener_stats);
@@ -1688,16 +1715,11 @@ static inline void search_wiener(const RestorationTileLimits *limits,
   // reduction in the function, the filter is reverted back to identity
   if (compute_score(reduced_wiener_win, M, H, rui.wiener_info.vfilter,
                     rui.wiener_info.hfilter) > 0) {
-    rsc->total_bits[RESTORE_WIENER] += bits_none;
-    rsc->total_sse[RESTORE_WIENER] += rsc->sse[RESTORE_NONE];
-    rusi->best_rtype[RESTORE_WIENER - 1] = RESTORE_NONE;
-    rsc->sse[RESTORE_WIENER] = INT64_MAX;
-    if (rsc->lpf_sf->prune_sgr_based_on_wiener == 2) rsc->skip_sgr_eval = 1;
     return;
   }
 
-  rsc->sse[RESTORE_WIENER] =
-      finer_search_wiener(rsc, limits, &rui, reduced_wiener_win);
+  rusi->sse[RESTORE_WIENER] = finer_search_wiener(
+      rsc, limits, &rui, reduced_wiener_win, tmpbuf, error_info);
   rusi->wiener = rui.wiener_info;
 
   if (reduced_wiener_win != WIENER_WIN) {
@@ -1706,6 +1728,34 @@ static inline void search_wiener(const RestorationTileLimits *limits,
     assert(rui.wiener_info.hfilter[0] == 0 &&
            rui.wiener_info.hfilter[WIENER_WIN - 1] == 0);
   }
+}
+
+static inline void search_wiener(const RestorationTileLimits *limits,
+                                 int rest_unit_idx, void *priv, int32_t *tmpbuf,
+                                 RestorationLineBuffers *rlbs,
+                                 struct aom_internal_error_info *error_info) {
+  (void)limits;
+  (void)tmpbuf;
+  (void)rlbs;
+  (void)error_info;
+  RestSearchCtxt *rsc = (RestSearchCtxt *)priv;
+  RestUnitSearchInfo *rusi = &rsc->rusi[rest_unit_idx];
+
+  const MACROBLOCK *const x = rsc->x;
+  const int64_t bits_none = x->mode_costs.wiener_restore_cost[0];
+
+  rsc->sse[RESTORE_WIENER] = rusi->sse[RESTORE_WIENER];
+  // The Wiener search was pruned or its filter was reverted to identity
+  if (rsc->sse[RESTORE_WIENER] == INT64_MAX) {
+    rsc->total_bits[RESTORE_WIENER] += bits_none;
+    rsc->total_sse[RESTORE_WIENER] += rsc->sse[RESTORE_NONE];
+    rusi->best_rtype[RESTORE_WIENER - 1] = RESTORE_NONE;
+    if (rsc->lpf_sf->prune_sgr_based_on_wiener == 2) rsc->skip_sgr_eval = 1;
+    return;
+  }
+
+  const int wiener_win =
+      (rsc->plane == AOM_PLANE_Y) ? WIENER_WIN : WIENER_WIN_CHROMA;
 
   const int64_t bits_wiener =
       x->mode_costs.wiener_restore_cost[1] +
@@ -1747,16 +1797,14 @@ static inline void search_norestore(
     const RestorationTileLimits *limits, int rest_unit_idx, void *priv,
     int32_t *tmpbuf, RestorationLineBuffers *rlbs,
     struct aom_internal_error_info *error_info) {
-  (void)rest_unit_idx;
+  (void)limits;
   (void)tmpbuf;
   (void)rlbs;
   (void)error_info;
 
   RestSearchCtxt *rsc = (RestSearchCtxt *)priv;
 
-  const int highbd = rsc->cm->seq_params->use_highbitdepth;
-  rsc->sse[RESTORE_NONE] = sse_restoration_unit(
-      limits, rsc->src, &rsc->cm->cur_frame->buf, rsc->plane, highbd);
+  rsc->sse[RESTORE_NONE] = rsc->rusi[rest_unit_idx].sse[RESTORE_NONE];
 
   rsc->total_sse[RESTORE_NONE] += rsc->sse[RESTORE_NONE];
 }
@@ -1852,19 +1900,123 @@ static inline void copy_unit_info(RestorationType frame_rtype,
     rui->sgrproj_info = rusi->sgrproj;
 }
 
+// Computes the pixel limits of the restoration unit at (rrow, rcol).
+static inline void get_rest_unit_limits(const RestSearchCtxt *rsc, int rrow,
+                                        int rcol,
+                                        RestorationTileLimits *limits) {
+  const AV1_COMMON *const cm = rsc->cm;
+  const int is_uv = rsc->plane > 0;
+  const int ss_y = is_uv && cm->seq_params->subsampling_y;
+  const int ru_size = cm->rst_info[rsc->plane].restoration_unit_size;
+  const int ext_size = ru_size * 3 / 2;
+
+  int y0 = rrow * ru_size;
+  int remaining_h = rsc->plane_h - y0;
+  int h = (remaining_h < ext_size) ? remaining_h : ru_size;
+
+  limits->v_start = y0;
+  limits->v_end = y0 + h;
+  assert(limits->v_end <= rsc->plane_h);
+  // Offset upwards to align with the restoration processing stripe
+  const int voffset = RESTORATION_UNIT_OFFSET >> ss_y;
+  limits->v_start = AOMMAX(0, limits->v_start - voffset);
+  if (limits->v_end < rsc->plane_h) limits->v_end -= voffset;
+
+  int x0 = rcol * ru_size;
+  int remaining_w = rsc->plane_w - x0;
+  int w = (remaining_w < ext_size) ? remaining_w : ru_size;
+
+  limits->h_start = x0;
+  limits->h_end = x0 + w;
+  assert(limits->h_end <= rsc->plane_w);
+}
+
+// Returns the number of restoration units of the plane in the given gather
+// phase, and their number of columns in 'phase_cols'.
+static inline int get_phase_num_units(const RestorationInfo *rsi, int phase,
+                                      int *phase_cols) {
+  const int phase_rows = (rsi->vert_units - (phase >> 1) + 1) >> 1;
+  *phase_cols = (rsi->horz_units - (phase & 1) + 1) >> 1;
+  return phase_rows * *phase_cols;
+}
+
+void av1_lr_gather_unit_stats(RestSearchCtxt *rsc, int job_idx, int thread_id,
+                              struct aom_internal_error_info *error_info) {
+  const RestorationInfo *rsi = &rsc->cm->rst_info[rsc->plane];
+  const int phase = rsc->gather_phase;
+  int phase_cols;
+  get_phase_num_units(rsi, phase, &phase_cols);
+  const int rrow = (phase >> 1) + 2 * (job_idx / phase_cols);
+  const int rcol = (phase & 1) + 2 * (job_idx % phase_cols);
+
+  RestorationTileLimits limits;
+  get_rest_unit_limits(rsc, rrow, rcol, &limits);
+  RestUnitSearchInfo *rusi = &rsc->rusi[rrow * rsi->horz_units + rcol];
+
+  int32_t *tmpbuf = rsc->cm->rst_tmpbuf;
+  if (thread_id > 0) {
+    tmpbuf = rsc->tmpbuf +
+             (thread_id - 1) * (RESTORATION_TMPBUF_SIZE / sizeof(*tmpbuf));
+  }
+  int16_t *dgd_avg = NULL;
+  int16_t *src_avg = NULL;
+  if (rsc->dgd_avg != NULL) {
+    dgd_avg = rsc->dgd_avg + thread_id * LR_AVG_BUF_SIZE;
+    src_avg = dgd_avg + LR_AVG_BUF_SIZE / 2;
+    // Asserts the starting address of src_avg is always 32-bytes aligned.
+    assert(!((intptr_t)src_avg % 32));
+  }
+
+  const int highbd = rsc->cm->seq_params->use_highbitdepth;
+  rusi->sse[RESTORE_NONE] = sse_restoration_unit(
+      &limits, rsc->src, &rsc->cm->cur_frame->buf, rsc->plane, highbd);
+  rusi->sse[RESTORE_WIENER] = INT64_MAX;
+  rusi->sse[RESTORE_SGRPROJ] = INT64_MAX;
+  rusi->sgrproj_searched = false;
+
+  if (!rsc->disable_lr_filter[RESTORE_WIENER]) {
+    gather_wiener_stats(rsc, &limits, rusi, tmpbuf, dgd_avg, src_avg,
+                        error_info);
+  }
+  // With 'prune_sgr_based_on_wiener' enabled, whether the self-guided search
+  // runs at all depends on the rate of the Wiener filter, which is only known
+  // in coding order. Such units are searched in search_sgrproj() instead.
+  if (!rsc->disable_lr_filter[RESTORE_SGRPROJ] &&
+      (rsc->disable_lr_filter[RESTORE_WIENER] ||
+       rsc->lpf_sf->prune_sgr_based_on_wiener == 0)) {
+    gather_sgrproj_stats(rsc, &limits, rusi, tmpbuf, error_info);
+  }
+}
+
+// Gathers the parts of the search which do not depend on the reference
+// parameters used for delta-coding, for every restoration unit of the plane.
+// Filtering a unit temporarily overwrites the frame rows just outside each of
+// its processing stripes (see setup_processing_stripe_boundary()), which the
+// adjacent units read. So the units are split into four phases by (row,
+// column) parity and only units of the same phase are processed concurrently.
+static void gather_plane_stats(AV1_COMP *cpi, RestSearchCtxt *rsc) {
+  const RestorationInfo *rsi = &cpi->common.rst_info[rsc->plane];
+  const int num_workers = cpi->mt_info.num_mod_workers[MOD_LR_SEARCH];
+  for (int phase = 0; phase < 4; ++phase) {
+    int phase_cols;
+    const int num_jobs = get_phase_num_units(rsi, phase, &phase_cols);
+    rsc->gather_phase = phase;
+    if (num_workers > 1 && num_jobs > 1) {
+      av1_lr_gather_stats_mt(cpi, rsc, num_jobs,
+                             AOMMIN(num_workers, num_jobs));
+    } else {
+      for (int job_idx = 0; job_idx < num_jobs; ++job_idx)
+        av1_lr_gather_unit_stats(rsc, job_idx, 0, cpi->common.error);
+    }
+  }
+}
+
 static void restoration_search(AV1_COMMON *cm, int plane, RestSearchCtxt *rsc,
-                               bool *disable_lr_filter) {
+                               const bool *disable_lr_filter) {
   const BLOCK_SIZE sb_size = cm->seq_params->sb_size;
   const int mib_size_log2 = cm->seq_params->mib_size_log2;
   const CommonTileParams *tiles = &cm->tiles;
-  const int is_uv = plane > 0;
-  const int ss_y = is_uv && cm->seq_params->subsampling_y;
   RestorationInfo *rsi = &cm->rst_info[plane];
-  const int ru_size = rsi->restoration_unit_size;
-  const int ext_size = ru_size * 3 / 2;
-
-  int plane_w, plane_h;
-  av1_get_upsampled_plane_size(cm, is_uv, &plane_w, &plane_h);
 
   static const rest_unit_visitor_t funs[RESTORE_TYPES] = {
     search_norestore, search_wiener, search_sgrproj, search_switchable
@@ -1906,26 +2058,8 @@ static void restoration_search(AV1_COMMON *cm, int plane, RestSearchCtxt *rsc,
 
           RestorationTileLimits limits;
           for (int rrow = rrow0; rrow < rrow1; rrow++) {
-            int y0 = rrow * ru_size;
-            int remaining_h = plane_h - y0;
-            int h = (remaining_h < ext_size) ? remaining_h : ru_size;
-
-            limits.v_start = y0;
-            limits.v_end = y0 + h;
-            assert(limits.v_end <= plane_h);
-            // Offset upwards to align with the restoration processing stripe
-            const int voffset = RESTORATION_UNIT_OFFSET >> ss_y;
-            limits.v_start = AOMMAX(0, limits.v_start - voffset);
-            if (limits.v_end < plane_h) limits.v_end -= voffset;
-
             for (int rcol = rcol0; rcol < rcol1; rcol++) {
-              int x0 = rcol * ru_size;
-              int remaining_w = plane_w - x0;
-              int w = (remaining_w < ext_size) ? remaining_w : ru_size;
-
-              limits.h_start = x0;
-              limits.h_end = x0 + w;
-              assert(limits.h_end <= plane_w);
+              get_rest_unit_limits(rsc, rrow, rcol, &limits);
 
               const int unit_idx = rrow * rsi->horz_units + rcol;
 
@@ -2070,6 +2204,18 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
                        "Failed to allocate trial restored frame buffer");
 
   RestSearchCtxt rsc;
+  const int num_workers =
+      AOMMAX(cpi->mt_info.num_mod_workers[MOD_LR_SEARCH], 1);
+
+  // Each worker beyond the first needs its own restoration filter scratch
+  // buffer; the first one uses cm->rst_tmpbuf.
+  rsc.tmpbuf = NULL;
+  if (num_workers > 1) {
+    CHECK_MEM_ERROR(cm, cpi->pick_lr_ctxt.tmpbuf,
+                    (int32_t *)aom_memalign(
+                        16, RESTORATION_TMPBUF_SIZE * (num_workers - 1)));
+    rsc.tmpbuf = cpi->pick_lr_ctxt.tmpbuf;
+  }
 
   // The buffers 'src_avg' and 'dgd_avg' are used to compute H and M buffers.
   // These buffers are only required for the AVX2 and NEON implementations of
@@ -2077,8 +2223,8 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
   // width and height of the LRU (i.e., from foreach_rest_unit_in_plane() 1.5
   // times the RESTORATION_UNITSIZE_MAX) allowed for Wiener filtering. The width
   // and height aligned to multiple of 16 is considered for intrinsic purpose.
+  // One such pair of buffers is allocated per worker.
   rsc.dgd_avg = NULL;
-  rsc.src_avg = NULL;
 #if HAVE_AVX2 || HAVE_NEON || HAVE_SVE
   // The buffers allocated below are used during Wiener filter processing.
   // Hence, allocate the same when Wiener filter is enabled. Make sure to
@@ -2090,8 +2236,8 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
   bool allocate_buffers = !cpi->sf.lpf_sf.disable_wiener_filter;
 #endif
   if (allocate_buffers) {
-    const int buf_size = sizeof(*cpi->pick_lr_ctxt.dgd_avg) * 6 *
-                         RESTORATION_UNITSIZE_MAX * RESTORATION_UNITSIZE_MAX;
+    const int buf_size =
+        sizeof(*cpi->pick_lr_ctxt.dgd_avg) * LR_AVG_BUF_SIZE * num_workers;
     CHECK_MEM_ERROR(cm, cpi->pick_lr_ctxt.dgd_avg,
                     (int16_t *)aom_memalign(32, buf_size));
 
@@ -2101,10 +2247,6 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
     // silence Valgrind warning this buffer is initialized with zero. Overhead
     // due to this initialization is negligible since it is done at frame level.
     memset(rsc.dgd_avg, 0, buf_size);
-    rsc.src_avg =
-        rsc.dgd_avg + 3 * RESTORATION_UNITSIZE_MAX * RESTORATION_UNITSIZE_MAX;
-    // Asserts the starting address of src_avg is always 32-bytes aligned.
-    assert(!((intptr_t)rsc.src_avg % 32));
   }
 #endif
 
@@ -2154,9 +2296,10 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
     for (int plane = plane_start; plane <= plane_end; ++plane) {
       set_restoration_unit_size(cm, &cm->rst_info[plane], plane > 0,
                                 luma_unit_size);
-      init_rsc(src, &cpi->common, x, lpf_sf, plane,
+      init_rsc(src, &cpi->common, x, lpf_sf, disable_lr_filter, plane,
                cpi->pick_lr_ctxt.rusi[plane], &cpi->trial_frame_rst, &rsc);
 
+      gather_plane_stats(cpi, &rsc);
       restoration_search(cm, plane, &rsc, disable_lr_filter);
 
       const int plane_num_units = cm->rst_info[plane].num_rest_units;
@@ -2236,6 +2379,8 @@ void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *src, AV1_COMP *cpi) {
     cpi->pick_lr_ctxt.dgd_avg = NULL;
   }
 #endif
+  aom_free(cpi->pick_lr_ctxt.tmpbuf);
+  cpi->pick_lr_ctxt.tmpbuf = NULL;
   for (int plane = 0; plane < num_planes; plane++) {
     aom_free(cpi->pick_lr_ctxt.rusi[plane]);
     cpi->pick_lr_ctxt.rusi[plane] = NULL;
@@ -119,6 +119,17 @@ static inline uint16_t find_average_highbd(const uint16_t *src, int h_start,
  */
 void av1_pick_filter_restoration(const YV12_BUFFER_CONFIG *sd, AV1_COMP *cpi);
 
+/*!\cond */
+struct RestSearchCtxt;
+
+// Gathers the search statistics which do not depend on delta-coding
+// references for the restoration unit at index 'job_idx' of the current
+// gather phase, using the scratch buffers of thread 'thread_id'.
+void av1_lr_gather_unit_stats(struct RestSearchCtxt *rsc, int job_idx,
+                              int thread_id,
+                              struct aom_internal_error_info *error_info);
+/*!\endcond */
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -10,6 +10,7 @@
  */
 
 #include "av1/encoder/encoder_alloc.h"
+#include "av1/encoder/ethread.h"
 #include "av1/encoder/superres_scale.h"
 #include "av1/encoder/random.h"
 
@@ -404,7 +405,14 @@ void av1_superres_post_encode(AV1_COMP *cpi) {
   assert(!is_lossless_requested(&cpi->oxcf.rc_cfg));
   assert(!cm->features.all_lossless);
 
-  av1_superres_upscale(cm, NULL, cpi->alloc_pyramid);
+  MultiThreadInfo *const mt_info = &cpi->mt_info;
+  const int num_workers = mt_info->num_mod_workers[MOD_CDEF];
+  // The upscaling runs on the workers right after CDEF, before any tile is
+  // packed.
+  assert(!mt_info->tile_prepack.in_progress);
+  if (num_workers > 1) av1_enc_scheduler_stop(mt_info);
+  av1_superres_upscale(cm, NULL, cpi->alloc_pyramid, mt_info->workers,
+                       num_workers);
 
   // If regular resizing is occurring the source will need to be downscaled to
   // match the upscaled superres resolution. Otherwise the original source is
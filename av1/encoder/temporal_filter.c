@@ -1427,6 +1427,7 @@ void av1_temporal_filter(AV1_COMP *cpi, const int filter_frame_lookahead_idx,
   // it is more beneficial to use non-zero strength filtering.
   // Only parallel level 0 frames go through temporal filtering.
   assert(cpi->ppi->gf_group.frame_parallel_level[gf_frame_index] == 0);
+  start_stage_timing(cpi, kStageTemporalFilter);
 
   // Initialize temporal filter context structure.
   init_tf_ctx(cpi, filter_frame_lookahead_idx, gf_frame_index,
@@ -1450,6 +1451,7 @@ void av1_temporal_filter(AV1_COMP *cpi, const int filter_frame_lookahead_idx,
   }
   // Deallocate temporal filter buffers.
   tf_dealloc_data(tf_data, is_highbitdepth);
+  end_stage_timing(cpi, kStageTemporalFilter);
 }
 
 int av1_is_temporal_filter_on(const AV1EncoderConfig *oxcf) {
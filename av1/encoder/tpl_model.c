@@ -1875,6 +1875,7 @@ int av1_tpl_setup_stats(AV1_COMP *cpi, int gop_eval,
     return 0;
   }
 
+  start_stage_timing(cpi, kStageTpl);
   cm->current_frame.frame_type = frame_params->frame_type;
   for (int gf_index = cpi->gf_frame_index; gf_index < gf_group->size;
        ++gf_index) {
@@ -1985,6 +1986,7 @@ int av1_tpl_setup_stats(AV1_COMP *cpi, int gop_eval,
 #endif
 
   tpl_dealloc_temp_buffers(tpl_tmp_buffers);
+  end_stage_timing(cpi, kStageTpl);
 
   if (!approx_gop_eval) {
     tpl_data->ready = 1;
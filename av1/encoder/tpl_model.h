@@ -34,6 +34,7 @@ struct TPL_INFO;
 
 #include "av1/common/mv.h"
 #include "av1/common/scale.h"
+#include "av1/common/thread_common.h"
 #include "av1/encoder/block.h"
 #include "av1/encoder/lookahead.h"
 #include "av1/encoder/ratectrl.h"
@@ -52,15 +53,10 @@ static inline BLOCK_SIZE convert_length_to_bsize(int length) {
 }
 
 typedef struct AV1TplRowMultiThreadSync {
-#if CONFIG_MULTITHREAD
-  // Synchronization objects for top-right dependency.
-  pthread_mutex_t *mutex_;
-  pthread_cond_t *cond_;
-#endif
-  // Buffer to store the macroblock whose encoding is complete.
-  // num_finished_cols[i] stores the number of macroblocks which finished
-  // encoding in the ith macroblock row.
-  int *num_finished_cols;
+  // Progress of the macroblock rows, used for the top-right dependency.
+  // num_finished_cols.progress[i] stores the number of macroblocks which
+  // finished encoding in the ith macroblock row.
+  AV1RowMTProgress num_finished_cols;
   // Number of extra macroblocks of the top row to be complete for encoding
   // of the current macroblock to start. A value of 1 indicates top-right
   // dependency.
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>  // AVX512
+
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_integer.h"
+
+// Unlike the AVX2 version, this operates on the full 32-bit coefficients and
+// forms exact 64-bit products, so it does not depend on the coefficients
+// fitting in 16 bits.
+int64_t av1_block_error_avx512(const tran_low_t *coeff,
+                               const tran_low_t *dqcoeff, intptr_t block_size,
+                               int64_t *ssz) {
+  __m512i sse_reg = _mm512_setzero_si512();
+  __m512i ssz_reg = _mm512_setzero_si512();
+
+  for (intptr_t i = 0; i < block_size; i += 16) {
+    const __m512i coeff_reg = _mm512_loadu_si512((const void *)(coeff + i));
+    const __m512i dqcoeff_reg = _mm512_loadu_si512((const void *)(dqcoeff + i));
+    const __m512i diff = _mm512_sub_epi32(coeff_reg, dqcoeff_reg);
+    // _mm512_mul_epi32 multiplies the even 32-bit elements; shift the odd ones
+    // down to cover them too.
+    const __m512i diff_odd = _mm512_srli_epi64(diff, 32);
+    const __m512i coeff_odd = _mm512_srli_epi64(coeff_reg, 32);
+
+    sse_reg = _mm512_add_epi64(sse_reg, _mm512_mul_epi32(diff, diff));
+    sse_reg = _mm512_add_epi64(sse_reg, _mm512_mul_epi32(diff_odd, diff_odd));
+    ssz_reg = _mm512_add_epi64(ssz_reg, _mm512_mul_epi32(coeff_reg, coeff_reg));
+    ssz_reg =
+        _mm512_add_epi64(ssz_reg, _mm512_mul_epi32(coeff_odd, coeff_odd));
+  }
+
+  *ssz = _mm512_reduce_add_epi64(ssz_reg);
+  return _mm512_reduce_add_epi64(sse_reg);
+}
@@ -20,10 +20,13 @@
 // the number of anchor frames coded at the beginning of the light field file.
 // num_tile_lists is the number of tile lists need to be decoded. There is an
 // optional parameter allowing to choose the output format, and the supported
-// formats are YUV1D(default), YUV, and NV12.
+// formats are YUV1D(default), YUV, and NV12. The optional num_threads sets the
+// number of threads that decode the tiles of a tile list, and the optional
+// tile_cache_kb the size of the cache that keeps the decoded tiles for the
+// following tile lists.
 // Run lightfield tile list decoder to decode an AV1 tile list file:
 // examples/lightfield_tile_list_decoder vase_tile_list.ivf vase_tile_list.yuv
-// 4 2 0(optional)
+// 4 2 0(optional) 4(optional) 16384(optional)
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -48,7 +51,8 @@ static const char *exec_name;
 void usage_exit(void) {
   fprintf(stderr,
           "Usage: %s <infile> <outfile> <num_references> <num_tile_lists> "
-          "<output format(optional)>\n",
+          "<output format(optional)> <num_threads(optional)> "
+          "<tile_cache_kb(optional)>\n",
           exec_name);
   exit(EXIT_FAILURE);
 }
@@ -112,6 +116,8 @@ int main(int argc, char **argv) {
   size_t frame_size = 0;
   const unsigned char *frame = NULL;
   int output_format = YUV1D;
+  aom_codec_dec_cfg_t cfg = { 0, 0, 0, !FORCE_HIGHBITDEPTH_DECODING };
+  unsigned int tile_cache_kb = 0;
   int i, j, n;
 
   exec_name = argv[0];
@@ -130,6 +136,8 @@ int main(int argc, char **argv) {
   if (argc > 5) output_format = (int)strtol(argv[5], NULL, 0);
   if (output_format < YUV1D || output_format > NV12)
     die("Output format out of range [0, 2]");
+  if (argc > 6) cfg.threads = (unsigned int)strtoul(argv[6], NULL, 0);
+  if (argc > 7) tile_cache_kb = (unsigned int)strtoul(argv[7], NULL, 0);
 
   info = aom_video_reader_get_info(reader);
 
@@ -138,7 +146,7 @@ int main(int argc, char **argv) {
   printf("Using %s\n", aom_codec_iface_name(decoder));
 
   aom_codec_ctx_t codec;
-  if (aom_codec_dec_init(&codec, decoder, NULL, 0))
+  if (aom_codec_dec_init(&codec, decoder, &cfg, 0))
     die("Failed to initialize decoder.");
 
   if (AOM_CODEC_CONTROL_TYPECHECKED(&codec, AV1D_SET_IS_ANNEXB,
@@ -197,6 +205,9 @@ int main(int argc, char **argv) {
   // Set external references.
   av1_ext_ref_frame_t set_ext_ref = { &reference_images[0], num_references };
   AOM_CODEC_CONTROL_TYPECHECKED(&codec, AV1D_SET_EXT_REF_PTR, &set_ext_ref);
+  if (AOM_CODEC_CONTROL_TYPECHECKED(&codec, AV1D_SET_TILE_CACHE_SIZE,
+                                    tile_cache_kb << 10))
+    die_codec(&codec, "Failed to set the tile cache size");
   // Must decode the camera frame header first.
   aom_video_reader_read_frame(reader);
   frame = aom_video_reader_get_frame(reader, &frame_size);
@@ -223,6 +234,14 @@ int main(int argc, char **argv) {
       aom_img_write_nv12(img, outfile);
   }
 
+  if (tile_cache_kb > 0) {
+    av1_tile_cache_stats_t stats;
+    if (AOM_CODEC_CONTROL_TYPECHECKED(&codec, AV1D_GET_TILE_CACHE_STATS,
+                                      &stats))
+      die_codec(&codec, "Failed to get the tile cache statistics");
+    printf("Tile cache: %u hits, %u misses\n", stats.hits, stats.misses);
+  }
+
   for (i = 0; i < num_references; i++) aom_img_free(&reference_images[i]);
   if (aom_codec_destroy(&codec)) die_codec(&codec, "Failed to destroy codec");
   aom_video_reader_close(reader);
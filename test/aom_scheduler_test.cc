@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2025, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <cstring>
+
+#include "config/aom_config.h"
+
+#include "aom_util/aom_scheduler.h"
+#include "aom_util/aom_thread.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+#if CONFIG_MULTITHREAD
+
+const int kNumTasks = 64;
+
+struct TaskData {
+  aom_atomic_int *counter;
+  int value;
+};
+
+int AddHook(void *arg1, void *arg2) {
+  const TaskData *const data = static_cast<const TaskData *>(arg1);
+  aom_atomic_fetch_add(data->counter, data->value);
+  return arg2 == nullptr;
+}
+
+int IdleHook(void *, void *) { return 1; }
+
+class AomSchedulerTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    num_threads_ = GetParam();
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < num_threads_; ++i) {
+      winterface->init(&workers_[i]);
+      workers_[i].hook = IdleHook;
+      if (i > 0) {
+        ASSERT_NE(winterface->reset(&workers_[i]), 0);
+      }
+    }
+    memset(&scheduler_, 0, sizeof(scheduler_));
+  }
+
+  void TearDown() override {
+    aom_scheduler_dealloc(&scheduler_);
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < num_threads_; ++i) winterface->end(&workers_[i]);
+  }
+
+  // Runs kNumTasks tasks spread over the threads, which add 1 to kNumTasks to
+  // the counter, and checks their sum.
+  void RunTasks() {
+    aom_atomic_int counter;
+    aom_atomic_init(&counter, 0);
+    TaskData data[kNumTasks];
+    AVxTaskGroup group;
+    aom_scheduler_group_init(&group);
+    for (int i = 0; i < kNumTasks; ++i) {
+      data[i].counter = &counter;
+      data[i].value = i + 1;
+      ASSERT_NE(aom_scheduler_submit(&scheduler_, i % num_threads_, &group,
+                                     AddHook, &data[i], nullptr, nullptr),
+                0);
+    }
+    aom_scheduler_wait(&scheduler_, &group);
+    EXPECT_EQ(aom_atomic_load_acquire(&counter),
+              kNumTasks * (kNumTasks + 1) / 2);
+  }
+
+  AVxScheduler scheduler_;
+  AVxWorker workers_[8];
+  int num_threads_;
+};
+
+TEST_P(AomSchedulerTest, RunsAllTasks) {
+  ASSERT_NE(aom_scheduler_start(&scheduler_, workers_, num_threads_), 0);
+  for (int i = 0; i < 10; ++i) RunTasks();
+  aom_scheduler_stop(&scheduler_);
+}
+
+TEST_P(AomSchedulerTest, RestartKeepsWorkerJobs) {
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_NE(aom_scheduler_start(&scheduler_, workers_, num_threads_), 0);
+    // The hooks set up before the scheduler started are kept.
+    for (int j = 1; j < num_threads_; ++j) {
+      EXPECT_EQ(workers_[j].hook, IdleHook);
+    }
+    RunTasks();
+    aom_scheduler_stop(&scheduler_);
+  }
+
+  // The workers can be launched directly once the scheduler is stopped.
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  for (int i = 1; i < num_threads_; ++i) winterface->launch(&workers_[i]);
+  for (int i = 1; i < num_threads_; ++i) {
+    EXPECT_NE(winterface->sync(&workers_[i]), 0);
+  }
+}
+
+TEST_P(AomSchedulerTest, ReportsErrors) {
+  ASSERT_NE(aom_scheduler_start(&scheduler_, workers_, num_threads_), 0);
+  aom_atomic_int counter;
+  aom_atomic_init(&counter, 0);
+  TaskData data = { &counter, 1 };
+  int had_error[kNumTasks] = { 0 };
+  AVxTaskGroup group;
+  aom_scheduler_group_init(&group);
+  for (int i = 0; i < kNumTasks; ++i) {
+    // A non-null second argument makes the task fail.
+    void *const fail = (i % 3 == 0) ? &data : nullptr;
+    ASSERT_NE(aom_scheduler_submit(&scheduler_, i % num_threads_, &group,
+                                   AddHook, &data, fail, &had_error[i]),
+              0);
+  }
+  aom_scheduler_wait(&scheduler_, &group);
+  for (int i = 0; i < kNumTasks; ++i) EXPECT_EQ(had_error[i], i % 3 == 0);
+  EXPECT_EQ(aom_atomic_load_acquire(&counter), kNumTasks);
+}
+
+TEST(AomSchedulerStartTest, NeedsTwoThreads) {
+  AVxScheduler scheduler;
+  memset(&scheduler, 0, sizeof(scheduler));
+  AVxWorker worker;
+  aom_get_worker_interface()->init(&worker);
+  EXPECT_EQ(aom_scheduler_start(&scheduler, &worker, 1), 0);
+  aom_scheduler_dealloc(&scheduler);
+}
+
+INSTANTIATE_TEST_SUITE_P(AomScheduler, AomSchedulerTest,
+                         ::testing::Values(2, 3, 8));
+
+#endif  // CONFIG_MULTITHREAD
+
+}  // namespace
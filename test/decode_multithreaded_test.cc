@@ -11,7 +11,9 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "aom_mem/aom_mem.h"
 #include "gtest/gtest.h"
@@ -155,7 +157,7 @@ TEST_P(AV1DecodeMultiThreadedTestLarge, MD5Match) {
 
 // TODO(ranjit): More tests have to be added using pre-generated MD5.
 AV1_INSTANTIATE_TEST_SUITE(AV1DecodeMultiThreadedTest, ::testing::Values(1, 2),
-                           ::testing::Values(1, 2), ::testing::Values(1),
+                           ::testing::Values(1, 2), ::testing::Values(1, 3),
                            ::testing::Values(3), ::testing::Values(0, 1));
 AV1_INSTANTIATE_TEST_SUITE(AV1DecodeMultiThreadedTestLarge,
                            ::testing::Values(0, 1, 2, 6),
@@ -179,4 +181,244 @@ AV1_INSTANTIATE_TEST_SUITE(AV1DecodeMultiThreadedLSTestLarge,
                            ::testing::Values(1), ::testing::Values(0, 3),
                            ::testing::Values(0, 1));
 
+// Decodes with a row output callback and checks that the rows it reports are
+// final: a copy of each frame, made from the rows as they are reported, must
+// match the frame returned by aom_codec_get_frame().
+class AV1DecodeRowOutputTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeRowOutputTest()
+      : EncoderTest(GET_PARAM(0)), threads_(GET_PARAM(1)),
+        row_mt_(GET_PARAM(2)), num_reported_frames_(0), rows_done_(0),
+        num_calls_(0) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    cfg.allow_lowbitdepth = 1;
+    decoder_ = codec_->CreateDecoder(cfg, 0);
+    decoder_->Control(AV1D_SET_ROW_MT, row_mt_);
+    aom_row_output_cb_init init = { RowOutputCallback, this };
+    decoder_->Control(AV1D_SET_ROW_OUTPUT_CALLBACK, &init);
+  }
+
+  ~AV1DecodeRowOutputTest() override { delete decoder_; }
+
+  void SetUp() override { InitializeConfig(libaom_test::kTwoPassGood); }
+
+  void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                          libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, 5);
+  }
+
+  static void RowOutputCallback(void *cb_priv, const aom_image_t *img,
+                                unsigned int rows_done) {
+    static_cast<AV1DecodeRowOutputTest *>(cb_priv)->RowOutput(img, rows_done);
+  }
+
+  void RowOutput(const aom_image_t *img, unsigned int rows_done) {
+    ASSERT_GT(rows_done, rows_done_);
+    ASSERT_LE(rows_done, img->d_h);
+    const int bytes_per_sample = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    const size_t row_size = img->d_w * bytes_per_sample;
+    rows_.resize(img->d_h * row_size);
+    for (unsigned int r = rows_done_; r < rows_done; ++r) {
+      memcpy(&rows_[r * row_size],
+             img->planes[AOM_PLANE_Y] + r * img->stride[AOM_PLANE_Y], row_size);
+    }
+    rows_done_ = rows_done;
+    ++num_calls_;
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    rows_done_ = 0;
+    num_calls_ = 0;
+    const aom_codec_err_t res = decoder_->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    const aom_image_t *img = decoder_->GetDxData().Next();
+    if (num_calls_ == 0) return;
+    ASSERT_NE(img, nullptr);
+    ASSERT_EQ(rows_done_, img->d_h);
+    // The rows are reported as they are filtered only by the filter pipeline
+    // of row-based multi-threaded decoding.
+    if (threads_ > 1 && row_mt_) {
+      EXPECT_GT(num_calls_, 1);
+    } else {
+      EXPECT_EQ(num_calls_, 1);
+    }
+    const int bytes_per_sample = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+    const size_t row_size = img->d_w * bytes_per_sample;
+    for (unsigned int r = 0; r < img->d_h; ++r) {
+      const uint8_t *const row =
+          img->planes[AOM_PLANE_Y] + r * img->stride[AOM_PLANE_Y];
+      ASSERT_EQ(0, memcmp(&rows_[r * row_size], row, row_size)) << "row " << r;
+    }
+    ++num_reported_frames_;
+  }
+
+  int threads_;
+  int row_mt_;
+  int num_reported_frames_;
+  unsigned int rows_done_;
+  int num_calls_;
+  std::vector<uint8_t> rows_;
+  ::libaom_test::Decoder *decoder_;
+};
+
+TEST_P(AV1DecodeRowOutputTest, RowsAreFinal) {
+  cfg_.rc_target_bitrate = 500;
+  cfg_.g_lag_in_frames = 12;
+  libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                     30, 1, 0, 10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_GT(num_reported_frames_, 0);
+}
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeRowOutputTest, ::testing::Values(1, 4),
+                           ::testing::Values(0, 1));
+
+// Decodes with and without AV1D_SET_EXTEND_REF_BORDERS and checks that the
+// decoded frames are the same. The second parameter is the resize mode of the
+// encoder: 2 codes each frame at a random scale, so that frames are predicted
+// from scaled references whose sizes are not multiples of 8.
+class AV1DecodeExtendRefBordersTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeExtendRefBordersTest()
+      : EncoderTest(GET_PARAM(0)), resize_mode_(GET_PARAM(2)) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = GET_PARAM(1);
+    cfg.allow_lowbitdepth = 1;
+    for (int i = 0; i < 2; ++i) {
+      decoders_[i] = codec_->CreateDecoder(cfg, 0);
+      decoders_[i]->Control(AV1D_SET_ROW_MT, 1);
+      decoders_[i]->Control(AV1D_SET_EXTEND_REF_BORDERS, i);
+    }
+  }
+
+  ~AV1DecodeExtendRefBordersTest() override {
+    for (int i = 0; i < 2; ++i) delete decoders_[i];
+  }
+
+  void SetUp() override { InitializeConfig(libaom_test::kTwoPassGood); }
+
+  void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                          libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, 5);
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    ::libaom_test::MD5 md5[2];
+    for (int i = 0; i < 2; ++i) {
+      const aom_codec_err_t res = decoders_[i]->DecodeFrame(
+          reinterpret_cast<uint8_t *>(pkt->data.frame.buf),
+          pkt->data.frame.sz);
+      if (res != AOM_CODEC_OK) {
+        abort_ = true;
+        ASSERT_EQ(AOM_CODEC_OK, res);
+      }
+      const aom_image_t *img = decoders_[i]->GetDxData().Next();
+      if (img == nullptr) return;
+      md5[i].Add(img);
+    }
+    ASSERT_STREQ(md5[0].Get(), md5[1].Get()) << "frame " << num_frames_;
+    ++num_frames_;
+  }
+
+  int resize_mode_;
+  int num_frames_ = 0;
+  ::libaom_test::Decoder *decoders_[2];
+};
+
+TEST_P(AV1DecodeExtendRefBordersTest, MD5Match) {
+  cfg_.rc_target_bitrate = 500;
+  cfg_.g_lag_in_frames = 12;
+  cfg_.rc_resize_mode = resize_mode_;
+  libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                     30, 1, 0, 10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_GT(num_frames_, 0);
+}
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeExtendRefBordersTest,
+                           ::testing::Values(1, 4), ::testing::Values(0, 2));
+
+// Checks the stage times returned by AV1D_GET_FRAME_STAGE_TIMINGS for a stream
+// with film grain.
+class AV1DecodeStageTimingsTest
+    : public ::libaom_test::CodecTestWithParam<int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AV1DecodeStageTimingsTest() : EncoderTest(GET_PARAM(0)) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = GET_PARAM(1);
+    cfg.allow_lowbitdepth = 1;
+    decoder_ = codec_->CreateDecoder(cfg, 0);
+  }
+
+  ~AV1DecodeStageTimingsTest() override { delete decoder_; }
+
+  void SetUp() override { InitializeConfig(libaom_test::kTwoPassGood); }
+
+  // The film grain makes the decoded frames differ from the reconstruction of
+  // the encoder.
+  bool DoDecode() const override { return false; }
+
+  void PreEncodeFrameHook(libaom_test::VideoSource *video,
+                          libaom_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 5);
+      encoder->Control(AV1E_SET_FILM_GRAIN_TEST_VECTOR, 1);
+    }
+  }
+
+  void FramePktHook(const aom_codec_cx_pkt_t *pkt) override {
+    const aom_codec_err_t res = decoder_->DecodeFrame(
+        reinterpret_cast<uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    if (res != AOM_CODEC_OK) {
+      abort_ = true;
+      ASSERT_EQ(AOM_CODEC_OK, res);
+    }
+    ::libaom_test::DxDataIterator dec_iter = decoder_->GetDxData();
+    while (dec_iter.Next() != nullptr) {
+    }
+
+    aom_dec_stage_timings_t timings;
+    memset(&timings, 0xff, sizeof(timings));
+    decoder_->Control(AV1D_GET_FRAME_STAGE_TIMINGS, &timings);
+    const int64_t stages[] = { timings.frame_header,
+                               timings.decode_tiles,
+                               timings.loop_filter,
+                               timings.cdef,
+                               timings.superres,
+                               timings.loop_restoration,
+                               timings.film_grain };
+    for (const int64_t stage_time : stages) ASSERT_GE(stage_time, 0);
+    // Superres is off.
+    EXPECT_EQ(timings.superres, 0);
+    decode_tiles_time_ += timings.decode_tiles;
+    film_grain_time_ += timings.film_grain;
+  }
+
+  int64_t decode_tiles_time_ = 0;
+  int64_t film_grain_time_ = 0;
+  ::libaom_test::Decoder *decoder_;
+};
+
+TEST_P(AV1DecodeStageTimingsTest, StagesAreTimed) {
+  cfg_.rc_target_bitrate = 500;
+  cfg_.g_lag_in_frames = 0;
+  libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                     30, 1, 0, 5);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_GT(decode_tiles_time_, 0);
+  EXPECT_GT(film_grain_time_, 0);
+}
+
+AV1_INSTANTIATE_TEST_SUITE(AV1DecodeStageTimingsTest, ::testing::Values(1, 4));
+
 }  // namespace
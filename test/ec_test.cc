@@ -15,8 +15,13 @@
 #include <memory>
 #include <new>
 
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
 #include "aom_dsp/entenc.h"
 #include "aom_dsp/entdec.h"
+#include "test/acm_random.h"
 
 TEST(EC_TEST, random_ec_test) {
   od_ec_enc enc;
@@ -143,3 +148,91 @@ TEST(EC_TEST, random_ec_test) {
   od_ec_enc_clear(&enc);
   EXPECT_EQ(ret, 0);
 }
+
+namespace {
+
+// Fills icdf with a random inverse CDF of nsyms symbols, each of which has a
+// nonzero probability.
+void RandomIcdf(libaom_test::ACMRandom *rnd, uint16_t *icdf, int nsyms) {
+  int cdf = 0;
+  for (int s = 0; s < nsyms - 1; ++s) {
+    const int left = CDF_PROB_TOP - (nsyms - 1 - s) - cdf;
+    cdf += 1 + rnd->PseudoUniform(AOMMIN(left, CDF_PROB_TOP / 4));
+    icdf[s] = OD_ICDF(cdf);
+  }
+  icdf[nsyms - 1] = OD_ICDF(CDF_PROB_TOP);
+}
+
+// Encodes random symbols of alphabets of up to 16 symbols, and checks that
+// they decode. The buffers have all sizes, so that the decoder refills its
+// window both away from the end of the buffer and near it.
+TEST(EC_TEST, random_cdf_test) {
+  libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+  const int kMaxSymbols = 2000;
+  std::unique_ptr<uint16_t[]> icdfs(new (std::nothrow)
+                                        uint16_t[kMaxSymbols * 16]);
+  ASSERT_NE(icdfs, nullptr);
+  std::unique_ptr<int[]> nsyms(new (std::nothrow) int[kMaxSymbols]);
+  ASSERT_NE(nsyms, nullptr);
+  std::unique_ptr<int[]> data(new (std::nothrow) int[kMaxSymbols]);
+  ASSERT_NE(data, nullptr);
+  od_ec_enc enc;
+  od_ec_enc_init(&enc, 1);
+  for (int i = 0; i < 2000; ++i) {
+    const int sz = 1 + rnd.PseudoUniform(i < 1000 ? 64 : kMaxSymbols);
+    od_ec_enc_reset(&enc);
+    for (int j = 0; j < sz; ++j) {
+      uint16_t *const icdf = &icdfs[j * 16];
+      nsyms[j] = 2 + rnd.PseudoUniform(15);
+      RandomIcdf(&rnd, icdf, nsyms[j]);
+      data[j] = rnd.PseudoUniform(nsyms[j]);
+      od_ec_encode_cdf_q15(&enc, data[j], icdf, nsyms[j]);
+    }
+    uint32_t ptr_sz;
+    const unsigned char *const ptr = od_ec_enc_done(&enc, &ptr_sz);
+    ASSERT_NE(ptr, nullptr);
+    od_ec_dec dec;
+    od_ec_dec_init(&dec, ptr, ptr_sz);
+    for (int j = 0; j < sz; ++j) {
+      ASSERT_EQ(od_ec_decode_cdf_q15(&dec, &icdfs[j * 16], nsyms[j]), data[j])
+          << "symbol " << j << " of " << sz << " (" << nsyms[j]
+          << " symbols)";
+    }
+    EXPECT_EQ(od_ec_dec_tell(&dec), od_ec_enc_tell(&enc));
+  }
+  od_ec_enc_clear(&enc);
+}
+
+typedef int (*CdfSearchFunc)(const uint16_t *icdf, int nsyms, unsigned c,
+                             unsigned r);
+
+class CdfSearchTest : public ::testing::TestWithParam<CdfSearchFunc> {};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(CdfSearchTest);
+
+TEST_P(CdfSearchTest, MatchesC) {
+  libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+  const CdfSearchFunc search = GetParam();
+  for (int i = 0; i < 20000; ++i) {
+    const int nsyms = 2 + rnd.PseudoUniform(15);
+    // The icdf is exactly nsyms long, so that the sanitizers catch any read
+    // beyond it.
+    std::unique_ptr<uint16_t[]> icdf(new (std::nothrow) uint16_t[nsyms]);
+    ASSERT_NE(icdf, nullptr);
+    RandomIcdf(&rnd, icdf.get(), nsyms);
+    const unsigned r = 32768 + rnd.PseudoUniform(32768);
+    for (int j = 0; j < 16; ++j) {
+      const unsigned c =
+          j == 0 ? 0 : (j == 1 ? r - 1 : rnd.PseudoUniform(r));
+      ASSERT_EQ(search(icdf.get(), nsyms, c, r),
+                aom_ec_cdf_search_c(icdf.get(), nsyms, c, r))
+          << "nsyms " << nsyms << " c " << c << " r " << r;
+    }
+  }
+}
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_SUITE_P(SSE2, CdfSearchTest,
+                         ::testing::Values(aom_ec_cdf_search_sse2));
+#endif
+
+}  // namespace
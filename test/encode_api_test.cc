@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <tuple>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -650,6 +651,164 @@ TEST(EncodeAPI, PtsOrDurationTooBig) {
   aom_codec_destroy(&enc);
 }
 
+struct LentImages {
+  std::vector<int> release_count;
+  std::vector<aom_image_t *> images;
+};
+
+void ReleaseLentImage(void *cb_priv, const aom_image_t *img) {
+  LentImages *const lent = static_cast<LentImages *>(cb_priv);
+  for (size_t i = 0; i < lent->images.size(); ++i) {
+    if (lent->images[i] == img) ++lent->release_count[i];
+  }
+}
+
+void InitLendingTestEncoder(aom_codec_ctx_t *enc) {
+  aom_codec_iface_t *const iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, kUsage), AOM_CODEC_OK);
+  cfg.g_w = 176;
+  cfg.g_h = 144;
+  cfg.g_lag_in_frames = 4;
+  cfg.g_threads = 2;
+  ASSERT_EQ(aom_codec_enc_init(enc, iface, &cfg, 0), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(enc, AOME_SET_CPUUSED, 6), AOM_CODEC_OK);
+}
+
+// Encodes the images, flushes and destroys the encoder, and returns the
+// concatenated frame packets.
+std::vector<uint8_t> EncodeImages(aom_codec_ctx_t *enc,
+                                  const std::vector<aom_image_t *> &images) {
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i <= images.size(); ++i) {
+    aom_image_t *const img = i < images.size() ? images[i] : nullptr;
+    EXPECT_EQ(aom_codec_encode(enc, img, i, 1, 0), AOM_CODEC_OK);
+    aom_codec_iter_t iter = nullptr;
+    const aom_codec_cx_pkt_t *pkt;
+    bool got_data = false;
+    while ((pkt = aom_codec_get_cx_data(enc, &iter)) != nullptr) {
+      if (pkt->kind != AOM_CODEC_CX_FRAME_PKT) continue;
+      const uint8_t *const buf = static_cast<uint8_t *>(pkt->data.frame.buf);
+      stream.insert(stream.end(), buf, buf + pkt->data.frame.sz);
+      got_data = true;
+    }
+    // Keep flushing until the lookahead is empty.
+    if (img == nullptr && got_data) --i;
+  }
+  EXPECT_EQ(aom_codec_destroy(enc), AOM_CODEC_OK);
+  return stream;
+}
+
+TEST(EncodeAPI, SourceLending) {
+  const int kNumFrames = 8;
+  LentImages lent;
+  aom_codec_ctx_t enc;
+  InitLendingTestEncoder(&enc);
+  aom_source_lending_t lending = { ReleaseLentImage, &lent, 0 };
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_SET_SOURCE_LENDING, &lending),
+            AOM_CODEC_OK);
+  ASSERT_GT(lending.border, 0u);
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    aom_image_t *const img = aom_img_alloc_with_border(
+        nullptr, AOM_IMG_FMT_I420, 176, 144, 32, 8, lending.border);
+    ASSERT_NE(img, nullptr);
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = aom_img_plane_width(img, plane);
+      const int h = aom_img_plane_height(img, plane);
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img->planes[plane] + r * img->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          row[c] = static_cast<uint8_t>((r * 3 + c * 5 + i * 7) * (plane + 1));
+        }
+      }
+    }
+    lent.images.push_back(img);
+    lent.release_count.push_back(0);
+  }
+
+  aom_codec_ctx_t ref_enc;
+  InitLendingTestEncoder(&ref_enc);
+  const std::vector<uint8_t> copied = EncodeImages(&ref_enc, lent.images);
+  const std::vector<uint8_t> borrowed = EncodeImages(&enc, lent.images);
+  EXPECT_EQ(copied, borrowed);
+  for (int i = 0; i < kNumFrames; ++i) {
+    EXPECT_EQ(lent.release_count[i], 1) << "image " << i;
+    aom_img_free(lent.images[i]);
+  }
+}
+
+TEST(EncodeAPI, FrameStageTimings) {
+  aom_codec_iface_t *const iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  ASSERT_EQ(aom_codec_enc_config_default(iface, &cfg, kUsage), AOM_CODEC_OK);
+  cfg.g_w = 176;
+  cfg.g_h = 144;
+  cfg.g_lag_in_frames = 4;
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(aom_codec_enc_init(&enc, iface, &cfg, 0), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AOME_SET_CPUUSED, 6), AOM_CODEC_OK);
+  ASSERT_EQ(aom_codec_control(&enc, AV1E_GET_FRAME_STAGE_TIMINGS, nullptr),
+            AOM_CODEC_INVALID_PARAM);
+
+  aom_image_t *const image =
+      aom_img_alloc(nullptr, AOM_IMG_FMT_I420, cfg.g_w, cfg.g_h, 1);
+  ASSERT_NE(image, nullptr);
+  const int kNumFrames = 8;
+  int num_coded_calls = 0;
+  for (int i = 0; i <= kNumFrames; ++i) {
+    aom_image_t *const img = i < kNumFrames ? image : nullptr;
+    if (img != nullptr) {
+      for (unsigned int r = 0; r < cfg.g_h; ++r) {
+        memset(img->planes[0] + r * img->stride[0], (r * 3 + i * 16) & 0xff,
+               cfg.g_w);
+      }
+      memset(img->planes[1], 128, img->stride[1] * (cfg.g_h / 2));
+      memset(img->planes[2], 128, img->stride[2] * (cfg.g_h / 2));
+    }
+    ASSERT_EQ(aom_codec_encode(&enc, img, i, 1, 0), AOM_CODEC_OK);
+    bool got_data = false;
+    aom_codec_iter_t iter = nullptr;
+    const aom_codec_cx_pkt_t *pkt;
+    while ((pkt = aom_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      if (pkt->kind == AOM_CODEC_CX_FRAME_PKT) got_data = true;
+    }
+
+    aom_enc_stage_timings_t timings;
+    memset(&timings, 0xff, sizeof(timings));
+    ASSERT_EQ(aom_codec_control(&enc, AV1E_GET_FRAME_STAGE_TIMINGS, &timings),
+              AOM_CODEC_OK);
+    const int64_t stages[] = { timings.temporal_filter,
+                               timings.tpl,
+                               timings.encode_frame,
+                               timings.loop_filter_pick,
+                               timings.loop_filter_apply,
+                               timings.cdef_pick,
+                               timings.cdef_apply,
+                               timings.loop_restoration_pick,
+                               timings.loop_restoration_apply,
+                               timings.pack_bitstream };
+    for (const int64_t stage_time : stages) {
+      if (got_data) {
+        EXPECT_GE(stage_time, 0);
+      } else {
+        // Nothing was coded while the lookahead was filling up.
+        EXPECT_EQ(stage_time, 0);
+      }
+    }
+    if (got_data) {
+      EXPECT_GT(timings.encode_frame, 0);
+      ++num_coded_calls;
+    }
+    // Keep flushing until the lookahead is empty.
+    if (img == nullptr && got_data) --i;
+  }
+  EXPECT_GT(num_coded_calls, 0);
+
+  aom_img_free(image);
+  ASSERT_EQ(aom_codec_destroy(&enc), AOM_CODEC_OK);
+}
+
 // Reproduces https://crbug.com/339877165.
 TEST(EncodeAPI, Buganizer339877165) {
   // Initialize libaom encoder.
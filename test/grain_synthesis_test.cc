@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <cstring>
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_image.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_util/aom_thread.h"
+#include "av1/decoder/grain_synthesis.h"
+#include "av1/encoder/grain_test_vectors.h"
+#include "gtest/gtest.h"
+#include "test/acm_random.h"
+#include "test/util.h"
+
+namespace {
+
+typedef void (*AddFilmGrainRowFunc)(uint8_t *pix, const uint8_t *luma,
+                                    const int *grain, int width,
+                                    int luma_subsamp_x, const int *scaling_lut,
+                                    int mult, int luma_mult, int offset,
+                                    int scaling_shift, int min_val,
+                                    int max_val);
+
+const int kMaxWidth = 70;
+
+class AddFilmGrainRowTest
+    : public ::testing::TestWithParam<AddFilmGrainRowFunc> {
+ protected:
+  void SetUp() override {
+    rnd_.Reset(libaom_test::ACMRandom::DeterministicSeed());
+  }
+
+  void RandomizeParams() {
+    for (int i = 0; i < kMaxWidth; ++i) {
+      pix_ref_[i] = rnd_.Rand8();
+      // 8-bit grain samples are bounded to [-128, 127].
+      grain_[i] = static_cast<int>(rnd_.Rand8()) - 128;
+    }
+    for (int i = 0; i < 2 * kMaxWidth; ++i) luma_[i] = rnd_.Rand8();
+    for (int i = 0; i < 256; ++i) scaling_lut_[i] = rnd_.Rand8();
+    if (rnd_(4) == 0) {
+      // Luma plane or chroma_scaling_from_luma.
+      mult_ = 0;
+      luma_mult_ = 64;
+      offset_ = 0;
+    } else {
+      mult_ = static_cast<int>(rnd_.Rand8()) - 128;
+      luma_mult_ = static_cast<int>(rnd_.Rand8()) - 128;
+      offset_ = static_cast<int>(rnd_(512)) - 256;
+    }
+    scaling_shift_ = 8 + rnd_(4);
+    if (rnd_(2)) {
+      min_val_ = 16;
+      max_val_ = 235;
+    } else {
+      min_val_ = 0;
+      max_val_ = 255;
+    }
+    memcpy(pix_test_, pix_ref_, sizeof(pix_ref_));
+  }
+
+  void Run(AddFilmGrainRowFunc func, uint8_t *pix, int width,
+           int luma_subsamp_x) {
+    func(pix, luma_, grain_, width, luma_subsamp_x, scaling_lut_, mult_,
+         luma_mult_, offset_, scaling_shift_, min_val_, max_val_);
+  }
+
+  libaom_test::ACMRandom rnd_;
+  uint8_t pix_ref_[kMaxWidth];
+  uint8_t pix_test_[kMaxWidth];
+  uint8_t luma_[2 * kMaxWidth];
+  int grain_[kMaxWidth];
+  int scaling_lut_[256];
+  int mult_, luma_mult_, offset_;
+  int scaling_shift_, min_val_, max_val_;
+};
+GTEST_ALLOW_UNINSTANTIATED_PARAMETERIZED_TEST(AddFilmGrainRowTest);
+
+TEST_P(AddFilmGrainRowTest, MatchesC) {
+  const AddFilmGrainRowFunc test_func = GetParam();
+  for (int iter = 0; iter < 2000; ++iter) {
+    const int width = 1 + rnd_(kMaxWidth);
+    const int luma_subsamp_x = rnd_(2);
+    RandomizeParams();
+    Run(av1_add_film_grain_row_c, pix_ref_, width, luma_subsamp_x);
+    Run(test_func, pix_test_, width, luma_subsamp_x);
+    ASSERT_EQ(0, memcmp(pix_ref_, pix_test_, sizeof(pix_ref_)))
+        << "width " << width << " luma_subsamp_x " << luma_subsamp_x;
+  }
+}
+
+TEST_P(AddFilmGrainRowTest, DISABLED_Speed) {
+  const AddFilmGrainRowFunc test_func = GetParam();
+  const int kIters = 10000000;
+  RandomizeParams();
+  const AddFilmGrainRowFunc funcs[2] = { av1_add_film_grain_row_c, test_func };
+  double elapsed[2];
+  for (int f = 0; f < 2; ++f) {
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    for (int i = 0; i < kIters; ++i) {
+      Run(funcs[f], pix_test_, 32, 1);
+    }
+    aom_usec_timer_mark(&timer);
+    elapsed[f] = static_cast<double>(aom_usec_timer_elapsed(&timer));
+  }
+  printf("av1_add_film_grain_row: c %.0f us, simd %.0f us (%.2fx)\n",
+         elapsed[0], elapsed[1], elapsed[0] / elapsed[1]);
+}
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_SUITE_P(SSE4_1, AddFilmGrainRowTest,
+                         ::testing::Values(av1_add_film_grain_row_sse4_1));
+#endif
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_SUITE_P(AVX2, AddFilmGrainRowTest,
+                         ::testing::Values(av1_add_film_grain_row_avx2));
+#endif
+
+#if !CONFIG_REALTIME_ONLY
+// Splitting the image into stripes must not change the output.
+class AddFilmGrainMtTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    rnd_.Reset(libaom_test::ACMRandom::DeterministicSeed());
+    num_workers_ = GetParam();
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    workers_ = new AVxWorker[num_workers_];
+    for (int i = 0; i < num_workers_; ++i) {
+      winterface->init(&workers_[i]);
+      if (i > 0) {
+        ASSERT_NE(winterface->reset(&workers_[i]), 0);
+      }
+    }
+  }
+
+  void TearDown() override {
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < num_workers_; ++i) winterface->end(&workers_[i]);
+    delete[] workers_;
+  }
+
+  libaom_test::ACMRandom rnd_;
+  AVxWorker *workers_;
+  int num_workers_;
+};
+
+TEST_P(AddFilmGrainMtTest, MatchesSingleThreaded) {
+  // Odd dimensions exercise the partial stripe and block at the edges.
+  const unsigned int kWidth = 203;
+  const unsigned int kHeight = 171;
+  aom_image_t src, ref, test;
+  ASSERT_NE(aom_img_alloc(&src, AOM_IMG_FMT_I420, kWidth, kHeight, 32),
+            nullptr);
+  ASSERT_NE(aom_img_alloc(&ref, AOM_IMG_FMT_I420, kWidth + 1, kHeight + 1, 32),
+            nullptr);
+  ASSERT_NE(
+      aom_img_alloc(&test, AOM_IMG_FMT_I420, kWidth + 1, kHeight + 1, 32),
+      nullptr);
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = aom_img_plane_width(&src, plane);
+    const int h = aom_img_plane_height(&src, plane);
+    for (int r = 0; r < h; ++r) {
+      for (int c = 0; c < w; ++c) {
+        src.planes[plane][r * src.stride[plane] + c] = rnd_.Rand8();
+      }
+    }
+  }
+
+  for (const aom_film_grain_t &vector : film_grain_test_vectors) {
+    aom_film_grain_t params = vector;
+    params.random_seed = rnd_.Rand16();
+    ASSERT_EQ(av1_add_film_grain(&params, &src, &ref), 0);
+    ASSERT_EQ(av1_add_film_grain_mt(&params, &src, &test, workers_,
+                                    num_workers_),
+              0);
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = aom_img_plane_width(&src, plane);
+      const int h = aom_img_plane_height(&src, plane);
+      for (int r = 0; r < h; ++r) {
+        ASSERT_EQ(memcmp(ref.planes[plane] + r * ref.stride[plane],
+                         test.planes[plane] + r * test.stride[plane], w),
+                  0)
+            << "plane " << plane << " row " << r;
+      }
+    }
+  }
+
+  aom_img_free(&src);
+  aom_img_free(&ref);
+  aom_img_free(&test);
+}
+
+INSTANTIATE_TEST_SUITE_P(AV1, AddFilmGrainMtTest,
+                         ::testing::Values(1, 2, 3, 8));
+#endif  // !CONFIG_REALTIME_ONLY
+
+}  // namespace
@@ -108,6 +108,19 @@ lightfield_test() {
   if [ $? -eq 1 ]; then
     return 1
   fi
+
+  # Decode the tile lists again on 4 threads with the tile cache, which must
+  # not change the output.
+  local tl_mt_outfile="${AOM_TEST_OUTPUT_DIR}/vase_tile_list_mt.yuv"
+  eval "${AOM_TEST_PREFIX}" "${tl_decoder}" "${tl_file}" "${tl_mt_outfile}" \
+      "${num_references}" "${num_tile_lists}" 0 4 16384 ${devnull} || return 1
+
+  [ -e "${tl_mt_outfile}" ] || return 1
+
+  diff ${tl_mt_outfile} ${tl_reffile} > /dev/null
+  if [ $? -eq 1 ]; then
+    return 1
+  fi
 }
 
 lightfield_test_tests="lightfield_test"
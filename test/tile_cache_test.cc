@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <cstring>
+
+#include "config/aom_config.h"
+
+#include "aom_ports/mem.h"
+#include "aom_scale/yv12config.h"
+#include "av1/decoder/tile_cache.h"
+#include "gtest/gtest.h"
+#include "test/acm_random.h"
+
+namespace {
+
+const int kTileSize = 64;
+const int kTilesPerRow = 4;
+const int kNumPlanes = 3;
+
+class TileCacheTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    memset(&cache_, 0, sizeof(cache_));
+    memset(&buf_, 0, sizeof(buf_));
+    ASSERT_EQ(aom_alloc_frame_buffer(&buf_, kTileSize * kTilesPerRow,
+                                     kTileSize, 1, 1, GetParam(), 0, 0, false,
+                                     0),
+              0);
+    libaom_test::ACMRandom rnd(libaom_test::ACMRandom::DeterministicSeed());
+    for (int plane = 0; plane < kNumPlanes; ++plane) {
+      const int w = plane ? buf_.uv_crop_width : buf_.y_crop_width;
+      const int h = plane ? buf_.uv_crop_height : buf_.y_crop_height;
+      for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) SetPixel(plane, x, y, rnd.Rand8());
+      }
+    }
+    for (int i = 0; i < kNumCoded; ++i) {
+      for (int j = 0; j < kCodedSize; ++j) coded_[i][j] = rnd.Rand8();
+    }
+    av1_tile_cache_set_layout(&cache_, &buf_, kTileSize, kTileSize,
+                              kNumPlanes);
+  }
+
+  void TearDown() override {
+    av1_tile_cache_free(&cache_);
+    aom_free_frame_buffer(&buf_);
+  }
+
+  int GetPixel(int plane, int x, int y) const {
+    const int stride = buf_.strides[plane > 0];
+    if (buf_.flags & YV12_FLAG_HIGHBITDEPTH)
+      return CONVERT_TO_SHORTPTR(buf_.buffers[plane])[y * stride + x];
+    return buf_.buffers[plane][y * stride + x];
+  }
+
+  void SetPixel(int plane, int x, int y, int value) {
+    const int stride = buf_.strides[plane > 0];
+    if (buf_.flags & YV12_FLAG_HIGHBITDEPTH)
+      CONVERT_TO_SHORTPTR(buf_.buffers[plane])[y * stride + x] = value;
+    else
+      buf_.buffers[plane][y * stride + x] = value;
+  }
+
+  // Returns true if tile slots 'a' and 'b' of the buffer hold the same pixels.
+  bool SameTile(int a, int b) const {
+    for (int plane = 0; plane < kNumPlanes; ++plane) {
+      const int size = plane ? kTileSize / 2 : kTileSize;
+      for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+          if (GetPixel(plane, a * size + x, y) !=
+              GetPixel(plane, b * size + x, y))
+            return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void Insert(int ref_idx, int coded, int slot) {
+    av1_tile_cache_insert(&cache_, ref_idx, 0, 0, coded_[coded], kCodedSize,
+                          kCodedSize, &buf_, slot * kTileSize, 0);
+  }
+
+  const TileCacheEntry *Lookup(int ref_idx, int coded) {
+    return av1_tile_cache_lookup(&cache_, ref_idx, 0, 0, coded_[coded],
+                                 kCodedSize);
+  }
+
+  size_t TileBytes() const {
+    return ((kTileSize * kTileSize * 3 / 2) << (GetParam() ? 1 : 0)) +
+           kCodedSize;
+  }
+
+  static const int kNumCoded = 3;
+  static const int kCodedSize = 100;
+
+  TileCache cache_;
+  YV12_BUFFER_CONFIG buf_;
+  uint8_t coded_[kNumCoded][kCodedSize];
+};
+
+TEST_P(TileCacheTest, ReadsBackInsertedTile) {
+  av1_tile_cache_set_budget(&cache_, 4 * TileBytes());
+  Insert(0, 0, 0);
+  EXPECT_EQ(cache_.bytes, TileBytes());
+
+  const TileCacheEntry *const entry = Lookup(0, 0);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->payload_size, static_cast<uint32_t>(kCodedSize));
+  ASSERT_FALSE(SameTile(0, 1));
+  av1_tile_cache_read(&cache_, entry, &buf_, kTileSize, 0);
+  EXPECT_TRUE(SameTile(0, 1));
+
+  // The anchor frame and the coded data are part of the key.
+  EXPECT_EQ(Lookup(1, 0), nullptr);
+  EXPECT_EQ(Lookup(0, 1), nullptr);
+  EXPECT_EQ(av1_tile_cache_lookup(&cache_, 0, 1, 0, coded_[0], kCodedSize),
+            nullptr);
+  EXPECT_EQ(av1_tile_cache_lookup(&cache_, 0, 0, 0, coded_[0], kCodedSize - 1),
+            nullptr);
+}
+
+TEST_P(TileCacheTest, EvictsLeastRecentlyUsed) {
+  av1_tile_cache_set_budget(&cache_, 2 * TileBytes());
+  Insert(0, 0, 0);
+  Insert(0, 1, 1);
+  ASSERT_NE(Lookup(0, 0), nullptr);
+  Insert(0, 2, 2);
+  EXPECT_EQ(cache_.num_entries, 2);
+  EXPECT_EQ(cache_.bytes, 2 * TileBytes());
+  EXPECT_NE(Lookup(0, 0), nullptr);
+  EXPECT_EQ(Lookup(0, 1), nullptr);
+  EXPECT_NE(Lookup(0, 2), nullptr);
+
+  // Shrinking the budget drops the tile used last the longest time ago.
+  av1_tile_cache_set_budget(&cache_, TileBytes());
+  EXPECT_EQ(cache_.num_entries, 1);
+  EXPECT_EQ(Lookup(0, 0), nullptr);
+  EXPECT_NE(Lookup(0, 2), nullptr);
+
+  av1_tile_cache_set_budget(&cache_, 0);
+  EXPECT_EQ(cache_.num_entries, 0);
+  EXPECT_EQ(cache_.bytes, 0u);
+}
+
+TEST_P(TileCacheTest, DoesNotCacheTilesLargerThanBudget) {
+  av1_tile_cache_set_budget(&cache_, TileBytes() - 1);
+  Insert(0, 0, 0);
+  EXPECT_EQ(cache_.num_entries, 0);
+  EXPECT_EQ(Lookup(0, 0), nullptr);
+}
+
+TEST_P(TileCacheTest, LayoutChangeEmptiesCache) {
+  av1_tile_cache_set_budget(&cache_, 4 * TileBytes());
+  Insert(0, 0, 0);
+  av1_tile_cache_set_layout(&cache_, &buf_, kTileSize, kTileSize, kNumPlanes);
+  EXPECT_NE(Lookup(0, 0), nullptr);
+  av1_tile_cache_set_layout(&cache_, &buf_, kTileSize / 2, kTileSize / 2,
+                            kNumPlanes);
+  EXPECT_EQ(Lookup(0, 0), nullptr);
+  EXPECT_EQ(cache_.bytes, 0u);
+}
+
+#if CONFIG_AV1_HIGHBITDEPTH
+INSTANTIATE_TEST_SUITE_P(AV1, TileCacheTest, ::testing::Values(0, 1));
+#else
+INSTANTIATE_TEST_SUITE_P(AV1, TileCacheTest, ::testing::Values(0));
+#endif
+
+}  // namespace
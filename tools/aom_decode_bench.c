@@ -0,0 +1,507 @@
+/*
+ * Copyright (c) 2024, Alliance for Open Media. All rights reserved.
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Decoder throughput benchmark
+// ============================
+//
+// Encodes synthetic streams with the encoder of this tree, then times their
+// decoding with 1 to --threads threads, with row-based multi-threading off and
+// on. No test data is needed. Each stream exercises a set of coding tools:
+// one or many tiles, film grain, superres and screen content with intra block
+// copy. The results, including the time of each decoder stage reported by
+// AV1D_GET_FRAME_STAGE_TIMINGS, are written as JSON. The decoded frames of
+// every configuration must match the single-threaded ones; the tool exits with
+// an error otherwise.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aom/aom_decoder.h"
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom_ports/aom_timer.h"
+#include "common/args.h"
+#include "common/md5_utils.h"
+#include "common/tools_common.h"
+
+typedef struct {
+  const char *name;
+  int width;
+  int height;
+  // log2 of the number of tile columns and rows.
+  int tile_columns;
+  int tile_rows;
+  // Film grain test vector, 0 for none.
+  int film_grain;
+  // Superres denominator, 0 for none.
+  int superres_denominator;
+  int screen_content;
+} StreamConfig;
+
+static const StreamConfig kStreams[] = {
+  { "one_tile_360p", 640, 360, 0, 0, 0, 0, 0 },
+  { "one_tile_1080p", 1920, 1080, 0, 0, 0, 0, 0 },
+  { "many_tiles_1080p", 1920, 1080, 2, 2, 0, 0, 0 },
+  { "film_grain_720p", 1280, 720, 0, 0, 1, 0, 0 },
+  { "superres_720p", 1280, 720, 0, 0, 0, 16, 0 },
+  { "screen_content_720p", 1280, 720, 0, 0, 0, 0, 1 },
+};
+#define NUM_STREAMS (int)(sizeof(kStreams) / sizeof(kStreams[0]))
+
+// Largest number of frames output by one aom_codec_decode() call.
+#define MAX_FRAMES_PER_DECODE 8
+
+typedef struct {
+  uint8_t *buf;
+  size_t size;
+} Packet;
+
+typedef struct {
+  Packet *packets;
+  int num_packets;
+  size_t bytes;
+} EncodedStream;
+
+static const char *exec_name;
+
+static const arg_def_t help_arg =
+    ARG_DEF(NULL, "help", 0, "Show usage options and exit");
+static const arg_def_t threads_arg =
+    ARG_DEF("t", "threads", 1, "Largest number of decoder threads (default 4)");
+static const arg_def_t frames_arg =
+    ARG_DEF(NULL, "frames", 1, "Frames to encode per stream (default 10)");
+static const arg_def_t runs_arg = ARG_DEF(
+    NULL, "runs", 1, "Timed runs per configuration, the fastest is kept "
+                     "(default 3)");
+static const arg_def_t cpu_used_arg =
+    ARG_DEF(NULL, "cpu-used", 1, "Encoder speed setting (default 6)");
+static const arg_def_t streams_arg = ARG_DEF(
+    NULL, "streams", 1, "Comma separated names of the streams (default all)");
+static const arg_def_t output_arg =
+    ARG_DEF("o", "output", 1, "JSON output file (default stdout)");
+
+static const arg_def_t *all_args[] = { &help_arg,     &threads_arg,
+                                       &frames_arg,   &runs_arg,
+                                       &cpu_used_arg, &streams_arg,
+                                       &output_arg,   NULL };
+
+static void show_help(FILE *fout) {
+  fprintf(fout, "Usage: %s <options>\n\nOptions:\n", exec_name);
+  arg_show_usage(fout, all_args);
+  fprintf(fout, "\nStreams:\n");
+  for (int i = 0; i < NUM_STREAMS; ++i) {
+    fprintf(fout, "  %s\n", kStreams[i].name);
+  }
+}
+
+void usage_exit(void) {
+  show_help(stderr);
+  exit(EXIT_FAILURE);
+}
+
+// Returns 1 if 'name' is in the comma separated 'list'.
+static int name_in_list(const char *name, const char *list) {
+  const size_t len = strlen(name);
+  while (*list != '\0') {
+    const char *const end = strchr(list, ',');
+    const size_t item_len = end ? (size_t)(end - list) : strlen(list);
+    if (item_len == len && !strncmp(name, list, len)) return 1;
+    if (end == NULL) break;
+    list = end + 1;
+  }
+  return 0;
+}
+
+static uint32_t hash2d(int x, int y, uint32_t seed) {
+  uint32_t h = (uint32_t)x * 374761393u + (uint32_t)y * 668265263u +
+               seed * 2246822519u;
+  h = (h ^ (h >> 13)) * 1274126177u;
+  return h ^ (h >> 16);
+}
+
+// Returns smooth noise in [0, 255]: the bilinear interpolation of random
+// values on a grid with cells of 1 << 'log2_cell' pixels.
+static int smooth_noise(int x, int y, int log2_cell, uint32_t seed) {
+  const int cell = 1 << log2_cell;
+  const int cx = x >> log2_cell;
+  const int cy = y >> log2_cell;
+  const int fx = x & (cell - 1);
+  const int fy = y & (cell - 1);
+  const int v00 = hash2d(cx, cy, seed) & 255;
+  const int v01 = hash2d(cx + 1, cy, seed) & 255;
+  const int v10 = hash2d(cx, cy + 1, seed) & 255;
+  const int v11 = hash2d(cx + 1, cy + 1, seed) & 255;
+  const int top = v00 * (cell - fx) + v01 * fx;
+  const int bottom = v10 * (cell - fx) + v11 * fx;
+  return (top * (cell - fy) + bottom * fy) >> (2 * log2_cell);
+}
+
+static uint8_t clip_pixel(int v) {
+  return (uint8_t)(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+// Camera-like content: textured smooth noise that pans across the frame.
+static void fill_natural_frame(aom_image_t *img, int frame) {
+  for (int plane = 0; plane < 3; ++plane) {
+    const int ss = plane > 0;
+    const int w = (img->d_w + ss) >> ss;
+    const int h = (img->d_h + ss) >> ss;
+    const int dx = (3 * frame) >> ss;
+    const int dy = frame >> ss;
+    for (int y = 0; y < h; ++y) {
+      uint8_t *const row = img->planes[plane] + y * img->stride[plane];
+      for (int x = 0; x < w; ++x) {
+        const int sx = x + dx;
+        const int sy = y + dy;
+        if (plane == 0) {
+          const int detail = (int)(hash2d(sx, sy, 1) & 15) - 8;
+          row[x] = clip_pixel(smooth_noise(sx, sy, 5, 2) * 3 / 4 +
+                              smooth_noise(sx, sy, 3, 3) / 4 + detail);
+        } else {
+          row[x] = clip_pixel(64 + smooth_noise(sx, sy, 6, 4 + plane) / 2);
+        }
+      }
+    }
+  }
+}
+
+// Screen content: lines of text drawn from a small set of glyphs, which
+// scroll up, next to a flat colored window.
+static void fill_screen_frame(aom_image_t *img, int frame) {
+  const int window_x = (int)img->d_w * 2 / 3;
+  for (int plane = 0; plane < 3; ++plane) {
+    const int ss = plane > 0;
+    const int w = (img->d_w + ss) >> ss;
+    const int h = (img->d_h + ss) >> ss;
+    for (int y = 0; y < h; ++y) {
+      uint8_t *const row = img->planes[plane] + y * img->stride[plane];
+      for (int x = 0; x < w; ++x) {
+        const int lx = x << ss;
+        const int ly = (y << ss) + 4 * frame;
+        if (lx >= window_x) {
+          row[x] = plane == 0 ? 90 : (plane == 1 ? 160 : 80);
+          continue;
+        }
+        if (plane > 0) {
+          row[x] = 128;
+          continue;
+        }
+        // 8x16 glyph cells; each line of text repeats the glyphs of a few
+        // words.
+        const int col = lx >> 3;
+        const int line = ly >> 4;
+        const int glyph = hash2d(col % 12, line % 5, 7) % 40;
+        const int gx = lx & 7;
+        const int gy = ly & 15;
+        const int ink = gx >= 1 && gx <= 6 && gy >= 3 && gy <= 12 &&
+                        ((hash2d(glyph, gy, 8) >> gx) & 1);
+        row[x] = ink ? 16 : 235;
+      }
+    }
+  }
+}
+
+static void add_packet(EncodedStream *stream, const aom_codec_cx_pkt_t *pkt) {
+  Packet *const packets = (Packet *)realloc(
+      stream->packets, (stream->num_packets + 1) * sizeof(*packets));
+  if (packets == NULL) die("Failed to allocate the packet list.");
+  stream->packets = packets;
+  Packet *const packet = &stream->packets[stream->num_packets++];
+  packet->size = pkt->data.frame.sz;
+  packet->buf = (uint8_t *)malloc(packet->size);
+  if (packet->buf == NULL) die("Failed to allocate a packet.");
+  memcpy(packet->buf, pkt->data.frame.buf, packet->size);
+  stream->bytes += packet->size;
+}
+
+static void encode_stream(const StreamConfig *config, int num_frames,
+                          int cpu_used, int threads, EncodedStream *stream) {
+  aom_codec_iface_t *const iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t codec;
+  if (aom_codec_enc_config_default(iface, &cfg, AOM_USAGE_GOOD_QUALITY))
+    die("Failed to get the default encoder configuration.");
+  cfg.g_w = config->width;
+  cfg.g_h = config->height;
+  cfg.g_timebase.num = 1;
+  cfg.g_timebase.den = 30;
+  cfg.g_threads = threads;
+  // About 1/30 bit per pixel, a quantizer coarse enough for the encoder to
+  // enable the deblocking filter.
+  cfg.rc_target_bitrate = config->width * config->height / 1000;
+  if (config->superres_denominator) {
+    cfg.rc_superres_mode = AOM_SUPERRES_FIXED;
+    cfg.rc_superres_denominator = config->superres_denominator;
+    cfg.rc_superres_kf_denominator = config->superres_denominator;
+  }
+  // Intra block copy is only used in intra frames.
+  if (config->screen_content) cfg.kf_max_dist = 4;
+  if (aom_codec_enc_init(&codec, iface, &cfg, 0))
+    die("Failed to initialize the encoder.");
+  if (aom_codec_control(&codec, AOME_SET_CPUUSED, cpu_used) ||
+      aom_codec_control(&codec, AV1E_SET_TILE_COLUMNS, config->tile_columns) ||
+      aom_codec_control(&codec, AV1E_SET_TILE_ROWS, config->tile_rows) ||
+      aom_codec_control(&codec, AV1E_SET_FILM_GRAIN_TEST_VECTOR,
+                        config->film_grain))
+    die_codec(&codec, "Failed to set the encoder controls");
+  if (config->screen_content &&
+      (aom_codec_control(&codec, AV1E_SET_TUNE_CONTENT, AOM_CONTENT_SCREEN) ||
+       aom_codec_control(&codec, AV1E_SET_ENABLE_INTRABC, 1)))
+    die_codec(&codec, "Failed to set the screen content controls");
+
+  aom_image_t raw;
+  if (!aom_img_alloc(&raw, AOM_IMG_FMT_I420, config->width, config->height,
+                     16))
+    die("Failed to allocate the source frame.");
+  memset(stream, 0, sizeof(*stream));
+  for (int frame = 0; frame <= num_frames; ++frame) {
+    aom_image_t *img = NULL;
+    if (frame < num_frames) {
+      img = &raw;
+      if (config->screen_content)
+        fill_screen_frame(img, frame);
+      else
+        fill_natural_frame(img, frame);
+    }
+    // Flush the encoder after the last frame.
+    int got_pkts;
+    do {
+      if (aom_codec_encode(&codec, img, frame, 1, 0))
+        die_codec(&codec, "Failed to encode a frame");
+      got_pkts = 0;
+      aom_codec_iter_t iter = NULL;
+      const aom_codec_cx_pkt_t *pkt;
+      while ((pkt = aom_codec_get_cx_data(&codec, &iter)) != NULL) {
+        if (pkt->kind != AOM_CODEC_CX_FRAME_PKT) continue;
+        got_pkts = 1;
+        add_packet(stream, pkt);
+      }
+    } while (img == NULL && got_pkts);
+  }
+  aom_img_free(&raw);
+  if (aom_codec_destroy(&codec)) die_codec(&codec, "Failed to destroy codec");
+}
+
+static void free_stream(EncodedStream *stream) {
+  for (int i = 0; i < stream->num_packets; ++i) free(stream->packets[i].buf);
+  free(stream->packets);
+  memset(stream, 0, sizeof(*stream));
+}
+
+static void update_image_md5(MD5Context *md5, const aom_image_t *img) {
+  const int bytes_per_sample = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  const int num_planes = img->monochrome ? 1 : 3;
+  for (int plane = 0; plane < num_planes; ++plane) {
+    const int w = aom_img_plane_width(img, plane) * bytes_per_sample;
+    const int h = aom_img_plane_height(img, plane);
+    for (int y = 0; y < h; ++y) {
+      MD5Update(md5, img->planes[plane] + y * img->stride[plane], w);
+    }
+  }
+}
+
+static void add_stage_timings(aom_dec_stage_timings_t *sum,
+                              const aom_dec_stage_timings_t *t) {
+  sum->frame_header += t->frame_header;
+  sum->decode_tiles += t->decode_tiles;
+  sum->loop_filter += t->loop_filter;
+  sum->cdef += t->cdef;
+  sum->superres += t->superres;
+  sum->loop_restoration += t->loop_restoration;
+  sum->film_grain += t->film_grain;
+}
+
+typedef struct {
+  int64_t usec;
+  int num_frames;
+  aom_dec_stage_timings_t stages;
+  unsigned char md5[16];
+} DecodeResult;
+
+// Decodes 'stream' once. The time covers aom_codec_decode() and
+// aom_codec_get_frame(), which adds the film grain, but not the MD5 of the
+// frames.
+static void decode_stream(const EncodedStream *stream, int threads, int row_mt,
+                          DecodeResult *result) {
+  aom_codec_dec_cfg_t cfg = { (unsigned int)threads, 0, 0, 1 };
+  aom_codec_ctx_t codec;
+  MD5Context md5;
+  if (aom_codec_dec_init(&codec, aom_codec_av1_dx(), &cfg, 0))
+    die("Failed to initialize the decoder.");
+  if (aom_codec_control(&codec, AV1D_SET_ROW_MT, row_mt))
+    die_codec(&codec, "Failed to set row_mt");
+  memset(result, 0, sizeof(*result));
+  MD5Init(&md5);
+  for (int i = 0; i < stream->num_packets; ++i) {
+    const aom_image_t *imgs[MAX_FRAMES_PER_DECODE];
+    int num_imgs = 0;
+    struct aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    if (aom_codec_decode(&codec, stream->packets[i].buf,
+                         stream->packets[i].size, NULL))
+      die_codec(&codec, "Failed to decode a frame");
+    aom_codec_iter_t iter = NULL;
+    const aom_image_t *img;
+    while ((img = aom_codec_get_frame(&codec, &iter)) != NULL) {
+      if (num_imgs == MAX_FRAMES_PER_DECODE) die("Too many output frames.");
+      imgs[num_imgs++] = img;
+    }
+    aom_usec_timer_mark(&timer);
+    result->usec += aom_usec_timer_elapsed(&timer);
+
+    aom_dec_stage_timings_t timings;
+    if (aom_codec_control(&codec, AV1D_GET_FRAME_STAGE_TIMINGS, &timings))
+      die_codec(&codec, "Failed to get the stage timings");
+    add_stage_timings(&result->stages, &timings);
+    for (int j = 0; j < num_imgs; ++j) update_image_md5(&md5, imgs[j]);
+    result->num_frames += num_imgs;
+  }
+  MD5Final(result->md5, &md5);
+  if (aom_codec_destroy(&codec)) die_codec(&codec, "Failed to destroy codec");
+}
+
+static void print_result_json(FILE *out, int threads, int row_mt,
+                              const DecodeResult *result, int last) {
+  const aom_dec_stage_timings_t *const s = &result->stages;
+  const double fps =
+      result->usec > 0 ? result->num_frames * 1e6 / result->usec : 0;
+  fprintf(out,
+          "        { \"threads\": %d, \"row_mt\": %d, \"usec\": %" PRId64
+          ", \"fps\": %.2f, \"md5\": \"",
+          threads, row_mt, result->usec, fps);
+  for (int i = 0; i < 16; ++i) fprintf(out, "%02x", result->md5[i]);
+  fprintf(out,
+          "\",\n          \"stages\": { \"frame_header\": %" PRId64
+          ", \"decode_tiles\": %" PRId64 ", \"loop_filter\": %" PRId64
+          ", \"cdef\": %" PRId64 ", \"superres\": %" PRId64
+          ", \"loop_restoration\": %" PRId64 ", \"film_grain\": %" PRId64
+          " } }%s\n",
+          s->frame_header, s->decode_tiles, s->loop_filter, s->cdef,
+          s->superres, s->loop_restoration, s->film_grain, last ? "" : ",");
+}
+
+int main(int argc, const char **argv_) {
+  int max_threads = 4;
+  int num_frames = 10;
+  int num_runs = 3;
+  int cpu_used = 6;
+  const char *stream_list = NULL;
+  const char *output_name = NULL;
+  struct arg arg;
+  char **argv, **argi, **argj;
+
+  exec_name = argv_[0];
+  argv = argv_dup(argc - 1, argv_ + 1);
+  if (!argv) die("Error allocating argument list\n");
+  for (argi = argj = argv; (*argj = *argi); argi += arg.argv_step) {
+    memset(&arg, 0, sizeof(arg));
+    arg.argv_step = 1;
+    if (arg_match(&arg, &help_arg, argi)) {
+      show_help(stdout);
+      exit(EXIT_SUCCESS);
+    } else if (arg_match(&arg, &threads_arg, argi)) {
+      max_threads = arg_parse_int(&arg);
+    } else if (arg_match(&arg, &frames_arg, argi)) {
+      num_frames = arg_parse_int(&arg);
+    } else if (arg_match(&arg, &runs_arg, argi)) {
+      num_runs = arg_parse_int(&arg);
+    } else if (arg_match(&arg, &cpu_used_arg, argi)) {
+      cpu_used = arg_parse_int(&arg);
+    } else if (arg_match(&arg, &streams_arg, argi)) {
+      stream_list = arg.val;
+    } else if (arg_match(&arg, &output_arg, argi)) {
+      output_name = arg.val;
+    } else {
+      argj++;
+    }
+  }
+  for (argi = argv; *argi; ++argi) {
+    fprintf(stderr, "Unknown argument: %s\n", *argi);
+    usage_exit();
+  }
+  free(argv);
+  if (max_threads < 1 || num_frames < 1 || num_runs < 1) usage_exit();
+
+  FILE *out = stdout;
+  if (output_name != NULL) {
+    out = fopen(output_name, "w");
+    if (out == NULL) die("Failed to open %s for writing.", output_name);
+  }
+
+  // 1, 2, 4, ... threads up to max_threads, which is always included.
+  int thread_counts[32];
+  int num_thread_counts = 0;
+  for (int t = 1; t < max_threads && num_thread_counts < 31; t *= 2) {
+    thread_counts[num_thread_counts++] = t;
+  }
+  thread_counts[num_thread_counts++] = max_threads;
+
+  int num_selected = 0;
+  for (int i = 0; i < NUM_STREAMS; ++i) {
+    if (stream_list == NULL || name_in_list(kStreams[i].name, stream_list))
+      ++num_selected;
+  }
+  if (num_selected == 0) die("No stream matches --streams=%s.", stream_list);
+
+  int mismatch = 0;
+  fprintf(out, "{\n  \"version\": \"%s\",\n", aom_codec_version_str());
+  fprintf(out, "  \"frames\": %d,\n  \"runs\": %d,\n  \"streams\": [\n",
+          num_frames, num_runs);
+  for (int i = 0, num_done = 0; i < NUM_STREAMS; ++i) {
+    const StreamConfig *const config = &kStreams[i];
+    if (stream_list != NULL && !name_in_list(config->name, stream_list))
+      continue;
+    EncodedStream stream;
+    fprintf(stderr, "Encoding %s\n", config->name);
+    encode_stream(config, num_frames, cpu_used, max_threads, &stream);
+
+    fprintf(out,
+            "    {\n      \"name\": \"%s\",\n      \"width\": %d,\n"
+            "      \"height\": %d,\n      \"bytes\": %zu,\n"
+            "      \"results\": [\n",
+            config->name, config->width, config->height, stream.bytes);
+    unsigned char reference_md5[16];
+    for (int t = 0; t < num_thread_counts; ++t) {
+      const int threads = thread_counts[t];
+      // Row-based multi-threading makes no difference with one thread.
+      for (int row_mt = 0; row_mt <= (threads > 1); ++row_mt) {
+        fprintf(stderr, "Decoding %s with %d thread(s), row_mt %d\n",
+                config->name, threads, row_mt);
+        DecodeResult best;
+        for (int run = 0; run < num_runs; ++run) {
+          DecodeResult result;
+          decode_stream(&stream, threads, row_mt, &result);
+          if (run == 0 || result.usec < best.usec) best = result;
+        }
+        if (t == 0) {
+          memcpy(reference_md5, best.md5, sizeof(reference_md5));
+        } else if (memcmp(reference_md5, best.md5, sizeof(reference_md5))) {
+          fprintf(stderr,
+                  "%s: the frames decoded with %d threads and row_mt %d "
+                  "differ from the single-threaded ones.\n",
+                  config->name, threads, row_mt);
+          mismatch = 1;
+        }
+        const int last = t == num_thread_counts - 1 && row_mt == (threads > 1);
+        print_result_json(out, threads, row_mt, &best, last);
+      }
+    }
+    ++num_done;
+    fprintf(out, "      ]\n    }%s\n", num_done == num_selected ? "" : ",");
+    free_stream(&stream);
+  }
+  fprintf(out, "  ]\n}\n");
+  if (out != stdout) fclose(out);
+  return mismatch ? EXIT_FAILURE : EXIT_SUCCESS;
+}